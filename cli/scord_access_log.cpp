@@ -0,0 +1,170 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+#include <CLI/CLI.hpp>
+#include <net/access_log.hpp>
+#include <scord/types.hpp>
+
+namespace fs = std::filesystem;
+using network::access_log::file_header;
+using network::access_log::record;
+
+struct access_log_config {
+    std::string progname;
+    fs::path input;
+    std::optional<std::size_t> last;
+    bool errors_only = false;
+};
+
+access_log_config
+parse_command_line(int argc, char* argv[]) {
+
+    access_log_config cfg;
+
+    cfg.progname = fs::path{argv[0]}.filename().string();
+
+    CLI::App app{"Print the requests recorded in a scord access log",
+                 cfg.progname};
+
+    app.add_option("input", cfg.input, "The access log to print")
+            ->option_text("FILENAME")
+            ->required()
+            ->check(CLI::ExistingFile);
+    app.add_option("-n,--last", cfg.last,
+                   "Print only the last N requests recorded")
+            ->option_text("N")
+            ->check(CLI::PositiveNumber);
+    app.add_flag("-e,--errors", cfg.errors_only,
+                 "Print only the requests that failed");
+
+    try {
+        app.parse(argc, argv);
+        return cfg;
+    } catch(const CLI::ParseError& ex) {
+        std::exit(app.exit(ex));
+    }
+}
+
+// Return the complete records in the log, oldest first. Records that were
+// being written when the log was read (or when the process died) are
+// skipped.
+std::vector<record>
+read_records(const fs::path& path) {
+
+    std::ifstream ifs{path, std::ios::binary};
+
+    file_header header;
+
+    if(!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+       header.magic != file_header::expected_magic ||
+       header.record_size != sizeof(record) || header.capacity == 0) {
+        throw std::runtime_error(
+                fmt::format("{}: not a scord access log", path.string()));
+    }
+
+    std::vector<record> slots(header.capacity);
+
+    if(!ifs.read(reinterpret_cast<char*>(slots.data()),
+                 static_cast<std::streamsize>(slots.size() * sizeof(record)))) {
+        throw std::runtime_error(
+                fmt::format("{}: truncated access log", path.string()));
+    }
+
+    const auto first = header.head > header.capacity
+                               ? header.head - header.capacity
+                               : 0;
+
+    std::vector<record> records;
+    records.reserve(header.head - first);
+
+    for(auto i = first; i < header.head; ++i) {
+        auto& r = slots[i % header.capacity];
+
+        if(r.seq != i + 1) {
+            continue;
+        }
+
+        r.name[sizeof(r.name) - 1] = '\0';
+        r.peer[sizeof(r.peer) - 1] = '\0';
+        records.push_back(r);
+    }
+
+    return records;
+}
+
+std::string
+format_timestamp(std::uint64_t ns) {
+    const auto secs = static_cast<std::time_t>(ns / 1'000'000'000);
+    return fmt::format("{:%F %T}.{:06}Z", fmt::gmtime(secs),
+                       (ns % 1'000'000'000) / 1'000);
+}
+
+void
+print_record(const record& r) {
+    fmt::print("{} id: {} name: {:?} from: {:?} duration: {:.3f}ms "
+               "retval: {} trace_id: {:016x} span_id: {:016x}\n",
+               format_timestamp(r.start_ns), r.rpc_id, std::string{r.name},
+               std::string{r.peer}, static_cast<double>(r.duration_ns) / 1e6,
+               scord::error_code{r.retval}.name(), r.trace_id, r.span_id);
+}
+
+int
+main(int argc, char* argv[]) {
+
+    const auto cfg = parse_command_line(argc, argv);
+
+    try {
+        auto records = read_records(cfg.input);
+
+        if(cfg.errors_only) {
+            std::erase_if(records, [](const record& r) {
+                return scord::error_code{r.retval} == scord::error_code::success;
+            });
+        }
+
+        const auto skip = cfg.last && *cfg.last < records.size()
+                                  ? records.size() - *cfg.last
+                                  : 0;
+
+        std::for_each(records.begin() + static_cast<std::ptrdiff_t>(skip),
+                      records.end(), print_record);
+
+    } catch(const std::exception& ex) {
+        fmt::print(stderr, "{}: error: {}\n", cfg.progname, ex.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
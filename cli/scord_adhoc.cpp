@@ -251,12 +251,23 @@ main(int argc, char* argv[]) {
             const scord::transfer transfer = scord::transfer{cfg.slurm_id};
             scord::job job(cfg.job_id, cfg.slurm_id);
 
-            auto response = scord::query_transfer(srv, job, transfer);
+            while(true) {
+                const auto infos = scord::query_transfers(srv, job, {transfer});
 
-            while(response.status() != scord::transfer_state::type::finished) {
-                std::this_thread::sleep_for(1s);
-                response = scord::query_transfer(srv, job, transfer);
-                if(scord::transfer_state::type::failed == response.status()) {
+                // finished transfers are removed from the server
+                if(infos.empty() || infos.front().error_code() ==
+                                            scord::error_code::no_such_entity) {
+                    break;
+                }
+
+                const auto status =
+                        scord::wait_transfer(srv, job, transfer, 30s).status();
+
+                if(status == scord::transfer_state::type::finished) {
+                    break;
+                }
+
+                if(status == scord::transfer_state::type::failed) {
                     fmt::print("Transfer failed\n");
                     return EXIT_FAILURE;
                 }
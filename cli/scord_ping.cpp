@@ -23,13 +23,18 @@
  *****************************************************************************/
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <numeric>
+#include <vector>
 #include <CLI/CLI.hpp>
 #include <scord/scord.hpp>
 
 struct ping_config {
     std::string progname;
     std::string server_address;
+    std::uint32_t count = 1;
 };
 
 ping_config
@@ -44,6 +49,11 @@ parse_command_line(int argc, char* argv[]) {
     app.add_option("-s,--server", cfg.server_address, "Server address")
             ->option_text("ADDRESS")
             ->required();
+    app.add_option("-n,--count", cfg.count,
+                   "Number of pings to send. If greater than 1, per-call "
+                   "latency statistics are reported")
+            ->option_text("N")
+            ->check(CLI::PositiveNumber);
 
     try {
         app.parse(argc, argv);
@@ -74,8 +84,36 @@ main(int argc, char* argv[]) {
 
     try {
         const auto [protocol, address] = parse_address(cfg.server_address);
-        ping(scord::server{protocol, address});
+        const scord::server srv{protocol, address};
+
+        using clock = std::chrono::steady_clock;
+        using microseconds = std::chrono::duration<double, std::micro>;
+
+        std::vector<microseconds> latencies;
+        latencies.reserve(cfg.count);
+
+        for(std::uint32_t i = 0; i < cfg.count; ++i) {
+            const auto start = clock::now();
+            ping(srv);
+            latencies.emplace_back(clock::now() - start);
+        }
+
         fmt::print("Ping succeeded!\n");
+
+        if(cfg.count > 1) {
+            // the first call includes the cost of setting up the session
+            const auto first = latencies.front();
+            std::sort(latencies.begin(), latencies.end());
+            const auto total = std::accumulate(latencies.begin(),
+                                               latencies.end(), microseconds{});
+            fmt::print("{} pings (usecs): first: {:.1f}, min: {:.1f}, "
+                       "avg: {:.1f}, p50: {:.1f}, p99: {:.1f}, max: {:.1f}\n",
+                       cfg.count, first.count(), latencies.front().count(),
+                       (total / cfg.count).count(),
+                       latencies[latencies.size() / 2].count(),
+                       latencies[latencies.size() * 99 / 100].count(),
+                       latencies.back().count());
+        }
     } catch(const std::exception& ex) {
         fmt::print(stderr, "Ping failed: {}\n", ex.what());
         return EXIT_FAILURE;
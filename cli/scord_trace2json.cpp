@@ -0,0 +1,192 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#include <fmt/format.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <CLI/CLI.hpp>
+#include <net/tracing.hpp>
+
+namespace fs = std::filesystem;
+using network::tracing::record;
+
+struct trace2json_config {
+    std::string progname;
+    std::vector<fs::path> inputs;
+    std::optional<fs::path> output;
+};
+
+trace2json_config
+parse_command_line(int argc, char* argv[]) {
+
+    trace2json_config cfg;
+
+    cfg.progname = fs::path{argv[0]}.filename().string();
+
+    CLI::App app{"Convert scord trace files into the Chrome/Perfetto JSON "
+                 "trace format",
+                 cfg.progname};
+
+    app.add_option("inputs", cfg.inputs,
+                   "Trace files to convert. Spans from all files are merged "
+                   "into a single trace")
+            ->option_text("FILENAME...")
+            ->required()
+            ->check(CLI::ExistingFile);
+    app.add_option("-o,--output", cfg.output,
+                   "Write the JSON trace to FILENAME rather than to stdout")
+            ->option_text("FILENAME");
+
+    try {
+        app.parse(argc, argv);
+        return cfg;
+    } catch(const CLI::ParseError& ex) {
+        std::exit(app.exit(ex));
+    }
+}
+
+std::vector<record>
+read_records(const fs::path& path) {
+
+    std::ifstream ifs{path, std::ios::binary};
+
+    network::tracing::file_header header;
+
+    if(!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+       header.magic != network::tracing::file_header::expected_magic ||
+       header.record_size != sizeof(record)) {
+        throw std::runtime_error(
+                fmt::format("{}: not a scord trace file", path.string()));
+    }
+
+    std::vector<record> records;
+    record r;
+
+    while(ifs.read(reinterpret_cast<char*>(&r), sizeof(r))) {
+        r.name[sizeof(r.name) - 1] = '\0';
+        records.push_back(r);
+    }
+
+    return records;
+}
+
+// Chrome traces use microseconds
+double
+to_us(std::uint64_t ns) {
+    return static_cast<double>(ns) / 1000.0;
+}
+
+void
+write_json(std::FILE* out, const std::vector<record>& records) {
+
+    std::unordered_map<std::uint64_t, const record*> spans;
+
+    for(const auto& r : records) {
+        spans.emplace(r.span_id, &r);
+    }
+
+    fmt::print(out, "{{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+
+    bool first = true;
+    const auto print_event = [&](const std::string& event) {
+        fmt::print(out, "{}  {}", first ? "" : ",\n", event);
+        first = false;
+    };
+
+    for(const auto& r : records) {
+
+        print_event(fmt::format(
+                "{{\"name\": {:?}, \"cat\": \"rpc\", \"ph\": \"X\", "
+                "\"ts\": {:.3f}, \"dur\": {:.3f}, \"pid\": {}, \"tid\": {}, "
+                "\"args\": {{\"trace_id\": \"{:016x}\", "
+                "\"span_id\": \"{:016x}\", "
+                "\"parent_span_id\": \"{:016x}\"}}}}",
+                std::string{r.name}, to_us(r.start_ns), to_us(r.duration_ns),
+                r.pid, r.tid, r.trace_id, r.span_id, r.parent_span_id));
+
+        // Link each span to its parent with a flow event so that calls
+        // across processes are connected in the viewer
+        if(const auto it = spans.find(r.parent_span_id); it != spans.end()) {
+            const auto& parent = *it->second;
+
+            print_event(fmt::format(
+                    "{{\"name\": \"call\", \"cat\": \"rpc\", \"ph\": \"s\", "
+                    "\"id\": \"{:016x}\", \"ts\": {:.3f}, \"pid\": {}, "
+                    "\"tid\": {}}}",
+                    r.span_id, to_us(r.start_ns), parent.pid, parent.tid));
+            print_event(fmt::format(
+                    "{{\"name\": \"call\", \"cat\": \"rpc\", \"ph\": \"f\", "
+                    "\"bp\": \"e\", \"id\": \"{:016x}\", \"ts\": {:.3f}, "
+                    "\"pid\": {}, \"tid\": {}}}",
+                    r.span_id, to_us(r.start_ns), r.pid, r.tid));
+        }
+    }
+
+    fmt::print(out, "\n]}}\n");
+}
+
+int
+main(int argc, char* argv[]) {
+
+    const auto cfg = parse_command_line(argc, argv);
+
+    try {
+        std::vector<record> records;
+
+        for(const auto& input : cfg.inputs) {
+            const auto rv = read_records(input);
+            records.insert(records.end(), rv.begin(), rv.end());
+        }
+
+        std::FILE* out = stdout;
+
+        if(cfg.output) {
+            out = std::fopen(cfg.output->c_str(), "w");
+
+            if(out == nullptr) {
+                throw std::runtime_error(fmt::format(
+                        "{}: {}", cfg.output->string(), std::strerror(errno)));
+            }
+        }
+
+        write_json(out, records);
+
+        if(out != stdout) {
+            std::fclose(out);
+        }
+    } catch(const std::exception& ex) {
+        fmt::print(stderr, "{}: error: {}\n", cfg.progname, ex.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -26,11 +26,30 @@ if [ "$1" == "start" ]; then
     datadir=$7
     mountdir=$9
     unset SLURM_CPU_BIND SLURM_CPU_BIND_LIST SLURM_CPU_BIND_TYPE SLURM_CPU_BIND_VERBOSE
+    # Daemons register in a hosts file private to this instance, so that a
+    # file left behind by a previous instance is never mistaken for this one.
+    # Clients keep finding it through LIBGKFS_HOSTS_FILE.
+    hosts_file=$workdir/gkfs_hosts.txt
+    rm -f $hosts_file
+    mkdir -p $(dirname $LIBGKFS_HOSTS_FILE)
+    ln -sfn $hosts_file $LIBGKFS_HOSTS_FILE
     
     srun -N $num_nodes -n $num_nodes --oversubscribe --overlap --cpus-per-task=1 --mem-per-cpu=1 --export=ALL /usr/bin/bash -c "mkdir -p $mountdir; mkdir -p $datadir" 
-    srun -N $num_nodes -n $num_nodes --oversubscribe --overlap --cpus-per-task=1 --mem-per-cpu=1 --export=ALL /usr/bin/bash -c "$GKFS_DAEMON --rootdir $datadir --mountdir $mountdir -H $LIBGKFS_HOSTS_FILE" &
-    sleep 4
+    srun -N $num_nodes -n $num_nodes --oversubscribe --overlap --cpus-per-task=1 --mem-per-cpu=1 --export=ALL /usr/bin/bash -c "$GKFS_DAEMON --rootdir $datadir --mountdir $mountdir -H $hosts_file" &
     echo "Started GEKKOFS"
+elif [ "$1" == "ready" ]; then
+    # Succeed once every daemon of the instance has registered
+    nodes=$3
+    num_nodes=$(echo $nodes | awk -F, '{print NF}')
+    # If num_nodes is 50, we are on the testing environment
+    if [ $num_nodes -eq 50 ]; then
+        exit 0
+    fi
+    workdir=$5
+    hosts_file=$workdir/gkfs_hosts.txt
+    [ -f $hosts_file ] || exit 1
+    registered=$(grep -c . $hosts_file)
+    [ $registered -ge $num_nodes ] || exit 1
 elif [ "$1" == "stop" ]; then
     echo "Stopping GEKKOFS"
     
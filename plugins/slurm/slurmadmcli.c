@@ -25,6 +25,8 @@
  *****************************************************************************/
 
 #include <errno.h>
+#include <inttypes.h> /* PRIu64 */
+#include <stdio.h>    /* snprintf */
 #include <stdint.h> /* SIZE_MAX, uint32_t, etc. */
 #include <stdlib.h> /* strtoul, getenv, reallocarray */
 #include <string.h> /* strchr, strncmp, strncpy */
@@ -639,6 +641,12 @@ scord_register_job(spank_t sp, scord_plugin_config_t cfg,
     }
     spank_setenv(sp, "ADHOC_PATH", adhoc_path, 1);
 
+    // let applications using the scord user API find their job
+    char scord_job_id[32];
+    snprintf(scord_job_id, sizeof(scord_job_id), "%" PRIu64, scord_job->j_id);
+    spank_setenv(sp, "LIBSCORD_SERVER_ADDRESS", cfg.scord_info.addr, 1);
+    spank_setenv(sp, "LIBSCORD_JOB_ID", scord_job_id, 1);
+
     if(input_datasets_count > 0) {
         // divide input_datasets into sources and targets
         ADM_dataset_t* sources =
@@ -652,9 +660,12 @@ scord_register_job(spank_t sp, scord_plugin_config_t cfg,
             sources[i] = scord_reqs->r_inputs->l_routes[i].d_src;
             targets[i] = scord_reqs->r_inputs->l_routes[i].d_dst;
         }
-        // Unfortunaly we have to sleep or cargo will not find the instance
-        // up.
-        sleep(5);
+        // GekkoFS deployments only complete once its readiness probe
+        // succeeds. Other ad-hoc storage types have no such probe, so we
+        // still have to sleep or cargo will not find the instance up.
+        if(adhoc_type != ADM_ADHOC_STORAGE_GEKKOFS) {
+            sleep(5);
+        }
 
         int nlimit = 0;
         if(limit > 0) {
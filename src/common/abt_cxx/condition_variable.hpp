@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2021-2022, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef SCORD_ABT_CONDITION_VARIABLE_HPP
+#define SCORD_ABT_CONDITION_VARIABLE_HPP
+
+#include <chrono>
+#include <ctime>
+
+namespace scord::abt {
+
+/**
+ * Convert a `std::chrono::system_clock` time point into the absolute time
+ * expected by Argobots condition variables (e.g. by
+ * `thallium::condition_variable::wait_until()`).
+ */
+template <typename Duration>
+inline struct timespec
+to_timespec(std::chrono::time_point<std::chrono::system_clock, Duration> tp) {
+
+    using namespace std::chrono;
+
+    const auto secs = time_point_cast<seconds>(tp);
+    const auto nsecs = duration_cast<nanoseconds>(tp - secs);
+
+    return {static_cast<std::time_t>(secs.time_since_epoch().count()),
+            static_cast<long>(nsecs.count())};
+}
+
+/**
+ * Block the calling ULT on `cv` until `pred()` returns true or `timeout`
+ * expires. `lock` must be held by the caller, and is held again when the
+ * function returns.
+ *
+ * @return The value of `pred()` when the function returns.
+ */
+template <typename ConditionVariable, typename Lock, typename Rep,
+          typename Period, typename Predicate>
+bool
+wait_for(ConditionVariable& cv, Lock& lock,
+         std::chrono::duration<Rep, Period> timeout, Predicate pred) {
+
+    const auto abstime =
+            to_timespec(std::chrono::system_clock::now() + timeout);
+
+    while(!pred()) {
+        if(!cv.wait_until(lock, &abstime)) {
+            return pred();
+        }
+    }
+
+    return true;
+}
+
+} // namespace scord::abt
+
+#endif // SCORD_ABT_CONDITION_VARIABLE_HPP
@@ -109,55 +109,98 @@ logger_destroy() {
 namespace {
 
 /**
- * @brief Creates a logger of the given type.
+ * @brief Creates a synchronous logger of the given type.
  *
- * @tparam Logger Type of the logger to create.
  * @param config Configuration for the logger.
  * @return std::shared_ptr<spdlog::logger> Pointer to the created logger.
  */
-template <typename Logger>
 std::shared_ptr<spdlog::logger>
-create_logger(const logger::logger_config& config)
-        requires(std::is_same_v<Logger, logger::sync_logger> ||
-                 std::is_same_v<Logger, logger::async_logger>) {
+create_sync_logger(const logger::logger_config& config) {
+    switch(config.type()) {
+        case logger::console:
+            return spdlog::stdout_logger_st(config.ident());
+        case logger::console_color:
+            return spdlog::stdout_color_st(config.ident());
+        case logger::file:
+            return spdlog::basic_logger_st(
+                    config.ident(), config.log_file().value_or(""), true);
+        case logger::syslog:
+            return spdlog::syslog_logger_st("syslog", config.ident(), LOG_PID);
+        default:
+            throw std::invalid_argument("Unknown logger type");
+    }
+}
+
+/**
+ * @brief Creates an asynchronous logger of the given type that hands its
+ * messages over to `thread_pool`.
+ *
+ * @param config Configuration for the logger.
+ * @param thread_pool The queue and worker threads of the logger.
+ * @return std::shared_ptr<spdlog::logger> Pointer to the created logger.
+ */
+std::shared_ptr<spdlog::logger>
+create_async_logger(
+        const logger::logger_config& config,
+        const std::shared_ptr<spdlog::details::thread_pool>& thread_pool) {
 
-    const auto create_helper = [&config]() {
+    const auto [name, sink] = [&config]() -> std::pair<std::string,
+                                                       spdlog::sink_ptr> {
         switch(config.type()) {
-            case logger::console: {
-                if constexpr(std::is_same_v<Logger, logger::sync_logger>) {
-                    return spdlog::stdout_logger_st(config.ident());
-                }
-                return spdlog::stdout_logger_mt<spdlog::async_factory>(
-                        config.ident());
-            }
+            case logger::console:
+                return {config.ident(),
+                        std::make_shared<spdlog::sinks::stdout_sink_mt>()};
             case logger::console_color:
-                if constexpr(std::is_same_v<Logger, logger::sync_logger>) {
-                    return spdlog::stdout_color_st(config.ident());
-                }
-                return spdlog::stdout_color_mt<spdlog::async_factory>(
-                        config.ident());
+                return {config.ident(),
+                        std::make_shared<
+                                spdlog::sinks::stdout_color_sink_mt>()};
             case logger::file:
-                if constexpr(std::is_same_v<Logger, logger::sync_logger>) {
-                    return spdlog::basic_logger_st(
-                            config.ident(), config.log_file().value_or(""),
-                            true);
-                }
-                return spdlog::basic_logger_mt<spdlog::async_factory>(
-                        config.ident(), config.log_file().value_or(""), true);
+                return {config.ident(),
+                        std::make_shared<spdlog::sinks::basic_file_sink_mt>(
+                                config.log_file().value_or(""), true)};
             case logger::syslog:
-                if constexpr(std::is_same_v<Logger, logger::sync_logger>) {
-                    return spdlog::syslog_logger_st("syslog", config.ident(),
-                                                    LOG_PID);
-                }
-                return spdlog::syslog_logger_mt("syslog", config.ident(),
-                                                LOG_PID);
+                return {"syslog",
+                        std::make_shared<spdlog::sinks::syslog_sink_mt>(
+                                config.ident(), LOG_PID, LOG_USER, false)};
             default:
                 throw std::invalid_argument("Unknown logger type");
         }
-    };
+    }();
+
+    // new messages are dropped by logger_base itself under the
+    // `discard_new` policy, and the queue only overruns when racing callers
+    // find it full at the same time
+    return std::make_shared<spdlog::async_logger>(
+            name, sink, thread_pool,
+            config.async().policy == logger::overflow_policy::block
+                    ? spdlog::async_overflow_policy::block
+                    : spdlog::async_overflow_policy::overrun_oldest);
+}
+
+/**
+ * @brief Creates a logger of the given type.
+ *
+ * @tparam Logger Type of the logger to create.
+ * @param config Configuration for the logger.
+ * @param thread_pool The queue and worker threads of asynchronous loggers.
+ * @return std::shared_ptr<spdlog::logger> Pointer to the created logger.
+ */
+template <typename Logger>
+std::shared_ptr<spdlog::logger>
+create_logger(const logger::logger_config& config,
+              const std::shared_ptr<spdlog::details::thread_pool>& thread_pool)
+        requires(std::is_same_v<Logger, logger::sync_logger> ||
+                 std::is_same_v<Logger, logger::async_logger>) {
 
     try {
-        auto logger = create_helper();
+        std::shared_ptr<spdlog::logger> logger;
+
+        if constexpr(std::is_same_v<Logger, logger::sync_logger>) {
+            logger = create_sync_logger(config);
+        } else {
+            logger = create_async_logger(config, thread_pool);
+        }
+
         assert(logger != nullptr);
         logger->set_pattern(logger::default_pattern);
 
@@ -176,9 +219,74 @@ create_logger(const logger::logger_config& config)
 
 namespace logger {
 
+std::optional<subsystem>
+subsystem_from_string(std::string_view name) {
+    for(const auto s : subsystems) {
+        if(to_string(s) == name) {
+            return s;
+        }
+    }
+    return {};
+}
+
+std::optional<spdlog::level::level_enum>
+level_from_string(std::string_view name) {
+
+    // spdlog::level::from_str() maps unknown names to `off`
+    const auto level = spdlog::level::from_str(std::string{name});
+
+    if(level == spdlog::level::off && name != "off") {
+        return {};
+    }
+
+    return level;
+}
+
+bool
+set_default_logger_level(std::string_view subsystem, std::string_view level) {
+
+    const auto lg = get_default_logger();
+    const auto new_level = level_from_string(level);
+
+    if(!lg || !new_level) {
+        return false;
+    }
+
+    if(subsystem == "all") {
+        for(const auto s : subsystems) {
+            lg->set_level(s, *new_level);
+        }
+        return true;
+    }
+
+    if(const auto s = subsystem_from_string(subsystem); s) {
+        lg->set_level(*s, *new_level);
+        return true;
+    }
+
+    return false;
+}
+
+std::optional<overflow_policy>
+overflow_policy_from_string(std::string_view name) {
+
+    if(name == "block") {
+        return overflow_policy::block;
+    }
+
+    if(name == "overrun_oldest") {
+        return overflow_policy::overrun_oldest;
+    }
+
+    if(name == "discard_new") {
+        return overflow_policy::discard_new;
+    }
+
+    return {};
+}
+
 logger_base::logger_base(logger::logger_config config)
-    : m_config(std::move(config)),
-      m_internal_logger(::create_logger<async_logger>(m_config)) {}
+    : m_config(std::move(config)) {}
 
 const logger_config&
 logger_base::config() const {
@@ -193,7 +301,30 @@ logger_base::get_default_logger() {
 
 void
 logger_base::enable_debug() const {
-    m_internal_logger->set_level(spdlog::level::debug);
+    for(const auto s : subsystems) {
+        set_level(s, spdlog::level::debug);
+    }
+}
+
+void
+logger_base::set_level(subsystem s, spdlog::level::level_enum level) const {
+    get(s)->set_level(level);
+}
+
+spdlog::level::level_enum
+logger_base::level(subsystem s) const {
+    return get(s)->level();
+}
+
+void
+logger_base::create_subsystem_loggers() {
+    for(const auto s : subsystems) {
+        if(s != subsystem::general) {
+            m_subsystem_loggers[static_cast<std::size_t>(s)] =
+                    m_internal_logger->clone(fmt::format(
+                            "{}.{}", m_config.ident(), to_string(s)));
+        }
+    }
 }
 
 void
@@ -201,9 +332,42 @@ logger_base::flush() {
     m_internal_logger->flush();
 }
 
+std::size_t
+logger_base::dropped_messages() const {
+
+    if(!m_thread_pool) {
+        return 0;
+    }
+
+    return m_thread_pool->overrun_counter() +
+           m_discarded->load(std::memory_order_relaxed);
+}
+
+bool
+logger_base::queue_full() const {
+
+    if(!m_thread_pool ||
+       m_thread_pool->queue_size() < m_config.async().queue_size) {
+        return false;
+    }
+
+    m_discarded->fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::size_t
+logger_base::queued_messages() const {
+    return m_thread_pool ? m_thread_pool->queue_size() : 0;
+}
+
 async_logger::async_logger(const logger_config& config) : logger_base(config) {
     try {
-        m_internal_logger = ::create_logger<async_logger>(config);
+        m_thread_pool = std::make_shared<spdlog::details::thread_pool>(
+                config.async().queue_size, config.async().worker_threads);
+        m_discarded = std::make_shared<std::atomic<std::size_t>>(0);
+        m_internal_logger =
+                ::create_logger<async_logger>(config, m_thread_pool);
+        create_subsystem_loggers();
     } catch(const spdlog::spdlog_ex& ex) {
         throw std::runtime_error("logger initialization failed: " +
                                  std::string(ex.what()));
@@ -212,7 +376,8 @@ async_logger::async_logger(const logger_config& config) : logger_base(config) {
 
 sync_logger::sync_logger(const logger_config& config) : logger_base(config) {
     try {
-        m_internal_logger = ::create_logger<sync_logger>(config);
+        m_internal_logger = ::create_logger<sync_logger>(config, {});
+        create_subsystem_loggers();
     } catch(const spdlog::spdlog_ex& ex) {
         throw std::runtime_error("logger initialization failed: " +
                                  std::string(ex.what()));
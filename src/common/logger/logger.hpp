@@ -26,10 +26,14 @@
 #define SCORD_LOGGER_HPP
 
 #include <spdlog/logger.h>
+#include <spdlog/async_logger.h>
 #include <fmt/ostream.h>
+#include <array>
+#include <atomic>
 #include <filesystem>
 #include <optional>
 #include <sstream>
+#include <string_view>
 
 #include "macros.h"
 
@@ -52,15 +56,92 @@ enum logger_type {
     syslog,
 };
 
+/**
+ * @brief The subsystems whose log levels can be adjusted independently
+ *
+ * Each subsystem logs through its own named logger, which shares the sinks
+ * of the logger it belongs to. The LOGGER_* macros log to the subsystem
+ * named by the `logger_subsystem` constant visible at the call site, so
+ * that a class or function can redirect its messages by declaring its own:
+ *
+ * @code
+ * static constexpr auto logger_subsystem = logger::subsystem::network;
+ * @endcode
+ */
+enum class subsystem {
+    general,
+    rpc,
+    network,
+    scheduler,
+};
+
+static constexpr std::array subsystems = {
+        subsystem::general, subsystem::rpc, subsystem::network,
+        subsystem::scheduler};
+
+constexpr std::string_view
+to_string(subsystem s) {
+    switch(s) {
+        case subsystem::general:
+            return "general";
+        case subsystem::rpc:
+            return "rpc";
+        case subsystem::network:
+            return "network";
+        case subsystem::scheduler:
+            return "scheduler";
+    }
+    return "unknown";
+}
+
+std::optional<subsystem>
+subsystem_from_string(std::string_view name);
+
+/**
+ * @brief Parse a log level name ("trace", "debug", "info", "warning",
+ * "error", "critical" or "off")
+ */
+std::optional<spdlog::level::level_enum>
+level_from_string(std::string_view name);
+
+/**
+ * @brief What an asynchronous logger does with a new message when its queue
+ * is full
+ */
+enum class overflow_policy {
+    // wait until there is room in the queue
+    block,
+    // drop the oldest message in the queue
+    overrun_oldest,
+    // drop the new message
+    discard_new,
+};
+
+std::optional<overflow_policy>
+overflow_policy_from_string(std::string_view name);
+
+/**
+ * @brief Settings of the queue through which asynchronous loggers hand
+ * messages over to their worker threads
+ */
+struct async_settings {
+    std::size_t queue_size = 8192;
+    std::size_t worker_threads = 1;
+    // the default never blocks the caller, so that logging cannot stall
+    // the threads serving requests
+    overflow_policy policy = overflow_policy::overrun_oldest;
+};
+
 class logger_config {
 
 public:
     logger_config() = default;
 
     explicit logger_config(std::string ident, logger_type type,
-                           std::optional<std::filesystem::path> log_file = {})
+                           std::optional<std::filesystem::path> log_file = {},
+                           async_settings async = {})
         : m_ident(std::move(ident)), m_type(type),
-          m_log_file(std::move(log_file)) {}
+          m_log_file(std::move(log_file)), m_async(async) {}
 
     const std::string&
     ident() const {
@@ -77,10 +158,16 @@ public:
         return m_log_file;
     }
 
+    const async_settings&
+    async() const {
+        return m_async;
+    }
+
 private:
     std::string m_ident;
     logger_type m_type = console_color;
     std::optional<std::filesystem::path> m_log_file;
+    async_settings m_async;
 };
 
 
@@ -163,31 +250,84 @@ public:
     void
     enable_debug() const;
 
+    /**
+     * @brief Set the level of the messages logged by subsystem `s`
+     */
+    void
+    set_level(subsystem s, spdlog::level::level_enum level) const;
+
+    spdlog::level::level_enum
+    level(subsystem s) const;
+
+    bool
+    should_log(subsystem s, spdlog::level::level_enum level) const {
+        return get(s)->should_log(level);
+    }
+
     void
     flush();
 
+    /**
+     * @brief Number of messages dropped so far because the queue of an
+     * asynchronous logger was full
+     */
+    std::size_t
+    dropped_messages() const;
+
+    /**
+     * @brief Number of messages waiting in the queue of an asynchronous
+     * logger
+     */
+    std::size_t
+    queued_messages() const;
+
+    template <typename... Args>
+    inline void
+    log(subsystem s, spdlog::level::level_enum level,
+        fmt::format_string<Args...> fmt, Args&&... args) {
+        if(should_log(s, level) && !must_discard()) {
+            get(s)->log(level, fmt, std::forward<Args>(args)...);
+        }
+    }
+
+    template <typename T>
+    inline void
+    log(subsystem s, spdlog::level::level_enum level, const T& msg) {
+        if(should_log(s, level) && !must_discard()) {
+            get(s)->log(level, msg);
+        }
+    }
+
     template <typename... Args>
     inline void
     info(fmt::format_string<Args...> fmt, Args&&... args) {
-        m_internal_logger->info(fmt, std::forward<Args>(args)...);
+        if(accept(spdlog::level::info)) {
+            m_internal_logger->info(fmt, std::forward<Args>(args)...);
+        }
     }
 
     template <typename... Args>
     inline void
     debug(fmt::format_string<Args...> fmt, Args&&... args) {
-        m_internal_logger->debug(fmt, std::forward<Args>(args)...);
+        if(accept(spdlog::level::debug)) {
+            m_internal_logger->debug(fmt, std::forward<Args>(args)...);
+        }
     }
 
     template <typename... Args>
     inline void
     warn(fmt::format_string<Args...> fmt, Args&&... args) {
-        m_internal_logger->warn(fmt, std::forward<Args>(args)...);
+        if(accept(spdlog::level::warn)) {
+            m_internal_logger->warn(fmt, std::forward<Args>(args)...);
+        }
     }
 
     template <typename... Args>
     inline void
     error(fmt::format_string<Args...> fmt, Args&&... args) {
-        m_internal_logger->error(fmt, std::forward<Args>(args)...);
+        if(accept(spdlog::level::err)) {
+            m_internal_logger->error(fmt, std::forward<Args>(args)...);
+        }
     }
 
     [[maybe_unused]] static inline std::string
@@ -214,44 +354,58 @@ public:
 
         char* msg = strerror_r(saved_errno, errstr.data(), MAX_ERROR_MSG);
 
-        m_internal_logger->error(fmt::runtime(str_fmt),
-                                 std::forward<Args>(args)..., msg);
+        if(accept(spdlog::level::err)) {
+            m_internal_logger->error(fmt::runtime(str_fmt),
+                                     std::forward<Args>(args)..., msg);
+        }
     }
 
     template <typename... Args>
     inline void
     critical(fmt::format_string<Args...> fmt, Args&&... args) {
-        m_internal_logger->critical(fmt, std::forward<Args>(args)...);
+        if(accept(spdlog::level::critical)) {
+            m_internal_logger->critical(fmt, std::forward<Args>(args)...);
+        }
     }
 
     template <typename T>
     inline void
     info(const T& msg) {
-        m_internal_logger->info(msg);
+        if(accept(spdlog::level::info)) {
+            m_internal_logger->info(msg);
+        }
     }
 
     template <typename T>
     inline void
     debug(const T& msg) {
-        m_internal_logger->debug(msg);
+        if(accept(spdlog::level::debug)) {
+            m_internal_logger->debug(msg);
+        }
     }
 
     template <typename T>
     inline void
     warn(const T& msg) {
-        m_internal_logger->warn(msg);
+        if(accept(spdlog::level::warn)) {
+            m_internal_logger->warn(msg);
+        }
     }
 
     template <typename T>
     inline void
     error(const T& msg) {
-        m_internal_logger->error(msg);
+        if(accept(spdlog::level::err)) {
+            m_internal_logger->error(msg);
+        }
     }
 
     template <typename T>
     inline void
     critical(const T& msg) {
-        m_internal_logger->critical(msg);
+        if(accept(spdlog::level::critical)) {
+            m_internal_logger->critical(msg);
+        }
     }
 
     template <typename... Args>
@@ -273,8 +427,45 @@ public:
     }
 
 protected:
+    // Whether a message of `level` sent to the `general` subsystem must be
+    // written, i.e. it passes the level filter and is not dropped
+    bool
+    accept(spdlog::level::level_enum level) const {
+        return should_log(subsystem::general, level) && !must_discard();
+    }
+
+    // Whether the next message must be dropped because the queue is full
+    // and the overflow policy is `discard_new`
+    bool
+    must_discard() const {
+        return m_config.async().policy == overflow_policy::discard_new &&
+               queue_full();
+    }
+
+    // Check if the queue is full and, if so, count the message as dropped
+    bool
+    queue_full() const;
+
+    // Create the loggers of all subsystems other than `general` (which uses
+    // `m_internal_logger`) as copies of `m_internal_logger`
+    void
+    create_subsystem_loggers();
+
+    const std::shared_ptr<spdlog::logger>&
+    get(subsystem s) const {
+        return s == subsystem::general
+                       ? m_internal_logger
+                       : m_subsystem_loggers[static_cast<std::size_t>(s)];
+    }
+
     logger_config m_config;
+    // The queue and worker threads of asynchronous loggers, and how many
+    // messages the `discard_new` overflow policy has dropped
+    std::shared_ptr<spdlog::details::thread_pool> m_thread_pool;
+    std::shared_ptr<std::atomic<std::size_t>> m_discarded;
     std::shared_ptr<spdlog::logger> m_internal_logger;
+    std::array<std::shared_ptr<spdlog::logger>, subsystems.size()>
+            m_subsystem_loggers;
 };
 
 /**
@@ -345,6 +536,16 @@ get_default_logger() {
     return async_logger::get_default_logger();
 }
 
+/**
+ * @brief Change the level of a subsystem of the default logger instance
+ *
+ * @param subsystem The name of the subsystem, or "all" for every subsystem
+ * @param level The name of the new level
+ * @return true if both names are valid, false otherwise
+ */
+bool
+set_default_logger_level(std::string_view subsystem, std::string_view level);
+
 /**
  * @brief Flush the default logger instance
  */
@@ -357,4 +558,8 @@ flush_default_logger() {
 
 } // namespace logger
 
+// the subsystem used by the LOGGER_* macros unless a narrower scope declares
+// its own `logger_subsystem`
+inline constexpr auto logger_subsystem = logger::subsystem::general;
+
 #endif /* SCORD_LOGGER_HPP */
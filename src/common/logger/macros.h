@@ -29,22 +29,21 @@
 /* logger macros for C++ code */
 #ifdef __cplusplus
 
-#define LOGGER_INFO(...)                                                       \
+// Messages are logged to the subsystem named by the `logger_subsystem`
+// constant visible at the call site, and their arguments are only evaluated
+// if the subsystem's current level lets the message through
+#define LOGGER_LOG_AT(lvl, ...)                                                \
     do {                                                                       \
-        if(logger::get_default_logger()) {                                     \
-            logger::get_default_logger()->info(__VA_ARGS__);                   \
+        if(const auto scord_logger_ = logger::get_default_logger();            \
+           scord_logger_ &&                                                    \
+           scord_logger_->should_log(logger_subsystem, lvl)) {                 \
+            scord_logger_->log(logger_subsystem, lvl, __VA_ARGS__);            \
         }                                                                      \
     } while(0);
 
+#define LOGGER_INFO(...) LOGGER_LOG_AT(spdlog::level::info, __VA_ARGS__)
 
-#ifdef LOGGER_ENABLE_DEBUG
-
-#define LOGGER_DEBUG(...)                                                      \
-    do {                                                                       \
-        if(logger::get_default_logger()) {                                     \
-            logger::get_default_logger()->debug(__VA_ARGS__);                  \
-        }                                                                      \
-    } while(0);
+#define LOGGER_DEBUG(...) LOGGER_LOG_AT(spdlog::level::debug, __VA_ARGS__)
 
 #define LOGGER_FLUSH()                                                         \
     do {                                                                       \
@@ -53,30 +52,9 @@
         }                                                                      \
     } while(0);
 
-#else // ! LOGGER_ENABLE_DEBUG
-
-#define LOGGER_DEBUG(...)                                                      \
-    do {                                                                       \
-    } while(0);
-#define LOGGER_FLUSH()                                                         \
-    do {                                                                       \
-    } while(0);
+#define LOGGER_WARN(...) LOGGER_LOG_AT(spdlog::level::warn, __VA_ARGS__)
 
-#endif // LOGGER_ENABLE_DEBUG
-
-#define LOGGER_WARN(...)                                                       \
-    do {                                                                       \
-        if(logger::get_default_logger()) {                                     \
-            logger::get_default_logger()->warn(__VA_ARGS__);                   \
-        }                                                                      \
-    } while(0);
-
-#define LOGGER_ERROR(...)                                                      \
-    do {                                                                       \
-        if(logger::get_default_logger()) {                                     \
-            logger::get_default_logger()->error(__VA_ARGS__);                  \
-        }                                                                      \
-    } while(0);
+#define LOGGER_ERROR(...) LOGGER_LOG_AT(spdlog::level::err, __VA_ARGS__)
 
 #define LOGGER_ERRNO(...)                                                      \
     do {                                                                       \
@@ -86,11 +64,7 @@
     } while(0);
 
 #define LOGGER_CRITICAL(...)                                                   \
-    do {                                                                       \
-        if(logger::get_default_logger()) {                                     \
-            logger::get_default_logger()->critical(__VA_ARGS__);               \
-        }                                                                      \
-    } while(0);
+    LOGGER_LOG_AT(spdlog::level::critical, __VA_ARGS__)
 
 #else // ! __cplusplus
 
@@ -128,9 +102,7 @@
 
 #define LOGGER_INFO(fmt, ...) LOGGER_LOG(info, fmt, ##__VA_ARGS__);
 
-#ifdef LOGGER_ENABLE_DEBUG
 #define LOGGER_DEBUG(fmt, ...) LOGGER_LOG(debug, fmt, ##__VA_ARGS__);
-#endif
 
 #define LOGGER_WARN(fmt, ...) LOGGER_LOG(warn, fmt, ##__VA_ARGS__);
 
@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <logger/logger.hpp>
+#include "access_log.hpp"
+
+namespace {
+
+void
+copy_string(char* dst, std::size_t size, std::string_view src) {
+    const auto n = std::min(src.size(), size - 1);
+    std::memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+}
+
+} // namespace
+
+namespace network::access_log {
+
+writer::~writer() {
+    close();
+}
+
+bool
+writer::open(const std::filesystem::path& path, std::size_t capacity) {
+
+    close();
+
+    if(capacity == 0) {
+        LOGGER_ERROR("Invalid access log capacity: {}", capacity);
+        return false;
+    }
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if(fd == -1) {
+        LOGGER_ERROR("Failed to open access log {}: {}", path.string(),
+                     std::strerror(errno));
+        return false;
+    }
+
+    const auto size = sizeof(file_header) + capacity * sizeof(record);
+
+    if(::ftruncate(fd, static_cast<off_t>(size)) == -1) {
+        LOGGER_ERROR("Failed to resize access log {}: {}", path.string(),
+                     std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    // the mapping is shared with the file, so records reach it even if the
+    // process crashes, and it outlives any fork() to daemonize
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd, 0);
+    ::close(fd);
+
+    if(addr == MAP_FAILED) {
+        LOGGER_ERROR("Failed to map access log {}: {}", path.string(),
+                     std::strerror(errno));
+        return false;
+    }
+
+    auto* header = new(addr) file_header{};
+    header->capacity = capacity;
+
+    m_records = reinterpret_cast<record*>(static_cast<char*>(addr) +
+                                          sizeof(file_header));
+    m_mapping_size = size;
+    m_header.store(header, std::memory_order_release);
+    return true;
+}
+
+void
+writer::close() {
+
+    auto* header = m_header.exchange(nullptr, std::memory_order_acq_rel);
+
+    if(header == nullptr) {
+        return;
+    }
+
+    ::msync(header, m_mapping_size, MS_SYNC);
+    ::munmap(header, m_mapping_size);
+    m_records = nullptr;
+    m_mapping_size = 0;
+}
+
+void
+writer::write(const rpc_info& rpc, std::int32_t retval) noexcept {
+
+    auto* header = m_header.load(std::memory_order_acquire);
+
+    if(header == nullptr) {
+        return;
+    }
+
+    using namespace std::chrono;
+
+    const auto index = std::atomic_ref{header->head}.fetch_add(
+            1, std::memory_order_relaxed);
+    auto& r = m_records[index % header->capacity];
+    std::atomic_ref seq{r.seq};
+
+    // readers ignore the slot until `seq` names this record
+    seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const auto start = rpc.start_time();
+    const auto trace = rpc.trace();
+
+    r.rpc_id = rpc.id();
+    r.trace_id = trace.trace_id;
+    r.span_id = trace.span_id;
+    r.start_ns = duration_cast<nanoseconds>(start.time_since_epoch()).count();
+    r.duration_ns =
+            duration_cast<nanoseconds>(system_clock::now() - start).count();
+    r.retval = retval;
+    r.reserved = 0;
+    copy_string(r.name, sizeof(r.name), rpc.name());
+    copy_string(r.peer, sizeof(r.peer), rpc.address());
+
+    seq.store(index + 1, std::memory_order_release);
+}
+
+} // namespace network::access_log
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#ifndef NETWORK_ACCESS_LOG_HPP
+#define NETWORK_ACCESS_LOG_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include "utilities.hpp"
+
+namespace network::access_log {
+
+/**
+ * An entry in the access log, recorded for every request served. Records
+ * are fixed-size and hold raw values only (formatting them is left to
+ * `scord_access_log`) so that writing one is a handful of stores into
+ * memory shared with the log file.
+ */
+struct record {
+    // index of the record plus one once it is complete, 0 while it is
+    // being written
+    std::uint64_t seq;
+    std::uint64_t rpc_id;
+    std::uint64_t trace_id;
+    std::uint64_t span_id;
+    // start time (nanoseconds since the Unix epoch) and duration of the RPC
+    std::uint64_t start_ns;
+    std::uint64_t duration_ns;
+    std::int32_t retval;
+    std::uint32_t reserved;
+    // NUL-terminated (and possibly truncated) RPC name and peer address
+    char name[48];
+    char peer[136];
+};
+
+static_assert(sizeof(record) == 240);
+
+/**
+ * The log file is a `file_header` followed by a ring of `capacity`
+ * records. Record `i` lives in slot `i % capacity`, so the file always
+ * holds the last `capacity` requests served.
+ */
+struct file_header {
+    static constexpr std::uint64_t expected_magic = 0x31304c4341524353;
+
+    std::uint64_t magic = expected_magic; // "SCRACL01"
+    std::uint32_t record_size = sizeof(record);
+    std::uint32_t reserved = 0;
+    std::uint64_t capacity = 0;
+    // number of records ever claimed by writers
+    alignas(64) std::uint64_t head = 0;
+    char padding[56] = {};
+};
+
+static_assert(sizeof(file_header) == 128);
+
+/**
+ * The writer side of an access log. Records are written straight into a
+ * shared mapping of the log file: writers claim a slot with an atomic
+ * increment and never block each other or issue system calls.
+ */
+class writer {
+
+public:
+    writer() = default;
+
+    writer(const writer&) = delete;
+    writer&
+    operator=(const writer&) = delete;
+
+    ~writer();
+
+    /**
+     * Start recording into `path`, replacing any previous contents, with
+     * room for the last `capacity` requests.
+     *
+     * @return true if the file could be created and mapped, false
+     * otherwise.
+     */
+    bool
+    open(const std::filesystem::path& path, std::size_t capacity);
+
+    void
+    close();
+
+    bool
+    enabled() const noexcept {
+        return m_header.load(std::memory_order_acquire) != nullptr;
+    }
+
+    /**
+     * Record that `rpc` completed with `retval`. The duration is measured
+     * from the creation of `rpc`. Does nothing unless the log is open.
+     */
+    void
+    write(const rpc_info& rpc, std::int32_t retval) noexcept;
+
+private:
+    std::atomic<file_header*> m_header = nullptr;
+    record* m_records = nullptr;
+    std::size_t m_mapping_size = 0;
+};
+
+} // namespace network::access_log
+
+#endif // NETWORK_ACCESS_LOG_HPP
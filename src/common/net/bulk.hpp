@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef NETWORK_BULK_HPP
+#define NETWORK_BULK_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+#include <thallium.hpp>
+#include <logger/logger.hpp>
+
+/**
+ * Helpers to move large payloads (e.g. dataset manifests) out of the RPC's
+ * eager buffer. The sender packs the payload into a contiguous buffer and
+ * exposes it through a bulk handle that is sent along with the RPC, and the
+ * receiver pulls it with a single RDMA (or shared-memory) transfer.
+ */
+namespace network::bulk {
+
+/**
+ * Payloads larger than this (in bytes) should be sent through a bulk handle.
+ * This is below Mercury's default eager size so that requests exceeding it
+ * never fall back to the library's internal overflow path.
+ */
+constexpr std::size_t threshold = 4096;
+
+/**
+ * Pack a list of strings into a buffer as a sequence of NUL-terminated
+ * strings.
+ */
+template <typename Range, typename Projection>
+std::vector<char>
+pack(const Range& range, Projection&& proj) {
+
+    std::size_t size = 0;
+
+    for(const auto& e : range) {
+        size += proj(e).size() + 1;
+    }
+
+    std::vector<char> buffer;
+    buffer.reserve(size);
+
+    for(const auto& e : range) {
+        const auto& s = proj(e);
+        buffer.insert(buffer.end(), s.begin(), s.end());
+        buffer.push_back('\0');
+    }
+
+    return buffer;
+}
+
+/**
+ * Unpack a buffer created with `pack()`.
+ */
+inline std::vector<std::string>
+unpack(const std::vector<char>& buffer) {
+
+    std::vector<std::string> rv;
+
+    for(auto it = buffer.begin(); it != buffer.end();) {
+        const auto end = std::find(it, buffer.end(), '\0');
+        rv.emplace_back(it, end);
+        it = (end == buffer.end()) ? end : std::next(end);
+    }
+
+    return rv;
+}
+
+/**
+ * Expose `buffer` for reading by a remote peer. The buffer must be kept
+ * alive until the remote peer has pulled it (e.g. until the RPC that carries
+ * the handle has been responded to).
+ */
+inline thallium::bulk
+expose(thallium::engine& engine, std::vector<char>& buffer) {
+    std::vector<std::pair<void*, std::size_t>> segments{
+            {buffer.data(), buffer.size()}};
+    return engine.expose(segments, thallium::bulk_mode::read_only);
+}
+
+/**
+ * Pull the contents of a bulk handle exposed by the sender of `req`.
+ */
+inline std::optional<std::vector<char>>
+pull(thallium::engine& engine, const thallium::request& req,
+     thallium::bulk& remote) {
+
+    try {
+        std::vector<char> buffer(remote.size());
+
+        if(buffer.empty()) {
+            return buffer;
+        }
+
+        std::vector<std::pair<void*, std::size_t>> segments{
+                {buffer.data(), buffer.size()}};
+        auto local = engine.expose(segments, thallium::bulk_mode::write_only);
+        remote.on(req.get_endpoint()) >> local;
+        return buffer;
+    } catch(const std::exception& ex) {
+        LOGGER_ERROR("bulk::pull() failed: {}", ex.what());
+        return std::nullopt;
+    }
+}
+
+} // namespace network::bulk
+
+#endif // NETWORK_BULK_HPP
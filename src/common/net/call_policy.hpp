@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef NETWORK_CALL_POLICY_HPP
+#define NETWORK_CALL_POLICY_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace network {
+
+/**
+ * How an outbound RPC should be issued: how long to wait for a response
+ * and, for RPCs that can be safely repeated, how many times to retry a
+ * failed attempt.
+ */
+struct call_policy {
+
+    static constexpr std::chrono::milliseconds default_timeout{30'000};
+    static constexpr std::chrono::milliseconds default_backoff_base{100};
+    static constexpr std::chrono::milliseconds default_backoff_max{5'000};
+
+    /**
+     * Return the time to wait before retry number `attempt` (starting at
+     * 1). The delay grows exponentially and is randomized over
+     * [0, min(backoff_max, backoff_base * 2^(attempt-1))] so that clients
+     * that failed at the same time do not retry in lockstep.
+     */
+    std::chrono::milliseconds
+    backoff(std::uint32_t attempt) const {
+
+        thread_local std::mt19937_64 rng{std::random_device{}()};
+
+        const auto shift = std::min<std::uint32_t>(attempt - 1, 16);
+        const auto ceiling = std::min<std::chrono::milliseconds::rep>(
+                backoff_max.count(), backoff_base.count() << shift);
+
+        if(ceiling <= 0) {
+            return std::chrono::milliseconds{0};
+        }
+
+        std::uniform_int_distribution<std::chrono::milliseconds::rep> dist{
+                0, ceiling};
+        return std::chrono::milliseconds{dist(rng)};
+    }
+
+    //! Deadline for each individual attempt
+    std::chrono::milliseconds timeout = default_timeout;
+    //! Whether the RPC can be safely retried (i.e. it has no side effects
+    //! or repeating them is harmless)
+    bool idempotent = false;
+    //! Maximum number of retries after the first attempt. Ignored unless
+    //! the RPC is idempotent
+    std::uint32_t max_retries = 0;
+    std::chrono::milliseconds backoff_base = default_backoff_base;
+    std::chrono::milliseconds backoff_max = default_backoff_max;
+};
+
+/**
+ * A thread-safe table of call policies keyed by RPC name. RPCs without an
+ * explicit entry use the default policy.
+ */
+class call_policies {
+
+public:
+    call_policy
+    get(const std::string& rpc_name) const {
+        std::shared_lock lock(m_mutex);
+
+        if(const auto it = m_policies.find(rpc_name);
+           it != m_policies.end()) {
+            return it->second;
+        }
+
+        return m_default;
+    }
+
+    void
+    set(const std::string& rpc_name, const call_policy& policy) {
+        std::unique_lock lock(m_mutex);
+        m_policies.insert_or_assign(rpc_name, policy);
+    }
+
+    /**
+     * Override the deadline for `rpc_name`, keeping the rest of its current
+     * policy.
+     */
+    void
+    set_timeout(const std::string& rpc_name,
+                std::chrono::milliseconds timeout) {
+        std::unique_lock lock(m_mutex);
+        const auto it = m_policies.find(rpc_name);
+        auto policy = it != m_policies.end() ? it->second : m_default;
+        policy.timeout = timeout;
+        m_policies.insert_or_assign(rpc_name, policy);
+    }
+
+    call_policy
+    get_default() const {
+        std::shared_lock lock(m_mutex);
+        return m_default;
+    }
+
+    void
+    set_default(const call_policy& policy) {
+        std::unique_lock lock(m_mutex);
+        m_default = policy;
+    }
+
+private:
+    mutable std::shared_mutex m_mutex;
+    call_policy m_default;
+    std::unordered_map<std::string, call_policy> m_policies;
+};
+
+} // namespace network
+
+#endif // NETWORK_CALL_POLICY_HPP
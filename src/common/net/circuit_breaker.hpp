@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef NETWORK_CIRCUIT_BREAKER_HPP
+#define NETWORK_CIRCUIT_BREAKER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace network {
+
+/**
+ * A thread-safe set of per-address circuit breakers.
+ *
+ * After `failure_threshold` consecutive failed calls to an address, its
+ * circuit opens and further calls to it are rejected immediately for
+ * `cooldown`, rather than each of them waiting for its full deadline. Once
+ * the cooldown expires a single trial call is let through: if it succeeds
+ * the circuit closes again, otherwise it stays open for another cooldown.
+ */
+class circuit_breaker {
+
+    using clock = std::chrono::steady_clock;
+
+    struct entry {
+        std::uint32_t m_failures = 0;
+        clock::time_point m_open_until{};
+        bool m_probing = false;
+    };
+
+public:
+    static constexpr std::uint32_t default_failure_threshold = 5;
+    static constexpr std::chrono::seconds default_cooldown{30};
+
+    explicit circuit_breaker(
+            std::uint32_t failure_threshold = default_failure_threshold,
+            clock::duration cooldown = default_cooldown)
+        : m_failure_threshold(failure_threshold), m_cooldown(cooldown) {}
+
+    /**
+     * Check whether a call to `address` should be attempted.
+     */
+    bool
+    allow(const std::string& address) {
+
+        std::lock_guard lock(m_mutex);
+
+        const auto it = m_entries.find(address);
+
+        if(it == m_entries.end() ||
+           it->second.m_failures < m_failure_threshold) {
+            return true;
+        }
+
+        auto& e = it->second;
+
+        if(clock::now() < e.m_open_until || e.m_probing) {
+            return false;
+        }
+
+        e.m_probing = true;
+        return true;
+    }
+
+    void
+    record_success(const std::string& address) {
+        std::lock_guard lock(m_mutex);
+        m_entries.erase(address);
+    }
+
+    void
+    record_failure(const std::string& address) {
+
+        std::lock_guard lock(m_mutex);
+
+        auto& e = m_entries[address];
+        ++e.m_failures;
+        e.m_probing = false;
+
+        if(e.m_failures >= m_failure_threshold) {
+            e.m_open_until = clock::now() + m_cooldown;
+        }
+    }
+
+private:
+    std::uint32_t m_failure_threshold;
+    clock::duration m_cooldown;
+    std::mutex m_mutex;
+    std::unordered_map<std::string, entry> m_entries;
+};
+
+} // namespace network
+
+#endif // NETWORK_CIRCUIT_BREAKER_HPP
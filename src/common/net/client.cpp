@@ -26,25 +26,53 @@
 #include <logger/logger.hpp>
 #include "client.hpp"
 #include "endpoint.hpp"
+#include "transport.hpp"
 
 using namespace std::literals;
 
 namespace network {
 
 
-client::client(const std::string& protocol)
-    : m_engine(protocol, THALLIUM_CLIENT_MODE) {}
+client::client(const std::string& protocol, bool use_progress_thread,
+               bool shared_memory)
+    : m_engine(make_engine(protocol, THALLIUM_CLIENT_MODE, use_progress_thread,
+                           shared_memory)),
+      m_procedures(std::make_shared<procedure_cache>(m_engine)),
+      m_policies(std::make_shared<call_policies>()),
+      m_breaker(std::make_shared<circuit_breaker>()) {}
 
 std::optional<endpoint>
 client::lookup(const std::string& address) noexcept {
     try {
-        return endpoint{m_engine, m_engine.lookup(address)};
+        if(auto endp = m_endpoint_cache.find(address); endp.has_value()) {
+            return endpoint{m_engine, std::move(*endp), m_procedures,
+                            m_policies, m_breaker};
+        }
+
+        auto endp = m_engine.lookup(address);
+        m_endpoint_cache.insert(address, endp);
+        return endpoint{m_engine, std::move(endp), m_procedures, m_policies,
+                        m_breaker};
     } catch(const std::exception& ex) {
         LOGGER_ERROR("client::lookup() failed: {}", ex.what());
         return std::nullopt;
     }
 }
 
+void
+client::invalidate(const std::string& address) noexcept {
+    try {
+        m_endpoint_cache.invalidate(address);
+    } catch(const std::exception& ex) {
+        LOGGER_ERROR("client::invalidate() failed: {}", ex.what());
+    }
+}
+
+call_policies&
+client::policies() noexcept {
+    return *m_policies;
+}
+
 std::string
 client::self_address() const noexcept {
     try {
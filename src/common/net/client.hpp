@@ -25,8 +25,14 @@
 #ifndef NETWORK_CLIENT_HPP
 #define NETWORK_CLIENT_HPP
 
+#include <memory>
 #include <optional>
 #include <thallium.hpp>
+#include <logger/logger.hpp>
+#include "call_policy.hpp"
+#include "circuit_breaker.hpp"
+#include "endpoint_cache.hpp"
+#include "procedure_cache.hpp"
 
 namespace network {
 
@@ -35,14 +41,31 @@ class endpoint;
 class client {
 
 public:
-    explicit client(const std::string& protocol);
+    explicit client(const std::string& protocol,
+                    bool use_progress_thread = false,
+                    bool shared_memory = true);
     std::optional<endpoint>
     lookup(const std::string& address) noexcept;
+    void
+    invalidate(const std::string& address) noexcept;
+
+    /**
+     * The policies (deadlines, retries) applied to outbound RPCs issued
+     * through endpoints returned by `lookup()`.
+     */
+    call_policies&
+    policies() noexcept;
     std::string
     self_address() const noexcept;
 
 private:
+    static constexpr auto logger_subsystem = logger::subsystem::network;
+
     thallium::engine m_engine;
+    std::shared_ptr<procedure_cache> m_procedures;
+    std::shared_ptr<call_policies> m_policies;
+    std::shared_ptr<circuit_breaker> m_breaker;
+    endpoint_cache m_endpoint_cache;
 };
 
 } // namespace network
@@ -28,12 +28,17 @@
 
 namespace network {
 
-endpoint::endpoint(thallium::engine& engine, thallium::endpoint endpoint)
-    : m_engine(engine), m_endpoint(std::move(endpoint)) {}
+endpoint::endpoint(thallium::engine& engine, thallium::endpoint endpoint,
+                   std::shared_ptr<procedure_cache> procedures,
+                   std::shared_ptr<call_policies> policies,
+                   std::shared_ptr<circuit_breaker> breaker)
+    : m_engine(engine), m_endpoint(std::move(endpoint)),
+      m_address(m_endpoint), m_procedures(std::move(procedures)),
+      m_policies(std::move(policies)), m_breaker(std::move(breaker)) {}
 
 std::string
 endpoint::address() const {
-    return m_endpoint;
+    return m_address;
 }
 
 } // namespace network
@@ -26,52 +26,99 @@
 #define NETWORK_ENDPOINT_HPP
 
 #include <thallium.hpp>
+#include <memory>
 #include <optional>
 #include <logger/logger.hpp>
+#include "call_policy.hpp"
+#include "circuit_breaker.hpp"
+#include "procedure_cache.hpp"
 
 namespace network {
 
 class endpoint {
 
 public:
-    endpoint(thallium::engine& engine, thallium::endpoint endpoint);
+    endpoint(thallium::engine& engine, thallium::endpoint endpoint,
+             std::shared_ptr<procedure_cache> procedures,
+             std::shared_ptr<call_policies> policies,
+             std::shared_ptr<circuit_breaker> breaker);
 
     std::string
     address() const;
 
+    /**
+     * Invoke `rpc_name` following the call policy configured for it, i.e.
+     * with its deadline and, if it is idempotent, retrying failed attempts
+     * with a jittered exponential backoff.
+     */
     template <typename... Args>
     inline std::optional<thallium::packed_data<>>
     call(const std::string& rpc_name, Args&&... args) const {
-
-        try {
-            const auto rpc = m_engine.define(rpc_name);
-            return std::make_optional(
-                    rpc.on(m_endpoint)(std::forward<Args>(args)...));
-        } catch(const std::exception& ex) {
-            LOGGER_ERROR("endpoint::call() failed: {}", ex.what());
-            return std::nullopt;
-        }
+        return invoke(rpc_name, m_policies->get(rpc_name), args...);
     }
 
+    /**
+     * Same as `call()` but overriding the deadline configured for
+     * `rpc_name` (e.g. for long-polling RPCs whose deadline depends on
+     * their arguments).
+     */
     template <typename Rep, typename Period, typename... Args>
     inline std::optional<thallium::packed_data<>>
     timed_call(const std::string& rpc_name,
                const std::chrono::duration<Rep, Period>& timeout,
                Args&&... args) const {
 
-        using namespace std::chrono_literals;
+        auto policy = m_policies->get(rpc_name);
+        policy.timeout =
+                std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
+        return invoke(rpc_name, policy, args...);
+    }
+
+    /**
+     * Issue `rpc_name` without waiting for its response, which must be
+     * retrieved with `wait()`. The deadline configured for `rpc_name` starts
+     * running when the request is sent. Asynchronous calls are never retried.
+     */
+    template <typename... Args>
+    inline std::optional<thallium::async_response>
+    async_call(const std::string& rpc_name, Args&&... args) const {
+
+        if(!m_breaker->allow(m_address)) {
+            LOGGER_ERROR("endpoint::async_call() failed: circuit open for {}",
+                         m_address);
+            return std::nullopt;
+        }
+
+        const auto policy = m_policies->get(rpc_name);
 
         try {
-            const auto rpc = m_engine.define(rpc_name);
-            return std::make_optional(
-                    rpc.on(m_endpoint)
-                            .timed(timeout, std::forward<Args>(args)...));
+            const auto& rpc = m_procedures->get(rpc_name);
+            return std::make_optional(rpc.on(m_endpoint).timed_async(
+                    policy.timeout, std::forward<Args>(args)...));
         } catch(const std::exception& ex) {
-            LOGGER_ERROR("endpoint::timed_call() failed: {}", ex.what());
+            LOGGER_ERROR("endpoint::async_call() failed: {}", ex.what());
+            m_breaker->record_failure(m_address);
             return std::nullopt;
         }
     }
 
+    /**
+     * Wait for the response to an `async_call()` issued through this
+     * endpoint and record its outcome in the circuit breaker. Throws
+     * `thallium::timeout` if the deadline of the call expired.
+     */
+    thallium::packed_data<>
+    wait(thallium::async_response& response) const {
+        try {
+            auto rv = response.wait();
+            m_breaker->record_success(m_address);
+            return rv;
+        } catch(...) {
+            m_breaker->record_failure(m_address);
+            throw;
+        }
+    }
+
     auto
     endp() const {
         return m_endpoint;
@@ -83,8 +130,64 @@ public:
     }
 
 private:
+    static constexpr auto logger_subsystem = logger::subsystem::network;
+
+    template <typename... Args>
+    std::optional<thallium::packed_data<>>
+    invoke(const std::string& rpc_name, const call_policy& policy,
+           const Args&... args) const {
+
+        const std::uint32_t max_attempts =
+                1 + (policy.idempotent ? policy.max_retries : 0);
+
+        for(std::uint32_t attempt = 0; attempt < max_attempts; ++attempt) {
+
+            if(attempt > 0) {
+                const auto delay = policy.backoff(attempt);
+                LOGGER_WARN("endpoint::call() retrying {} on {} in {}ms "
+                            "(attempt {} of {})",
+                            rpc_name, m_address, delay.count(), attempt + 1,
+                            max_attempts);
+                thallium::thread::sleep(m_engine,
+                                        static_cast<double>(delay.count()));
+            }
+
+            if(!m_breaker->allow(m_address)) {
+                LOGGER_ERROR("endpoint::call() failed: circuit open for {}",
+                             m_address);
+                return std::nullopt;
+            }
+
+            LOGGER_DEBUG("endpoint::call() {} on {} (attempt {} of {}, "
+                         "timeout {}ms)",
+                         rpc_name, m_address, attempt + 1, max_attempts,
+                         policy.timeout.count());
+
+            try {
+                const auto& rpc = m_procedures->get(rpc_name);
+                auto rv = rpc.on(m_endpoint).timed(policy.timeout, args...);
+                m_breaker->record_success(m_address);
+                return std::make_optional(std::move(rv));
+            } catch(const thallium::timeout&) {
+                LOGGER_ERROR("endpoint::call() failed: {} on {} timed out "
+                             "after {}ms",
+                             rpc_name, m_address, policy.timeout.count());
+                m_breaker->record_failure(m_address);
+            } catch(const std::exception& ex) {
+                LOGGER_ERROR("endpoint::call() failed: {}", ex.what());
+                m_breaker->record_failure(m_address);
+            }
+        }
+
+        return std::nullopt;
+    }
+
     mutable thallium::engine m_engine;
     thallium::endpoint m_endpoint;
+    std::string m_address;
+    std::shared_ptr<procedure_cache> m_procedures;
+    std::shared_ptr<call_policies> m_policies;
+    std::shared_ptr<circuit_breaker> m_breaker;
 };
 
 } // namespace network
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef NETWORK_ENDPOINT_CACHE_HPP
+#define NETWORK_ENDPOINT_CACHE_HPP
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <thallium.hpp>
+
+namespace network {
+
+/**
+ * A thread-safe cache of resolved endpoints keyed by address.
+ *
+ * Resolving an address in Mercury is not free, and most of our peers (e.g.
+ * scord-ctl, Cargo or the scord server itself) are contacted over and over
+ * again. Entries expire after a configurable TTL and can also be explicitly
+ * invalidated (e.g. when an RPC to them fails) so that the next lookup
+ * forces a fresh address resolution.
+ */
+class endpoint_cache {
+
+    using clock = std::chrono::steady_clock;
+
+    struct entry {
+        thallium::endpoint m_endpoint;
+        clock::time_point m_expiration;
+    };
+
+public:
+    static constexpr std::chrono::seconds default_ttl{60};
+
+    explicit endpoint_cache(clock::duration ttl = default_ttl) : m_ttl(ttl) {}
+
+    std::optional<thallium::endpoint>
+    find(const std::string& address) {
+
+        std::lock_guard lock(m_mutex);
+
+        const auto it = m_entries.find(address);
+
+        if(it == m_entries.end()) {
+            return std::nullopt;
+        }
+
+        if(clock::now() >= it->second.m_expiration) {
+            m_entries.erase(it);
+            return std::nullopt;
+        }
+
+        return it->second.m_endpoint;
+    }
+
+    void
+    insert(const std::string& address, const thallium::endpoint& endp) {
+        std::lock_guard lock(m_mutex);
+        m_entries.insert_or_assign(address,
+                                   entry{endp, clock::now() + m_ttl});
+    }
+
+    void
+    invalidate(const std::string& address) {
+        std::lock_guard lock(m_mutex);
+        m_entries.erase(address);
+    }
+
+    void
+    clear() {
+        std::lock_guard lock(m_mutex);
+        m_entries.clear();
+    }
+
+private:
+    clock::duration m_ttl;
+    std::mutex m_mutex;
+    std::unordered_map<std::string, entry> m_entries;
+};
+
+} // namespace network
+
+#endif // NETWORK_ENDPOINT_CACHE_HPP
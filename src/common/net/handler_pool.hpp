@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef NETWORK_HANDLER_POOL_HPP
+#define NETWORK_HANDLER_POOL_HPP
+
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <thallium.hpp>
+
+namespace network {
+
+/**
+ * A named Argobots pool together with the execution streams that serve it.
+ *
+ * RPCs defined with a handler pool have their handler ULTs pushed to it
+ * rather than to the engine's default handler pool, which allows isolating
+ * classes of RPCs from each other (e.g. so that cheap queries are not stuck
+ * behind handlers that block for a long time).
+ */
+class handler_pool {
+
+public:
+    handler_pool(std::string name, std::size_t num_xstreams)
+        : m_name(std::move(name)),
+          m_pool(thallium::pool::create(thallium::pool::access::mpmc)) {
+
+        m_xstreams.reserve(num_xstreams);
+
+        for(std::size_t i = 0; i < num_xstreams; ++i) {
+            m_xstreams.emplace_back(thallium::xstream::create(
+                    thallium::scheduler::predef::deflt, *m_pool));
+        }
+    }
+
+    // ULTs created by `spawn()` refer to the pool, which thus cannot move
+    handler_pool(const handler_pool&) = delete;
+    handler_pool(handler_pool&&) = delete;
+    handler_pool&
+    operator=(const handler_pool&) = delete;
+    handler_pool&
+    operator=(handler_pool&&) = delete;
+
+    ~handler_pool() {
+        join();
+    }
+
+    const std::string&
+    name() const {
+        return m_name;
+    }
+
+    std::size_t
+    size() const {
+        return m_xstreams.size();
+    }
+
+    const thallium::pool&
+    pool() const {
+        return *m_pool;
+    }
+
+    /**
+     * Run `f` in a background ULT served by this pool. Such ULTs are not
+     * joined individually: use `join_spawned()` to wait for all of them.
+     */
+    template <typename F>
+    void
+    spawn(F&& f) {
+
+        {
+            std::lock_guard lock(m_spawned_mutex);
+            ++m_spawned;
+        }
+
+        m_pool->make_thread(
+                [this, f = std::forward<F>(f)]() mutable {
+                    f();
+
+                    std::lock_guard lock(m_spawned_mutex);
+                    if(--m_spawned == 0) {
+                        m_spawned_cv.notify_all();
+                    }
+                },
+                thallium::anonymous{});
+    }
+
+    /**
+     * Block the calling ULT until all the ULTs created by `spawn()` have
+     * completed.
+     */
+    void
+    join_spawned() {
+        std::unique_lock lock(m_spawned_mutex);
+        while(m_spawned != 0) {
+            m_spawned_cv.wait(lock);
+        }
+    }
+
+    /**
+     * Wait for all execution streams to complete any pending handlers and
+     * release them. This must be done once the engine has been finalized.
+     */
+    void
+    join() {
+        for(auto& xstream : m_xstreams) {
+            xstream->join();
+        }
+        m_xstreams.clear();
+    }
+
+private:
+    std::string m_name;
+    thallium::managed<thallium::pool> m_pool;
+    std::vector<thallium::managed<thallium::xstream>> m_xstreams;
+    thallium::mutex m_spawned_mutex;
+    thallium::condition_variable m_spawned_cv;
+    std::size_t m_spawned = 0;
+};
+
+} // namespace network
+
+#endif // NETWORK_HANDLER_POOL_HPP
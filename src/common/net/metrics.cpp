@@ -0,0 +1,295 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <fmt/format.h>
+#include <logger/logger.hpp>
+#include "metrics.hpp"
+
+namespace {
+
+// bounds (in microseconds) of the exported histogram buckets: every power
+// of 4 from 64us to ~71min. These are a subset of the histogram's own
+// bucket boundaries, so exported counts are exact.
+constexpr unsigned min_exported_exponent = 6;
+constexpr unsigned max_exported_exponent = 32;
+constexpr unsigned exported_exponent_step = 2;
+
+// quantiles exported for each RPC, computed from the full histogram
+constexpr std::array exported_quantiles = {0.5, 0.9, 0.99};
+
+constexpr double
+to_seconds(std::uint64_t us) {
+    return static_cast<double>(us) / 1e6;
+}
+
+void
+print_header(std::string& out, const std::string& name, std::string_view type,
+             std::string_view help) {
+    fmt::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n",
+                   name, help, name, type);
+}
+
+} // namespace
+
+namespace network::metrics {
+
+std::size_t
+histogram::bucket_index(std::uint64_t value) noexcept {
+
+    if(value < sub_buckets) {
+        return value;
+    }
+
+    const unsigned msb = std::bit_width(value) - 1;
+
+    if(msb >= max_exponent) {
+        return num_buckets - 1;
+    }
+
+    // the top `sub_bucket_bits + 1` bits of the value select the bucket
+    // within its power of two
+    const unsigned shift = msb - sub_bucket_bits;
+    return shift * sub_buckets + (value >> shift);
+}
+
+std::uint64_t
+histogram::bucket_upper_bound(std::size_t index) noexcept {
+
+    if(index < 2 * sub_buckets) {
+        return index + 1;
+    }
+
+    const auto shift = index / sub_buckets - 1;
+    const auto mantissa = index % sub_buckets + sub_buckets;
+    return (mantissa + 1) << shift;
+}
+
+void
+histogram::record(std::uint64_t value) noexcept {
+    m_buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t
+histogram::count() const noexcept {
+    return m_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+histogram::sum() const noexcept {
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+histogram::count_below(std::uint64_t bound) const noexcept {
+
+    std::uint64_t n = 0;
+
+    for(std::size_t i = 0;
+        i < num_buckets && bucket_upper_bound(i) <= bound; ++i) {
+        n += m_buckets[i].load(std::memory_order_relaxed);
+    }
+
+    return n;
+}
+
+std::uint64_t
+histogram::quantile(double q) const noexcept {
+
+    // buckets may be updated while we iterate, so rely on their own
+    // counts rather than on `m_count`
+    std::array<std::uint64_t, num_buckets> counts;
+    std::uint64_t total = 0;
+
+    for(std::size_t i = 0; i < num_buckets; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    if(total == 0) {
+        return 0;
+    }
+
+    const auto rank = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(
+                       std::ceil(q * static_cast<double>(total))));
+
+    std::uint64_t seen = 0;
+
+    for(std::size_t i = 0; i < num_buckets; ++i) {
+        seen += counts[i];
+        if(seen >= rank) {
+            return bucket_upper_bound(i) - 1;
+        }
+    }
+
+    return bucket_upper_bound(num_buckets - 1) - 1;
+}
+
+rpc_timer::~rpc_timer() {
+
+    using namespace std::chrono;
+
+    const auto elapsed =
+            duration_cast<microseconds>(steady_clock::now() - m_start);
+
+    m_metrics.requests.fetch_add(1, std::memory_order_relaxed);
+
+    if(std::uncaught_exceptions() > m_exceptions) {
+        m_metrics.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_metrics.latency.record(elapsed.count());
+    m_metrics.in_flight.add(-1);
+}
+
+registry::registry(std::string prefix) : m_prefix(std::move(prefix)) {}
+
+rpc_metrics&
+registry::add_rpc(const std::string& name) {
+    std::lock_guard lock(m_mutex);
+    return *m_rpcs.emplace_back(std::make_unique<rpc_metrics>(name));
+}
+
+void
+registry::add_gauge(std::string name, std::string help,
+                    std::function<double()> collect) {
+    std::lock_guard lock(m_mutex);
+    m_gauges.push_back(gauge_info{fmt::format("{}_{}", m_prefix, name),
+                                  std::move(help), std::move(collect)});
+}
+
+std::string
+registry::to_prometheus() const {
+
+    std::lock_guard lock(m_mutex);
+
+    std::string out;
+    auto it = std::back_inserter(out);
+
+    const auto requests = fmt::format("{}_rpc_requests_total", m_prefix);
+    print_header(out, requests, "counter", "Requests handled, per RPC.");
+    for(const auto& rpc : m_rpcs) {
+        fmt::format_to(it, "{}{{rpc=\"{}\"}} {}\n", requests, rpc->name,
+                       rpc->requests.load(std::memory_order_relaxed));
+    }
+
+    const auto failures = fmt::format("{}_rpc_failures_total", m_prefix);
+    print_header(out, failures, "counter",
+                 "Requests whose handler raised an exception, per RPC.");
+    for(const auto& rpc : m_rpcs) {
+        fmt::format_to(it, "{}{{rpc=\"{}\"}} {}\n", failures, rpc->name,
+                       rpc->failures.load(std::memory_order_relaxed));
+    }
+
+    const auto rejected = fmt::format("{}_rpc_rejected_total", m_prefix);
+    print_header(out, rejected, "counter",
+                 "Requests rejected without running their handler, per RPC.");
+    for(const auto& rpc : m_rpcs) {
+        fmt::format_to(it, "{}{{rpc=\"{}\"}} {}\n", rejected, rpc->name,
+                       rpc->rejected.load(std::memory_order_relaxed));
+    }
+
+    const auto in_flight = fmt::format("{}_rpc_in_flight", m_prefix);
+    print_header(out, in_flight, "gauge",
+                 "Requests currently being handled, per RPC.");
+    for(const auto& rpc : m_rpcs) {
+        fmt::format_to(it, "{}{{rpc=\"{}\"}} {}\n", in_flight, rpc->name,
+                       rpc->in_flight.value());
+    }
+
+    const auto duration = fmt::format("{}_rpc_duration_seconds", m_prefix);
+    print_header(out, duration, "histogram",
+                 "Time spent in the RPC handler, per RPC.");
+    for(const auto& rpc : m_rpcs) {
+        const auto& h = rpc->latency;
+        for(auto e = min_exported_exponent; e <= max_exported_exponent;
+            e += exported_exponent_step) {
+            const auto bound = std::uint64_t{1} << e;
+            fmt::format_to(it, "{}_bucket{{rpc=\"{}\",le=\"{}\"}} {}\n",
+                           duration, rpc->name, to_seconds(bound),
+                           h.count_below(bound));
+        }
+        fmt::format_to(it, "{}_bucket{{rpc=\"{}\",le=\"+Inf\"}} {}\n",
+                       duration, rpc->name, h.count());
+        fmt::format_to(it, "{}_sum{{rpc=\"{}\"}} {}\n", duration, rpc->name,
+                       to_seconds(h.sum()));
+        fmt::format_to(it, "{}_count{{rpc=\"{}\"}} {}\n", duration, rpc->name,
+                       h.count());
+    }
+
+    const auto quantiles =
+            fmt::format("{}_rpc_duration_quantile_seconds", m_prefix);
+    print_header(out, quantiles, "gauge",
+                 "Quantiles of the time spent in the RPC handler, per RPC.");
+    for(const auto& rpc : m_rpcs) {
+        for(const auto q : exported_quantiles) {
+            fmt::format_to(it, "{}{{rpc=\"{}\",quantile=\"{}\"}} {}\n",
+                           quantiles, rpc->name, q,
+                           to_seconds(rpc->latency.quantile(q)));
+        }
+    }
+
+    for(const auto& g : m_gauges) {
+        print_header(out, g.name, "gauge", g.help);
+        fmt::format_to(it, "{} {}\n", g.name, g.collect());
+    }
+
+    return out;
+}
+
+bool
+registry::write_textfile(const std::filesystem::path& path) const {
+
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream ofs{tmp_path, std::ios::trunc};
+        ofs << to_prometheus();
+
+        if(!ofs.flush()) {
+            LOGGER_ERROR("Failed to write metrics to {}", tmp_path.string());
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+
+    if(ec) {
+        LOGGER_ERROR("Failed to write metrics to {}: {}", path.string(),
+                     ec.message());
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace network::metrics
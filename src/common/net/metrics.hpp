@@ -0,0 +1,246 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#ifndef NETWORK_METRICS_HPP
+#define NETWORK_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace network::metrics {
+
+/**
+ * A latency histogram with log-linear buckets, in the style of HDR
+ * histograms: each power of two is split into `sub_buckets` buckets, so
+ * that any recorded value is off by at most 1/`sub_buckets` regardless of
+ * its magnitude. Values are in microseconds. Recording a value only
+ * involves relaxed atomic increments.
+ */
+class histogram {
+
+public:
+    static constexpr unsigned sub_bucket_bits = 3;
+    static constexpr std::uint64_t sub_buckets = 1u << sub_bucket_bits;
+    // values of 2^max_exponent microseconds (~12 days) or larger go into
+    // the last bucket
+    static constexpr unsigned max_exponent = 40;
+    static constexpr std::size_t num_buckets =
+            (max_exponent - sub_bucket_bits + 1) * sub_buckets;
+
+    void
+    record(std::uint64_t value) noexcept;
+
+    std::uint64_t
+    count() const noexcept;
+
+    std::uint64_t
+    sum() const noexcept;
+
+    /**
+     * Number of recorded values strictly lower than `bound`, which must be
+     * a power of two.
+     */
+    std::uint64_t
+    count_below(std::uint64_t bound) const noexcept;
+
+    /**
+     * Approximate value at quantile `q` (in [0, 1]), or 0 if no values
+     * have been recorded.
+     */
+    std::uint64_t
+    quantile(double q) const noexcept;
+
+    static std::size_t
+    bucket_index(std::uint64_t value) noexcept;
+
+    // exclusive upper bound of the values in bucket `index`
+    static std::uint64_t
+    bucket_upper_bound(std::size_t index) noexcept;
+
+private:
+    std::array<std::atomic<std::uint64_t>, num_buckets> m_buckets{};
+    std::atomic<std::uint64_t> m_count{0};
+    std::atomic<std::uint64_t> m_sum{0};
+};
+
+/**
+ * A value that can go up and down, such as the number of calls in flight.
+ */
+class gauge {
+
+public:
+    void
+    set(double value) noexcept {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+
+    void
+    add(double value) noexcept {
+        m_value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    double
+    value() const noexcept {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<double> m_value{0};
+};
+
+/**
+ * Increments a gauge for as long as it is in scope.
+ */
+class scoped_increment {
+
+public:
+    explicit scoped_increment(gauge& g) noexcept : m_gauge(g) {
+        m_gauge.add(1);
+    }
+
+    scoped_increment(const scoped_increment&) = delete;
+    scoped_increment&
+    operator=(const scoped_increment&) = delete;
+
+    ~scoped_increment() {
+        m_gauge.add(-1);
+    }
+
+private:
+    gauge& m_gauge;
+};
+
+/**
+ * The metrics kept for each RPC handler.
+ */
+struct rpc_metrics {
+
+    explicit rpc_metrics(std::string name) : name(std::move(name)) {}
+
+    const std::string name;
+    // requests handled and requests whose handler exited with an exception
+    std::atomic<std::uint64_t> requests{0};
+    std::atomic<std::uint64_t> failures{0};
+    // requests rejected without running the handler (e.g. rate limited)
+    std::atomic<std::uint64_t> rejected{0};
+    gauge in_flight;
+    histogram latency;
+};
+
+/**
+ * Times a call to an RPC handler and updates its metrics when it goes out
+ * of scope.
+ */
+class rpc_timer {
+
+public:
+    explicit rpc_timer(rpc_metrics& metrics) noexcept
+        : m_metrics(metrics), m_exceptions(std::uncaught_exceptions()),
+          m_start(std::chrono::steady_clock::now()) {
+        m_metrics.in_flight.add(1);
+    }
+
+    rpc_timer(const rpc_timer&) = delete;
+    rpc_timer&
+    operator=(const rpc_timer&) = delete;
+
+    ~rpc_timer();
+
+private:
+    rpc_metrics& m_metrics;
+    int m_exceptions;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * The set of metrics exported by a daemon. RPC metrics and gauges must be
+ * registered before they are updated, typically when RPC handlers are
+ * defined, so that updating them does not need to look anything up.
+ */
+class registry {
+
+public:
+    /**
+     * @param prefix Prefix for the names of all exported metrics (e.g.
+     * "scord" results in "scord_rpc_requests_total").
+     */
+    explicit registry(std::string prefix);
+
+    /**
+     * Register the metrics for RPC `name`. The returned reference remains
+     * valid for the lifetime of the registry.
+     */
+    rpc_metrics&
+    add_rpc(const std::string& name);
+
+    /**
+     * Register a gauge whose value is obtained by calling `collect` each
+     * time the metrics are exported.
+     */
+    void
+    add_gauge(std::string name, std::string help,
+              std::function<double()> collect);
+
+    /**
+     * Export all metrics in the Prometheus text exposition format.
+     */
+    std::string
+    to_prometheus() const;
+
+    /**
+     * Export all metrics into `path` in the Prometheus text exposition
+     * format. The file is replaced atomically so that collectors such as
+     * node-exporter's textfile collector never read a partial file.
+     *
+     * @return true if the file could be written, false otherwise.
+     */
+    bool
+    write_textfile(const std::filesystem::path& path) const;
+
+private:
+    struct gauge_info {
+        std::string name;
+        std::string help;
+        std::function<double()> collect;
+    };
+
+    std::string m_prefix;
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<rpc_metrics>> m_rpcs;
+    std::vector<gauge_info> m_gauges;
+};
+
+} // namespace network::metrics
+
+#endif // NETWORK_METRICS_HPP
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef NETWORK_PROCEDURE_CACHE_HPP
+#define NETWORK_PROCEDURE_CACHE_HPP
+
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <thallium.hpp>
+
+namespace network {
+
+/**
+ * A thread-safe table of the remote procedures defined in an engine.
+ *
+ * Calling `thallium::engine::define()` requires querying Mercury for the
+ * RPC registration and building a new `thallium::remote_procedure`. Since
+ * the set of RPCs that a process invokes is small and fixed, this cache
+ * defines each procedure the first time it is used and hands out the same
+ * handle afterwards.
+ */
+class procedure_cache {
+
+public:
+    explicit procedure_cache(thallium::engine engine)
+        : m_engine(std::move(engine)) {}
+
+    /**
+     * Return the remote procedure for `rpc_name`, defining it in the
+     * engine if this is the first time it is requested.
+     *
+     * N.B. References remain valid for the lifetime of the cache since
+     * entries are never removed.
+     */
+    const thallium::remote_procedure&
+    get(const std::string& rpc_name) {
+
+        {
+            std::shared_lock lock(m_mutex);
+
+            if(const auto it = m_procedures.find(rpc_name);
+               it != m_procedures.end()) {
+                return it->second;
+            }
+        }
+
+        std::unique_lock lock(m_mutex);
+
+        if(const auto it = m_procedures.find(rpc_name);
+           it != m_procedures.end()) {
+            return it->second;
+        }
+
+        return m_procedures.emplace(rpc_name, m_engine.define(rpc_name))
+                .first->second;
+    }
+
+private:
+    thallium::engine m_engine;
+    std::shared_mutex m_mutex;
+    std::unordered_map<std::string, thallium::remote_procedure> m_procedures;
+};
+
+} // namespace network
+
+#endif // NETWORK_PROCEDURE_CACHE_HPP
@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#ifndef NETWORK_RATE_LIMITER_HPP
+#define NETWORK_RATE_LIMITER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace network {
+
+/**
+ * The parameters of a token bucket: requests are admitted at a sustained
+ * `rate` per second, with bursts of up to `burst` requests.
+ */
+struct rate_limit {
+    double rate;
+    double burst;
+};
+
+/**
+ * Thread-safe admission control for incoming requests, based on token
+ * buckets. A request is admitted only if both the bucket for its RPC and
+ * the bucket for the client that sent it have a token available. Requests
+ * for RPCs without a configured limit are only limited per client, and
+ * clients are not limited unless a per-client limit is configured.
+ */
+class rate_limiter {
+
+    using clock = std::chrono::steady_clock;
+
+    class token_bucket {
+
+    public:
+        explicit token_bucket(const rate_limit& limit)
+            : m_limit(limit), m_tokens(limit.burst), m_last(clock::now()) {}
+
+        // refill the bucket and return how long it will take until a token
+        // is available (zero if one already is)
+        clock::duration
+        wait_time(clock::time_point now) {
+
+            // `now` may predate the creation of the bucket, e.g. if it was
+            // created by the same `admit()` call that sampled `now`
+            if(now > m_last) {
+                const std::chrono::duration<double> elapsed = now - m_last;
+                m_tokens = std::min(m_limit.burst,
+                                    m_tokens + elapsed.count() * m_limit.rate);
+                m_last = now;
+            }
+
+            if(m_tokens >= 1.0) {
+                return clock::duration::zero();
+            }
+
+            return std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>((1.0 - m_tokens) /
+                                                  m_limit.rate));
+        }
+
+        void
+        take() {
+            m_tokens -= 1.0;
+        }
+
+        bool
+        full() const {
+            return m_tokens >= m_limit.burst;
+        }
+
+    private:
+        rate_limit m_limit;
+        double m_tokens;
+        clock::time_point m_last;
+    };
+
+public:
+    // once this many clients are tracked, the buckets of clients that have
+    // been idle long enough to refill are discarded
+    static constexpr std::size_t max_tracked_clients = 16384;
+
+    void
+    set_rpc_limit(const std::string& rpc_name, const rate_limit& limit) {
+        std::lock_guard lock(m_mutex);
+        m_rpc_buckets.insert_or_assign(rpc_name, token_bucket{limit});
+        m_active = true;
+    }
+
+    void
+    set_client_limit(const rate_limit& limit) {
+        std::lock_guard lock(m_mutex);
+        m_client_limit = limit;
+        m_client_buckets.clear();
+        m_active = true;
+    }
+
+    /**
+     * Whether any limit has been configured. If not, there is no need to
+     * call `admit()`.
+     */
+    bool
+    active() const noexcept {
+        return m_active.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Decide whether to serve a request for `rpc_name` from `address`.
+     *
+     * @return std::nullopt if the request is admitted, or otherwise the
+     * time after which the client can expect a retry to be admitted.
+     */
+    std::optional<clock::duration>
+    admit(const std::string& rpc_name, const std::string& address) {
+
+        std::lock_guard lock(m_mutex);
+
+        const auto now = clock::now();
+        auto wait = clock::duration::zero();
+
+        token_bucket* rpc_bucket = nullptr;
+        token_bucket* client_bucket = nullptr;
+
+        if(const auto it = m_rpc_buckets.find(rpc_name);
+           it != m_rpc_buckets.end()) {
+            rpc_bucket = &it->second;
+            wait = std::max(wait, rpc_bucket->wait_time(now));
+        }
+
+        if(m_client_limit) {
+            if(m_client_buckets.size() >= max_tracked_clients) {
+                for(auto it = m_client_buckets.begin();
+                    it != m_client_buckets.end();) {
+                    it->second.wait_time(now);
+                    it = it->second.full() ? m_client_buckets.erase(it)
+                                           : std::next(it);
+                }
+            }
+
+            client_bucket = &m_client_buckets
+                                     .try_emplace(address, *m_client_limit)
+                                     .first->second;
+            wait = std::max(wait, client_bucket->wait_time(now));
+        }
+
+        if(wait > clock::duration::zero()) {
+            return wait;
+        }
+
+        if(rpc_bucket) {
+            rpc_bucket->take();
+        }
+
+        if(client_bucket) {
+            client_bucket->take();
+        }
+
+        return std::nullopt;
+    }
+
+private:
+    std::atomic<bool> m_active = false;
+    std::mutex m_mutex;
+    std::unordered_map<std::string, token_bucket> m_rpc_buckets;
+    std::optional<rate_limit> m_client_limit;
+    std::unordered_map<std::string, token_bucket> m_client_buckets;
+};
+
+} // namespace network
+
+#endif // NETWORK_RATE_LIMITER_HPP
@@ -25,6 +25,7 @@
 #ifndef NETWORK_REQUEST_HPP
 #define NETWORK_REQUEST_HPP
 
+#include <chrono>
 #include <thallium.hpp>
 #include <scord/types.hpp>
 
@@ -46,6 +47,11 @@ public:
                                scord::error_code ec) noexcept
         : m_op_id(op_id), m_error_code(ec) {}
 
+    constexpr generic_response(std::uint64_t op_id, scord::error_code ec,
+                               std::chrono::milliseconds retry_after) noexcept
+        : m_op_id(op_id), m_error_code(ec),
+          m_retry_after_ms(static_cast<std::uint32_t>(retry_after.count())) {}
+
     constexpr std::uint64_t
     op_id() const noexcept {
         return m_op_id;
@@ -56,16 +62,27 @@ public:
         return m_error_code;
     }
 
+    /**
+     * For requests rejected with `error_code::busy`, how long the client
+     * should wait before retrying.
+     */
+    constexpr std::chrono::milliseconds
+    retry_after() const noexcept {
+        return std::chrono::milliseconds{m_retry_after_ms};
+    }
+
     template <typename Archive>
     constexpr void
     serialize(Archive&& ar) {
         ar& m_op_id;
         ar& m_error_code;
+        ar& m_retry_after_ms;
     }
 
 private:
     std::uint64_t m_op_id;
     scord::error_code m_error_code;
+    std::uint32_t m_retry_after_ms = 0;
 };
 
 template <typename Value>
@@ -87,8 +104,10 @@ public:
                                   std::optional<Value> value) noexcept
         : generic_response(op_id, ec), m_value(std::move(value)) {}
 
+    // throws std::bad_optional_access if the response carries no value,
+    // e.g. if the request failed: check `error_code()` first
     constexpr auto
-    value() const noexcept {
+    value() const {
         return m_value.value();
     }
 
@@ -119,6 +138,29 @@ private:
 
 using response_with_id = response_with_value<std::uint64_t>;
 
+/**
+ * The response to a request rejected before its handler ran. It is
+ * serialized like a `response_with_value<T>` that holds no value, so that
+ * the client can read it as a `generic_response` or as any
+ * `response_with_value<T>`, regardless of the RPC.
+ */
+class rejected_response : public generic_response {
+
+public:
+    constexpr rejected_response(std::uint64_t op_id, scord::error_code ec,
+                                std::chrono::milliseconds retry_after) noexcept
+        : generic_response(op_id, ec, retry_after) {}
+
+    template <typename Archive>
+    constexpr void
+    serialize(Archive&& ar) {
+        ar(cereal::base_class<generic_response>(this), m_value);
+    }
+
+private:
+    std::optional<bool> m_value;
+};
+
 } // namespace network
 
 #endif // NETWORK_REQUEST_HPP
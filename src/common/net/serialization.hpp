@@ -45,14 +45,14 @@ inline void
 CEREAL_LOAD_FUNCTION_NAME(Archive& ar, std::filesystem::path& out) {
     std::string tmp;
     ar(CEREAL_NVP_("data", tmp));
-    out.assign(tmp);
+    out = std::filesystem::path{std::move(tmp)};
 }
 
 //! Saving for std::filesystem::path
 template <class Archive>
 inline void
 CEREAL_SAVE_FUNCTION_NAME(Archive& ar, const std::filesystem::path& in) {
-    ar(CEREAL_NVP_("data", in.string()));
+    ar(CEREAL_NVP_("data", in.native()));
 }
 
 } // namespace cereal
@@ -42,6 +42,7 @@
 #include <utils/signal_listener.hpp>
 #include "server.hpp"
 #include "endpoint.hpp"
+#include "transport.hpp"
 
 using namespace std::literals;
 
@@ -84,14 +85,25 @@ namespace network {
 
 server::server(std::string name, std::string address, bool daemonize,
                std::filesystem::path rundir,
-               std::optional<std::filesystem::path> pidfile)
+               std::optional<std::filesystem::path> pidfile,
+               bool shared_memory)
 
     : m_name(std::move(name)), m_address(std::move(address)),
       m_daemonize(daemonize), m_rundir(std::move(rundir)),
       m_pidfile(daemonize ? std::make_optional(m_rundir / (m_name + ".pid"))
                           : std::move(pidfile)),
       m_logger_config(m_name, logger::logger_type::console_color),
-      m_network_engine(m_address, THALLIUM_SERVER_MODE) {}
+      m_shared_memory(shared_memory),
+      m_network_engine(make_engine(m_address, THALLIUM_SERVER_MODE, false,
+                                   shared_memory)),
+      m_procedures(std::make_shared<procedure_cache>(m_network_engine)),
+      m_policies(std::make_shared<call_policies>()),
+      m_breaker(std::make_shared<circuit_breaker>()) {
+
+    // cached endpoints must be released before Margo is finalized
+    m_network_engine.push_prefinalize_callback(
+            [this]() { m_endpoint_cache.clear(); });
+}
 
 server::~server() = default;
 
@@ -273,6 +285,8 @@ server::print_configuration() const {
     }
 
     LOGGER_INFO("  - address for remote requests: {}", self_address());
+    LOGGER_INFO("  - shared memory for local requests?: {}",
+                m_shared_memory ? "yes" : "no");
     LOGGER_INFO("");
 }
 
@@ -289,13 +303,35 @@ server::print_farewell() {
 std::optional<endpoint>
 server::lookup(const std::string& address) noexcept {
     try {
-        return endpoint{m_network_engine, m_network_engine.lookup(address)};
+        if(auto endp = m_endpoint_cache.find(address); endp.has_value()) {
+            return endpoint{m_network_engine, std::move(*endp),
+                            m_procedures, m_policies, m_breaker};
+        }
+
+        auto endp = m_network_engine.lookup(address);
+        m_endpoint_cache.insert(address, endp);
+        return endpoint{m_network_engine, std::move(endp), m_procedures,
+                        m_policies, m_breaker};
     } catch(const std::exception& ex) {
         LOGGER_ERROR("server::lookup() failed: {}", ex.what());
         return std::nullopt;
     }
 }
 
+void
+server::invalidate(const std::string& address) noexcept {
+    try {
+        m_endpoint_cache.invalidate(address);
+    } catch(const std::exception& ex) {
+        LOGGER_ERROR("server::invalidate() failed: {}", ex.what());
+    }
+}
+
+call_policies&
+server::policies() noexcept {
+    return *m_policies;
+}
+
 std::string
 server::self_address() const noexcept {
     try {
@@ -306,6 +342,11 @@ server::self_address() const noexcept {
     }
 }
 
+const std::string&
+server::listen_address() const noexcept {
+    return m_address;
+}
+
 int
 server::run() {
 
@@ -32,6 +32,10 @@
 #include <thallium.hpp>
 #include <thallium/serialization/stl/string.hpp>
 #include <thallium/serialization/stl/vector.hpp>
+#include "call_policy.hpp"
+#include "circuit_breaker.hpp"
+#include "endpoint_cache.hpp"
+#include "procedure_cache.hpp"
 
 namespace network {
 
@@ -47,7 +51,8 @@ class server {
 public:
     server(std::string name, std::string address, bool daemonize,
            std::filesystem::path rundir,
-           std::optional<std::filesystem::path> pidfile = {});
+           std::optional<std::filesystem::path> pidfile = {},
+           bool shared_memory = true);
 
     ~server();
 
@@ -61,9 +66,28 @@ public:
     std::optional<endpoint>
     lookup(const std::string& address) noexcept;
 
+    void
+    invalidate(const std::string& address) noexcept;
+
+    /**
+     * The policies (deadlines, retries) applied to outbound RPCs issued
+     * through endpoints returned by `lookup()`.
+     */
+    call_policies&
+    policies() noexcept;
+
     std::string
     self_address() const noexcept;
 
+    /**
+     * The address the server was configured to listen on. Unlike
+     * `self_address()`, it is exactly as given by the user, i.e. it is not
+     * rewritten by Mercury (e.g. into a composite address when shared
+     * memory is enabled).
+     */
+    const std::string&
+    listen_address() const noexcept;
+
     int
     run();
     void
@@ -107,12 +131,17 @@ private:
     std::filesystem::path m_rundir;
     std::optional<std::filesystem::path> m_pidfile;
     logger::logger_config m_logger_config;
+    bool m_shared_memory;
 
 protected:
     thallium::engine m_network_engine;
     std::atomic<bool> m_shutting_down;
 
 private:
+    std::shared_ptr<procedure_cache> m_procedures;
+    std::shared_ptr<call_policies> m_policies;
+    std::shared_ptr<circuit_breaker> m_breaker;
+    endpoint_cache m_endpoint_cache;
     scord::utils::signal_listener m_signal_listener;
 };
 
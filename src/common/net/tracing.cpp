@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <logger/logger.hpp>
+#include "tracing.hpp"
+
+namespace {
+
+// records are buffered by stdio so that writing a span does not usually
+// involve a system call
+constexpr std::size_t buffer_size = 1024 * sizeof(network::tracing::record);
+
+std::mutex trace_mutex;
+std::FILE* trace_file = nullptr;
+std::atomic<bool> trace_enabled = false;
+
+} // namespace
+
+namespace network::tracing {
+
+bool
+enable(const std::filesystem::path& path) {
+
+    std::lock_guard lock(trace_mutex);
+
+    if(trace_file != nullptr) {
+        std::fclose(trace_file);
+        trace_file = nullptr;
+        trace_enabled = false;
+    }
+
+    trace_file = std::fopen(path.c_str(), "wb");
+
+    if(trace_file == nullptr) {
+        LOGGER_ERROR("Failed to open trace file {}: {}", path.string(),
+                     std::strerror(errno));
+        return false;
+    }
+
+    std::setvbuf(trace_file, nullptr, _IOFBF, buffer_size);
+
+    const file_header header;
+
+    if(std::fwrite(&header, sizeof(header), 1, trace_file) != 1) {
+        LOGGER_ERROR("Failed to write trace file {}: {}", path.string(),
+                     std::strerror(errno));
+        std::fclose(trace_file);
+        trace_file = nullptr;
+        return false;
+    }
+
+    // flush the header right away so that it is not written twice if the
+    // process forks (e.g. to daemonize) with it still in the buffer
+    std::fflush(trace_file);
+
+    trace_enabled = true;
+    return true;
+}
+
+void
+disable() {
+
+    std::lock_guard lock(trace_mutex);
+
+    trace_enabled = false;
+
+    if(trace_file != nullptr) {
+        std::fclose(trace_file);
+        trace_file = nullptr;
+    }
+}
+
+bool
+enabled() noexcept {
+    return trace_enabled.load(std::memory_order_relaxed);
+}
+
+void
+write(const record& r) {
+
+    std::lock_guard lock(trace_mutex);
+
+    if(trace_file != nullptr) {
+        std::fwrite(&r, sizeof(r), 1, trace_file);
+    }
+}
+
+span::~span() {
+
+    if(!enabled()) {
+        return;
+    }
+
+    using namespace std::chrono;
+
+    const auto start = m_rpc.start_time();
+    const auto trace = m_rpc.trace();
+
+    record r{};
+    r.trace_id = trace.trace_id;
+    r.span_id = trace.span_id;
+    r.parent_span_id = m_rpc.parent_span_id();
+    r.start_ns = duration_cast<nanoseconds>(start.time_since_epoch()).count();
+    r.duration_ns =
+            duration_cast<nanoseconds>(system_clock::now() - start).count();
+    r.pid = static_cast<std::uint32_t>(::getpid());
+    r.tid = static_cast<std::uint32_t>(::syscall(SYS_gettid));
+
+    const auto& name = m_rpc.name();
+    const auto n = std::min(name.size(), sizeof(r.name) - 1);
+    std::memcpy(r.name, name.data(), n);
+    r.name[n] = '\0';
+
+    write(r);
+}
+
+} // namespace network::tracing
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#ifndef NETWORK_TRACING_HPP
+#define NETWORK_TRACING_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include "utilities.hpp"
+
+namespace network::tracing {
+
+/**
+ * A span as stored in a trace file. Trace files are a plain sequence of
+ * these records in host byte order, preceded by a `file_header`, so that
+ * recording a span is a single buffered write. Use `scord_trace2json` to
+ * convert them into the Chrome/Perfetto JSON trace format.
+ */
+struct record {
+    std::uint64_t trace_id;
+    std::uint64_t span_id;
+    std::uint64_t parent_span_id;
+    // start time (nanoseconds since the Unix epoch) and duration of the span
+    std::uint64_t start_ns;
+    std::uint64_t duration_ns;
+    std::uint32_t pid;
+    std::uint32_t tid;
+    // NUL-terminated (and possibly truncated) RPC name
+    char name[64];
+};
+
+static_assert(sizeof(record) == 112);
+
+struct file_header {
+    static constexpr std::uint64_t expected_magic = 0x3130434152544353;
+
+    std::uint64_t magic = expected_magic; // "SCTRAC01"
+    std::uint32_t record_size = sizeof(record);
+    std::uint32_t reserved = 0;
+};
+
+/**
+ * Start recording spans into `trace_file`, replacing any previous
+ * contents.
+ *
+ * @return true if the file could be opened, false otherwise.
+ */
+bool
+enable(const std::filesystem::path& trace_file);
+
+/**
+ * Stop recording spans and flush any buffered records.
+ */
+void
+disable();
+
+bool
+enabled() noexcept;
+
+void
+write(const record& r);
+
+/**
+ * A timed span for an RPC. The span starts when the `rpc_info` is created
+ * and is recorded when the `span` is destroyed. Spans are dropped unless
+ * tracing is enabled.
+ */
+class span {
+
+public:
+    explicit span(const rpc_info& rpc) : m_rpc(rpc) {}
+
+    span(const span&) = delete;
+    span&
+    operator=(const span&) = delete;
+
+    ~span();
+
+private:
+    const rpc_info& m_rpc;
+};
+
+} // namespace network::tracing
+
+#endif // NETWORK_TRACING_HPP
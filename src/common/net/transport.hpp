@@ -0,0 +1,57 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#ifndef NETWORK_TRANSPORT_HPP
+#define NETWORK_TRANSPORT_HPP
+
+#include <string>
+#include <thallium.hpp>
+
+namespace network {
+
+/**
+ * Create a network engine bound to `address` (for servers) or to the
+ * protocol in `address` (for clients).
+ *
+ * If `shared_memory` is set, Mercury's automatic shared-memory mode is
+ * enabled: the engine additionally listens on `na+sm`, and RPCs and bulk
+ * transfers between processes running on the same node are transparently
+ * routed through shared memory instead of the network protocol. Peers keep
+ * using the same addresses, since Mercury embeds the shared-memory address
+ * in them and picks the transport when they are looked up.
+ */
+inline thallium::engine
+make_engine(const std::string& address, int mode, bool use_progress_thread,
+            bool shared_memory) {
+
+    struct hg_init_info hg_opts = HG_INIT_INFO_INITIALIZER;
+    hg_opts.auto_sm = shared_memory ? HG_TRUE : HG_FALSE;
+
+    return thallium::engine{address, mode, use_progress_thread, 0, &hg_opts};
+}
+
+} // namespace network
+
+#endif // NETWORK_TRANSPORT_HPP
@@ -26,8 +26,10 @@
 #ifndef NETWORK_UTILITIES_HPP
 #define NETWORK_UTILITIES_HPP
 
+#include <chrono>
 #include <cstdint>
 #include <optional>
+#include <random>
 #include <string>
 #include <string_view>
 #include <atomic>
@@ -35,6 +37,25 @@
 
 namespace network {
 
+/**
+ * The tracing context propagated along with an RPC: the trace it belongs
+ * to and the span of the caller, so that the callee can record its own
+ * span as a child of it. A `trace_id` of 0 means that the caller did not
+ * provide a context, and the callee starts a new trace.
+ */
+struct trace_context {
+
+    template <typename Archive>
+    void
+    serialize(Archive&& ar) {
+        ar& trace_id;
+        ar& span_id;
+    }
+
+    std::uint64_t trace_id = 0;
+    std::uint64_t span_id = 0;
+};
+
 class rpc_info {
 private:
     static std::uint64_t
@@ -43,15 +64,40 @@ private:
         return s_current_id++;
     }
 
+    // trace and span ids must be unique across processes and are thus
+    // generated randomly rather than sequentially
+    static std::uint64_t
+    new_trace_id() {
+        thread_local std::mt19937_64 rng{std::random_device{}()};
+        std::uint64_t id;
+        do {
+            id = rng();
+        } while(id == 0);
+        return id;
+    }
+
 public:
     rpc_info(std::uint64_t id, std::string name, std::string address)
+        : rpc_info(id, std::move(name), std::move(address), trace_context{}) {}
+
+    rpc_info(std::uint64_t id, std::string name, std::string address,
+             const trace_context& parent)
         : m_id(id), m_children(0), m_name(std::move(name)),
-          m_address(std::move(address)) {}
+          m_address(std::move(address)),
+          m_trace_id(parent.trace_id != 0 ? parent.trace_id : new_trace_id()),
+          m_span_id(new_trace_id()), m_parent_span_id(parent.span_id),
+          m_start_time(std::chrono::system_clock::now()) {}
 
     rpc_info(std::uint64_t id, std::uint64_t pid, std::string name,
              std::string address)
-        : m_id(id), m_pid(pid), m_children(0), m_name(std::move(name)),
-          m_address(std::move(address)) {}
+        : rpc_info(id, pid, std::move(name), std::move(address),
+                   trace_context{}) {}
+
+    rpc_info(std::uint64_t id, std::uint64_t pid, std::string name,
+             std::string address, const trace_context& parent)
+        : rpc_info(id, std::move(name), std::move(address), parent) {
+        m_pid = pid;
+    }
 
     template <typename... Args>
     static rpc_info
@@ -59,10 +105,15 @@ public:
         return {new_id(), std::forward<Args>(args)...};
     }
 
-    template <typename... Args>
+    /**
+     * Create the `rpc_info` for an RPC issued while serving this one. The
+     * child belongs to the same trace and its span is recorded as a child
+     * of this RPC's span.
+     */
     rpc_info
-    add_child(std::string address) const {
-        return {m_children, m_id, m_name, std::move(address)};
+    add_child(std::string name, std::string address) const {
+        return {m_children++, m_id, std::move(name), std::move(address),
+                trace()};
     }
 
     constexpr std::uint64_t
@@ -85,12 +136,34 @@ public:
         return m_address;
     }
 
+    /**
+     * The context to propagate to the peer of this RPC.
+     */
+    trace_context
+    trace() const {
+        return {m_trace_id, m_span_id};
+    }
+
+    std::uint64_t
+    parent_span_id() const {
+        return m_parent_span_id;
+    }
+
+    std::chrono::system_clock::time_point
+    start_time() const {
+        return m_start_time;
+    }
+
 private:
     std::uint64_t m_id;
     std::optional<std::uint64_t> m_pid;
-    std::uint64_t m_children;
+    mutable std::uint64_t m_children;
     std::string m_name;
     std::string m_address;
+    std::uint64_t m_trace_id;
+    std::uint64_t m_span_id;
+    std::uint64_t m_parent_span_id;
+    std::chrono::system_clock::time_point m_start_time;
 };
 
 } // namespace network
@@ -26,9 +26,12 @@
 #include <scord/scord.hpp>
 #include <logger/logger.hpp>
 #include <stdarg.h>
+#include <algorithm>
+#include <functional>
 #include <scord/types.hpp>
 #include <scord/types.h>
 #include "detail/impl.hpp"
+#include "detail/async.hpp"
 
 namespace {
 
@@ -68,12 +71,76 @@ convert(uint64_t limit, size_t limits_len) {
     return rv;
 }
 
+/**
+ * Block until `transfer` is no longer queued or running.
+ *
+ * @return ADM_SUCCESS if the transfer finished, ADM_EOTHER if it failed or
+ * was cancelled, or the error that prevented waiting for it (e.g.
+ * ADM_ENOENT if the server does not know it).
+ */
+ADM_return_t
+wait_for_transfer(const scord::server& srv, const scord::job& job,
+                  const scord::transfer& transfer) {
+
+    using namespace std::chrono_literals;
+
+    while(true) {
+        const auto rv = scord::detail::wait_transfer(srv, job, transfer, 30s);
+
+        if(!rv) {
+            return rv.error();
+        }
+
+        switch(rv->status()) {
+            case scord::transfer_state::type::queued:
+            case scord::transfer_state::type::running:
+                continue;
+            case scord::transfer_state::type::finished:
+                return ADM_SUCCESS;
+            default:
+                return ADM_EOTHER;
+        }
+    }
+}
+
 } // namespace
 
 
 /******************************************************************************/
 /* C API implementation                                                       */
 /******************************************************************************/
+struct adm_session {
+    scord::session s_session;
+};
+
+ADM_session_t
+ADM_session_create(const char* protocol) {
+
+    if(!protocol) {
+        LOGGER_ERROR("Invalid protocol");
+        return nullptr;
+    }
+
+    try {
+        return new adm_session{scord::session{protocol}};
+    } catch(const std::exception& ex) {
+        LOGGER_ERROR("Could not create ADM_session_t: {}", ex.what());
+        return nullptr;
+    }
+}
+
+ADM_return_t
+ADM_session_destroy(ADM_session_t session) {
+
+    if(!session) {
+        LOGGER_ERROR("Invalid ADM_session_t");
+        return ADM_EBADARGS;
+    }
+
+    delete session;
+    return ADM_SUCCESS;
+}
+
 ADM_return_t
 ADM_ping(ADM_server_t server) {
     const scord::server srv{server};
@@ -84,12 +151,21 @@ ADM_return_t
 ADM_register_job(ADM_server_t server, ADM_job_resources_t res,
                  ADM_job_requirements_t reqs, uint64_t slurm_id,
                  ADM_job_t* job) {
+    return ADM_register_job_with_request_id(server, res, reqs, slurm_id,
+                                            nullptr, job);
+}
+
+ADM_return_t
+ADM_register_job_with_request_id(ADM_server_t server, ADM_job_resources_t res,
+                                 ADM_job_requirements_t reqs,
+                                 uint64_t slurm_id, const char* request_id,
+                                 ADM_job_t* job) {
 
     const scord::server srv{server};
 
-    const auto rv = scord::detail::register_job(srv, scord::job::resources{res},
-                                                scord::job::requirements{reqs},
-                                                slurm_id);
+    const auto rv = scord::detail::register_job(
+            srv, scord::job::resources{res}, scord::job::requirements{reqs},
+            slurm_id, request_id ? request_id : "");
 
     if(!rv) {
         return rv.error();
@@ -198,6 +274,132 @@ ADM_terminate_adhoc_storage(ADM_server_t server,
             scord::server{server}, scord::adhoc_storage{adhoc_storage});
 }
 
+ADM_return_t
+ADM_update_adhoc_storage_async(ADM_server_t server,
+                               ADM_adhoc_storage_t adhoc_storage,
+                               ADM_adhoc_resources_t new_resources,
+                               uint64_t* op_id) {
+
+    if(!op_id) {
+        return ADM_EBADARGS;
+    }
+
+    const auto rv = scord::detail::update_adhoc_storage_async(
+            scord::server{server}, scord::adhoc_storage{adhoc_storage},
+            scord::adhoc_storage::resources{new_resources});
+
+    if(!rv) {
+        return rv.error();
+    }
+
+    *op_id = rv.value();
+    return ADM_SUCCESS;
+}
+
+ADM_return_t
+ADM_deploy_adhoc_storage_async(ADM_server_t server,
+                               ADM_adhoc_storage_t adhoc_storage,
+                               uint64_t* op_id) {
+
+    if(!op_id) {
+        return ADM_EBADARGS;
+    }
+
+    const auto rv = scord::detail::deploy_adhoc_storage_async(
+            scord::server{server}, scord::adhoc_storage{adhoc_storage});
+
+    if(!rv) {
+        return rv.error();
+    }
+
+    *op_id = rv.value();
+    return ADM_SUCCESS;
+}
+
+ADM_return_t
+ADM_terminate_adhoc_storage_async(ADM_server_t server,
+                                  ADM_adhoc_storage_t adhoc_storage,
+                                  uint64_t* op_id) {
+
+    if(!op_id) {
+        return ADM_EBADARGS;
+    }
+
+    const auto rv = scord::detail::terminate_adhoc_storage_async(
+            scord::server{server}, scord::adhoc_storage{adhoc_storage});
+
+    if(!rv) {
+        return rv.error();
+    }
+
+    *op_id = rv.value();
+    return ADM_SUCCESS;
+}
+
+ADM_return_t
+ADM_wait_operation(ADM_server_t server, uint64_t op_id,
+                   const struct timespec* timeout, ADM_return_t* op_retval,
+                   char** adhoc_storage_path) {
+
+    using namespace std::chrono;
+
+    if(!op_retval ||
+       (timeout && (timeout->tv_sec < 0 || timeout->tv_nsec < 0))) {
+        return ADM_EBADARGS;
+    }
+
+    const auto budget =
+            timeout ? duration_cast<milliseconds>(seconds{timeout->tv_sec} +
+                                                  nanoseconds{timeout->tv_nsec})
+                    : milliseconds::zero();
+    const auto deadline = steady_clock::now() + budget;
+    const scord::server srv{server};
+
+    // the server caps how long a single request may wait, so keep asking
+    // until our own deadline expires
+    auto rv = scord::detail::wait_operation(srv, op_id, budget);
+
+    while(rv && !rv->completed()) {
+
+        const auto remaining =
+                duration_cast<milliseconds>(deadline - steady_clock::now());
+
+        if(remaining <= milliseconds::zero()) {
+            break;
+        }
+
+        rv = scord::detail::wait_operation(srv, op_id, remaining);
+    }
+
+    if(!rv) {
+        return rv.error();
+    }
+
+    if(!rv->completed()) {
+        return ADM_ETIMEOUT;
+    }
+
+    *op_retval = rv->error_code();
+
+    if(adhoc_storage_path) {
+        *adhoc_storage_path = nullptr;
+
+        if(const auto& s = rv->adhoc_dir(); !s.empty()) {
+            char* buf = static_cast<char*>(std::malloc(s.size() + 1));
+
+            if(!buf) {
+                return ADM_ENOMEM;
+            }
+
+            s.copy(buf, s.size());
+            buf[s.size()] = '\0';
+            *adhoc_storage_path = buf;
+        }
+    }
+
+    return ADM_SUCCESS;
+}
+
 ADM_return_t
 ADM_register_pfs_storage(ADM_server_t server, const char* name,
                          ADM_pfs_storage_type_t type, ADM_pfs_context_t ctx,
@@ -239,45 +441,35 @@ ADM_transfer_datasets(ADM_server_t server, ADM_job_t job,
                       ADM_qos_limit_t limits[], size_t limits_len,
                       ADM_transfer_mapping_t mapping, ADM_transfer_t* transfer,
                       bool wait = false) {
+    return ADM_transfer_datasets_with_request_id(
+            server, job, sources, sources_len, targets, targets_len, limits,
+            limits_len, mapping, nullptr, transfer, wait);
+}
+
+ADM_return_t
+ADM_transfer_datasets_with_request_id(
+        ADM_server_t server, ADM_job_t job, ADM_dataset_t sources[],
+        size_t sources_len, ADM_dataset_t targets[], size_t targets_len,
+        ADM_qos_limit_t limits[], size_t limits_len,
+        ADM_transfer_mapping_t mapping, const char* request_id,
+        ADM_transfer_t* transfer, bool wait) {
 
     const auto rv = scord::detail::transfer_datasets(
             scord::server{server}, scord::job{job},
             ::convert(sources, sources_len), ::convert(targets, targets_len),
             ::convert(limits, limits_len),
-            static_cast<scord::transfer::mapping>(mapping));
+            static_cast<scord::transfer::mapping>(mapping),
+            request_id ? request_id : "");
 
     if(!rv) {
         return rv.error();
     }
 
     *transfer = static_cast<ADM_transfer_t>(rv.value());
+
     if(wait) {
-        auto rv_wait = scord::detail::query_transfer(
-                scord::server{server}, scord::job{job},
-                scord::transfer{rv.value()});
-        if(!rv_wait) {
-            if(rv_wait.error().value() == scord::error_code::no_such_entity) {
-                return ADM_SUCCESS;
-            } else
-                return rv_wait.error();
-        }
-        auto status = rv_wait.value().status();
-
-        while(status == scord::transfer_state::type::running or
-              status == scord::transfer_state::type::queued) {
-            sleep(5);
-            rv_wait = scord::detail::query_transfer(
-                    scord::server{server}, scord::job{job},
-                    scord::transfer{rv.value()});
-            if(!rv_wait) {
-                if(rv_wait.error().value() ==
-                   scord::error_code::no_such_entity) {
-                    return ADM_SUCCESS;
-                } else
-                    return rv_wait.error();
-            }
-            status = rv_wait.value().status();
-        }
+        return ::wait_for_transfer(scord::server{server}, scord::job{job},
+                                   rv.value());
     }
 
     return ADM_SUCCESS;
@@ -302,38 +494,193 @@ ADM_transfer_datasets_1(ADM_server_t server, ADM_job_t job,
     }
 
     *transfer = static_cast<ADM_transfer_t>(rv.value());
+
     if(wait) {
-        auto rv_wait = scord::detail::query_transfer(
-                scord::server{server}, scord::job{job},
-                scord::transfer{rv.value()});
-        if(!rv_wait) {
-            if(rv_wait.error().value() == scord::error_code::no_such_entity) {
-                return ADM_SUCCESS;
-            } else
-                return rv_wait.error();
-        }
-        auto status = rv_wait.value().status();
-
-        while(status == scord::transfer_state::type::running or
-              status == scord::transfer_state::type::queued) {
-            sleep(5);
-            rv_wait = scord::detail::query_transfer(
-                    scord::server{server}, scord::job{job},
-                    scord::transfer{rv.value()});
-            if(!rv_wait) {
-                if(rv_wait.error().value() ==
-                   scord::error_code::no_such_entity) {
-                    return ADM_SUCCESS;
-                } else
-                    return rv_wait.error();
-            }
-            status = rv_wait.value().status();
+        return ::wait_for_transfer(scord::server{server}, scord::job{job},
+                                   rv.value());
+    }
+
+    return ADM_SUCCESS;
+}
+
+ADM_return_t
+ADM_query_transfers(ADM_server_t server, ADM_job_t job,
+                    ADM_transfer_t transfers[], size_t transfers_len,
+                    ADM_transfer_state_t states[], ADM_return_t errors[]) {
+
+    if(!transfers || !states) {
+        LOGGER_ERROR("Invalid arguments");
+        return ADM_EBADARGS;
+    }
+
+    std::vector<scord::transfer> txs;
+    txs.reserve(transfers_len);
+
+    for(size_t i = 0; i < transfers_len; ++i) {
+        txs.emplace_back(transfers[i]);
+    }
+
+    const auto rv = scord::detail::query_transfers(
+            scord::server{server}, scord::job{job}, txs);
+
+    if(!rv) {
+        return rv.error();
+    }
+
+    if(rv->size() != transfers_len) {
+        LOGGER_ERROR("Unexpected number of transfers in response");
+        return ADM_EOTHER;
+    }
+
+    for(size_t i = 0; i < transfers_len; ++i) {
+        const auto& info = (*rv)[i];
+        states[i] = static_cast<ADM_transfer_state_t>(info.state().status());
+
+        if(errors) {
+            errors[i] = info.error_code();
         }
     }
 
     return ADM_SUCCESS;
 }
 
+ADM_return_t
+ADM_query_job_transfers(ADM_server_t server, ADM_job_t job,
+                        ADM_transfer_t transfers[],
+                        ADM_transfer_state_t states[], size_t* transfers_len) {
+
+    if(!transfers_len || (*transfers_len != 0 && (!transfers || !states))) {
+        LOGGER_ERROR("Invalid arguments");
+        return ADM_EBADARGS;
+    }
+
+    // an empty list of transfers asks the server for every transfer of `job`
+    const auto rv = scord::detail::query_transfers(
+            scord::server{server}, scord::job{job}, {});
+
+    if(!rv) {
+        return rv.error();
+    }
+
+    const auto n = std::min(*transfers_len, rv->size());
+
+    for(size_t i = 0; i < n; ++i) {
+        const auto& info = (*rv)[i];
+        transfers[i] =
+                static_cast<ADM_transfer_t>(scord::transfer{info.id()});
+        states[i] = static_cast<ADM_transfer_state_t>(info.state().status());
+    }
+
+    *transfers_len = rv->size();
+    return ADM_SUCCESS;
+}
+
+struct adm_request {
+    std::function<bool()> r_test;
+    std::function<ADM_return_t()> r_wait;
+};
+
+ADM_return_t
+ADM_transfer_datasets_async(ADM_server_t server, ADM_job_t job,
+                            ADM_dataset_t sources[], size_t sources_len,
+                            ADM_dataset_t targets[], size_t targets_len,
+                            ADM_qos_limit_t limits[], size_t limits_len,
+                            ADM_transfer_mapping_t mapping,
+                            ADM_transfer_t* transfer, ADM_request_t* request) {
+
+    if(!transfer || !request) {
+        LOGGER_ERROR("Invalid output arguments");
+        return ADM_EBADARGS;
+    }
+
+    const auto rpc = scord::detail::transfer_datasets_async(
+            scord::server{server}, scord::job{job},
+            ::convert(sources, sources_len), ::convert(targets, targets_len),
+            ::convert(limits, limits_len),
+            static_cast<scord::transfer::mapping>(mapping));
+
+    *request = new adm_request{[rpc]() { return rpc->test(); },
+                               [rpc, transfer]() -> ADM_return_t {
+                                   const auto rv = rpc->wait();
+
+                                   if(!rv) {
+                                       return rv.error();
+                                   }
+
+                                   *transfer = static_cast<ADM_transfer_t>(
+                                           rv.value());
+                                   return ADM_SUCCESS;
+                               }};
+
+    return ADM_SUCCESS;
+}
+
+ADM_return_t
+ADM_query_transfer_async(ADM_server_t server, ADM_job_t job,
+                         ADM_transfer_t transfer, ADM_transfer_state_t* state,
+                         ADM_request_t* request) {
+
+    if(!state || !request) {
+        LOGGER_ERROR("Invalid output arguments");
+        return ADM_EBADARGS;
+    }
+
+    const auto rpc = scord::detail::query_transfer_async(
+            scord::server{server}, scord::job{job}, scord::transfer{transfer});
+
+    *request = new adm_request{[rpc]() { return rpc->test(); },
+                               [rpc, state]() -> ADM_return_t {
+                                   const auto rv = rpc->wait();
+
+                                   if(!rv) {
+                                       return rv.error();
+                                   }
+
+                                   *state = static_cast<ADM_transfer_state_t>(
+                                           rv.value().status());
+                                   return ADM_SUCCESS;
+                               }};
+
+    return ADM_SUCCESS;
+}
+
+ADM_return_t
+ADM_test(ADM_request_t request, bool* completed) {
+
+    if(!request || !completed) {
+        LOGGER_ERROR("Invalid ADM_request_t");
+        return ADM_EBADARGS;
+    }
+
+    *completed = request->r_test();
+    return ADM_SUCCESS;
+}
+
+ADM_return_t
+ADM_wait(ADM_request_t request) {
+
+    if(!request) {
+        LOGGER_ERROR("Invalid ADM_request_t");
+        return ADM_EBADARGS;
+    }
+
+    const auto rv = request->r_wait();
+    delete request;
+    return rv;
+}
+
+ADM_return_t
+ADM_request_destroy(ADM_request_t request) {
+
+    if(!request) {
+        LOGGER_ERROR("Invalid ADM_request_t");
+        return ADM_EBADARGS;
+    }
+
+    delete request;
+    return ADM_SUCCESS;
+}
+
 ADM_return_t
 ADM_set_dataset_information(ADM_server_t server, ADM_job_t job,
                             ADM_dataset_t target, ADM_dataset_info_t info) {
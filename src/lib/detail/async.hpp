@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Copyright 2021-2022, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef SCORD_DETAIL_ASYNC_HPP
+#define SCORD_DETAIL_ASYNC_HPP
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thallium.hpp>
+#include <tl/expected.hpp>
+#include <logger/logger.hpp>
+#include <net/endpoint.hpp>
+#include <net/tracing.hpp>
+#include <net/utilities.hpp>
+#include <scord/types.hpp>
+#include "session.hpp"
+
+namespace scord::detail {
+
+/**
+ * The state of an RPC that has been sent to a server but whose response
+ * may not have been received yet.
+ *
+ * A `pending_rpc` keeps its originating session alive so that the network
+ * engine is not finalized while the request is in flight. The response is
+ * decoded only once, the first time that `wait()` is called, which is also
+ * when the RPC's tracing span ends and when its outcome is recorded in the
+ * endpoint's circuit breaker.
+ */
+template <typename T>
+class pending_rpc {
+
+public:
+    using result_type = tl::expected<T, scord::error_code>;
+    using decoder_type = std::function<result_type(thallium::packed_data<>&)>;
+
+    pending_rpc(std::shared_ptr<session> rpc_session,
+                network::endpoint endpoint, network::rpc_info rpc,
+                thallium::async_response response, decoder_type decoder)
+        : m_session(std::move(rpc_session)), m_endpoint(std::move(endpoint)),
+          m_rpc(std::move(rpc)), m_response(std::move(response)),
+          m_decoder(std::move(decoder)) {
+        m_span.emplace(m_rpc);
+    }
+
+    /**
+     * A pending RPC that failed before it could be sent.
+     */
+    pending_rpc(network::rpc_info rpc, scord::error_code ec)
+        : m_rpc(std::move(rpc)), m_result(tl::make_unexpected(ec)) {
+        // nothing is in flight: the span ends with the failed attempt
+        const network::tracing::span span{m_rpc};
+    }
+
+    const std::string&
+    name() const {
+        return m_rpc.name();
+    }
+
+    bool
+    test() {
+        std::lock_guard lock(m_mutex);
+        return m_result.has_value() || m_response->received();
+    }
+
+    result_type
+    wait() {
+
+        std::lock_guard lock(m_mutex);
+
+        if(m_result.has_value()) {
+            return *m_result;
+        }
+
+        try {
+            auto output = m_endpoint->wait(*m_response);
+            m_result = m_decoder(output);
+        } catch(const std::exception& ex) {
+            LOGGER_ERROR("rpc {:<} failed: {}", m_rpc, ex.what());
+            m_session->invalidate(m_rpc.address());
+            m_result = tl::make_unexpected(scord::error_code::other);
+        }
+
+        m_span.reset();
+
+        // the response has been consumed, release network resources early
+        m_response.reset();
+        m_endpoint.reset();
+        m_session.reset();
+
+        return *m_result;
+    }
+
+private:
+    std::shared_ptr<session> m_session;
+    std::optional<network::endpoint> m_endpoint;
+    network::rpc_info m_rpc;
+    // must be declared after `m_rpc`, which it refers to
+    std::optional<network::tracing::span> m_span;
+    std::optional<thallium::async_response> m_response;
+    decoder_type m_decoder;
+    std::mutex m_mutex;
+    std::optional<result_type> m_result;
+};
+
+} // namespace scord::detail
+
+#endif // SCORD_DETAIL_ASYNC_HPP
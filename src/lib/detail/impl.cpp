@@ -22,19 +22,32 @@
  * SPDX-License-Identifier: GPL-3.0-or-later
  *****************************************************************************/
 
+#include <functional>
+#include <random>
+#include <thread>
 #include <tl/expected.hpp>
-#include <net/client.hpp>
+#include <net/bulk.hpp>
 #include <net/endpoint.hpp>
 #include <net/request.hpp>
 #include <net/serialization.hpp>
 #include <net/utilities.hpp>
+#include <net/tracing.hpp>
 #include <scord/types.hpp>
 #include "impl.hpp"
+#include "async.hpp"
+#include "session.hpp"
 
 using namespace std::literals;
 
 constexpr auto default_ping_timeout = 4s;
 
+// extra time granted to long-polling RPCs on top of the time the server is
+// allowed to wait before replying
+constexpr auto long_poll_margin = 10s;
+
+// how many times a query rejected by an overloaded server is retried
+constexpr std::uint32_t max_busy_retries = 5;
+
 namespace api {
 
 struct remote_procedure {
@@ -47,6 +60,32 @@ struct remote_procedure {
 
 } // namespace api
 
+namespace {
+
+/**
+ * Generate a random (version 4) UUID to identify a request. Since retries
+ * of a request reuse its id, the server can recognize them and avoid
+ * executing the request more than once.
+ */
+std::string
+generate_request_id() {
+
+    thread_local std::mt19937_64 rng{std::random_device{}()};
+
+    std::uint64_t hi = rng();
+    std::uint64_t lo = rng();
+
+    // set the version (4) and variant (RFC 4122) bits
+    hi = (hi & ~0xf000ULL) | 0x4000ULL;
+    lo = (lo & ~(0x3ULL << 62)) | (0x2ULL << 62);
+
+    return fmt::format("{:08x}-{:04x}-{:04x}-{:04x}-{:012x}", hi >> 32,
+                       (hi >> 16) & 0xffff, hi & 0xffff, lo >> 48,
+                       lo & 0xffffffffffffULL);
+}
+
+} // namespace
+
 namespace scord::detail {
 
 #define RPC_NAME() ("ADM_"s + __FUNCTION__)
@@ -54,11 +93,11 @@ namespace scord::detail {
 scord::error_code
 ping(const server& srv) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
@@ -79,6 +118,80 @@ ping(const server& srv) {
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return scord::error_code::other;
+}
+
+tl::expected<std::string, scord::error_code>
+get_metrics(const server& srv) {
+
+    using response_type = network::response_with_value<std::string>;
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        LOGGER_INFO("rpc {:<} body: {{}}", rpc);
+
+        if(const auto& call_rv = endp.call(rpc.name());
+           call_rv.has_value()) {
+
+            const response_type resp{call_rv.value()};
+
+            LOGGER_EVAL(resp.error_code(), INFO, ERROR,
+                        "rpc {:>} body: {{retval: {}, metrics: {} bytes}} "
+                        "[op_id: {}]",
+                        rpc, resp.error_code(),
+                        resp.value_or_none().value_or(std::string{}).size(),
+                        resp.op_id());
+
+            if(!resp.error_code()) {
+                return tl::make_unexpected(resp.error_code());
+            }
+
+            return resp.value();
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return tl::make_unexpected(scord::error_code::other);
+}
+
+scord::error_code
+set_log_level(const server& srv, const std::string& subsystem,
+              const std::string& level) {
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        LOGGER_INFO("rpc {:<} body: {{subsystem: {:?}, level: {:?}}}", rpc,
+                    subsystem, level);
+
+        if(const auto& call_rv = endp.call(rpc.name(), subsystem, level);
+           call_rv.has_value()) {
+
+            const network::generic_response resp{call_rv.value()};
+
+            LOGGER_EVAL(resp.error_code(), INFO, ERROR,
+                        "rpc {:>} body: {{retval: {}}} [op_id: {}]", rpc,
+                        resp.error_code(), resp.op_id());
+
+            return resp.error_code();
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return scord::error_code::other;
 }
 
@@ -87,25 +200,42 @@ query(const server& srv, slurm_job_id job_id) {
 
     using response_type = network::response_with_value<scord::job_info>;
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
         LOGGER_INFO("rpc {:<} body: {{slurm_job_id: {}}}", rpc, job_id);
 
-        if(const auto& call_rv = endp.call(rpc.name(), job_id);
-           call_rv.has_value()) {
+        // all the ranks of a job may query the server at once, so requests
+        // rejected because the server is overloaded are retried after the
+        // delay suggested by the server
+        for(std::uint32_t attempt = 0;; ++attempt) {
+
+            const auto& call_rv = endp.call(rpc.name(), job_id);
+
+            if(!call_rv.has_value()) {
+                break;
+            }
 
             const response_type resp{call_rv.value()};
 
+            if(resp.error_code() == scord::error_code::busy &&
+               attempt < max_busy_retries) {
+                LOGGER_WARN("rpc {:>} server busy, retrying in {}ms", rpc,
+                            resp.retry_after().count());
+                std::this_thread::sleep_for(resp.retry_after());
+                continue;
+            }
+
             LOGGER_EVAL(
                     resp.error_code(), INFO, ERROR,
                     "rpc {:>} body: {{retval: {}, job_info: {}}} [op_id: {}]",
-                    rpc, resp.error_code(), resp.value(), resp.op_id());
+                    rpc, resp.error_code(), resp.value_or_none(),
+                    resp.op_id());
 
             if(!resp.error_code()) {
                 return tl::make_unexpected(resp.error_code());
@@ -116,35 +246,44 @@ query(const server& srv, slurm_job_id job_id) {
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return tl::make_unexpected(scord::error_code::other);
 }
 
 tl::expected<scord::job, scord::error_code>
 register_job(const server& srv, const job::resources& job_resources,
              const job::requirements& job_requirements,
-             scord::slurm_job_id slurm_id) {
+             scord::slurm_job_id slurm_id,
+             const std::string& supplied_request_id) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+    const network::tracing::span span{rpc};
 
-    if(const auto lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
+        const auto request_id = supplied_request_id.empty()
+                                        ? generate_request_id()
+                                        : supplied_request_id;
+
         LOGGER_INFO("rpc {:<} body: {{job_resources: {}, job_requirements: {}, "
-                    "slurm_id: {}}}",
-                    rpc, job_resources, job_requirements, slurm_id);
+                    "slurm_id: {}, request_id: {:?}}}",
+                    rpc, job_resources, job_requirements, slurm_id, request_id);
 
         if(const auto call_rv = endp.call(rpc.name(), job_resources,
-                                          job_requirements, slurm_id);
+                                          job_requirements, slurm_id,
+                                          request_id, rpc.trace());
            call_rv.has_value()) {
 
             const network::response_with_id resp{call_rv.value()};
 
             LOGGER_EVAL(resp.error_code(), INFO, ERROR,
                         "rpc {:>} body: {{retval: {}, job_id: {}}} [op_id: {}]",
-                        rpc, resp.error_code(), resp.value(), resp.op_id());
+                        rpc, resp.error_code(), resp.value_or_none(),
+                        resp.op_id());
 
             if(const auto ec = resp.error_code(); !ec) {
                 return tl::make_unexpected(resp.error_code());
@@ -155,6 +294,7 @@ register_job(const server& srv, const job::resources& job_resources,
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return tl::make_unexpected(scord::error_code::other);
 }
 
@@ -162,11 +302,11 @@ scord::error_code
 update_job(const server& srv, const job& job,
            const job::resources& new_resources) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
@@ -186,17 +326,18 @@ update_job(const server& srv, const job& job,
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return scord::error_code::other;
 }
 
 scord::error_code
 remove_job(const server& srv, const job& job) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
@@ -215,6 +356,7 @@ remove_job(const server& srv, const job& job) {
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return scord::error_code::other;
 }
 
@@ -224,11 +366,11 @@ register_adhoc_storage(const server& srv, const std::string& name,
                        const adhoc_storage::ctx& ctx,
                        const adhoc_storage::resources& resources) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
@@ -245,7 +387,7 @@ register_adhoc_storage(const server& srv, const std::string& name,
             LOGGER_EVAL(
                     resp.error_code(), INFO, ERROR,
                     "rpc {:>} body: {{retval: {}, adhoc_id: {}}} [op_id: {}]",
-                    rpc, resp.error_code(), resp.value(), resp.op_id());
+                    rpc, resp.error_code(), resp.value_or_none(), resp.op_id());
 
             if(const auto ec = resp.error_code(); !ec) {
                 return tl::make_unexpected(ec);
@@ -257,6 +399,7 @@ register_adhoc_storage(const server& srv, const std::string& name,
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return tl::make_unexpected(scord::error_code::other);
 }
 
@@ -264,19 +407,20 @@ scord::error_code
 update_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage,
                      const adhoc_storage::resources& new_resources) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+    const network::tracing::span span{rpc};
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
         LOGGER_INFO("rpc {:<} body: {{adhoc_id: {}, new_resources: {}}}", rpc,
                     adhoc_storage.id(), new_resources);
 
-        if(const auto& call_rv =
-                   endp.call(rpc.name(), adhoc_storage.id(), new_resources);
+        if(const auto& call_rv = endp.call(rpc.name(), adhoc_storage.id(),
+                                           new_resources, rpc.trace());
            call_rv.has_value()) {
 
             const network::generic_response resp{call_rv.value()};
@@ -290,17 +434,18 @@ update_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage,
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return scord::error_code::other;
 }
 
 scord::error_code
 remove_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
@@ -320,6 +465,7 @@ remove_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage) {
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return scord::error_code::other;
 }
 
@@ -327,11 +473,11 @@ tl::expected<scord::pfs_storage, scord::error_code>
 register_pfs_storage(const server& srv, const std::string& name,
                      enum pfs_storage::type type, const pfs_storage::ctx& ctx) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
@@ -345,7 +491,8 @@ register_pfs_storage(const server& srv, const std::string& name,
 
             LOGGER_EVAL(resp.error_code(), INFO, ERROR,
                         "rpc {:>} body: {{retval: {}, pfs_id: {}}} [op_id: {}]",
-                        rpc, resp.error_code(), resp.value(), resp.op_id());
+                        rpc, resp.error_code(), resp.value_or_none(),
+                        resp.op_id());
 
             if(const auto ec = resp.error_code(); !ec) {
                 return tl::make_unexpected(ec);
@@ -356,6 +503,7 @@ register_pfs_storage(const server& srv, const std::string& name,
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return tl::make_unexpected(scord::error_code::other);
 }
 
@@ -363,11 +511,11 @@ scord::error_code
 update_pfs_storage(const server& srv, const pfs_storage& pfs_storage,
                    const scord::pfs_storage::ctx& new_ctx) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
@@ -389,17 +537,18 @@ update_pfs_storage(const server& srv, const pfs_storage& pfs_storage,
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return scord::error_code::other;
 }
 
 scord::error_code
 remove_pfs_storage(const server& srv, const pfs_storage& pfs_storage) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
@@ -419,6 +568,7 @@ remove_pfs_storage(const server& srv, const pfs_storage& pfs_storage) {
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return scord::error_code::other;
 }
 
@@ -427,17 +577,19 @@ deploy_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage) {
 
     using response_type = network::response_with_value<std::filesystem::path>;
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+    const network::tracing::span span{rpc};
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
         LOGGER_INFO("rpc {:<} body: {{adhoc_id: {}}}", rpc, adhoc_storage.id());
 
-        if(const auto& call_rv = endp.call(rpc.name(), adhoc_storage.id());
+        if(const auto& call_rv =
+                   endp.call(rpc.name(), adhoc_storage.id(), rpc.trace());
            call_rv.has_value()) {
 
             const response_type resp{call_rv.value()};
@@ -445,7 +597,7 @@ deploy_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage) {
             LOGGER_EVAL(
                     resp.error_code(), INFO, ERROR,
                     "rpc {:>} body: {{retval: {}, adhoc_dir: {}}} [op_id: {}]",
-                    rpc, resp.error_code(), resp.value(), resp.op_id());
+                    rpc, resp.error_code(), resp.value_or_none(), resp.op_id());
 
             if(!resp.error_code()) {
                 return tl::make_unexpected(resp.error_code());
@@ -456,23 +608,26 @@ deploy_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage) {
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return tl::make_unexpected(scord::error_code::other);
 }
 
 scord::error_code
 terminate_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+    const network::tracing::span span{rpc};
 
-    if(const auto lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
         LOGGER_INFO("rpc {:<} body: {{adhoc_id: {}}}", rpc, adhoc_storage.id());
 
-        if(const auto call_rv = endp.call(rpc.name(), adhoc_storage.id());
+        if(const auto call_rv =
+                   endp.call(rpc.name(), adhoc_storage.id(), rpc.trace());
            call_rv.has_value()) {
 
             const network::generic_response resp{call_rv.value()};
@@ -486,6 +641,7 @@ terminate_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage) {
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return scord::error_code::other;
 }
 
@@ -494,29 +650,74 @@ transfer_datasets(const server& srv, const job& job,
                   const std::vector<dataset>& sources,
                   const std::vector<dataset>& targets,
                   const std::vector<qos::limit>& limits,
-                  transfer::mapping mapping) {
+                  transfer::mapping mapping,
+                  const std::string& supplied_request_id) {
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+    const network::tracing::span span{rpc};
 
-    if(const auto& lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
-        LOGGER_INFO("rpc {:<} body: {{job_id: {}, sources: {}, targets: {}, "
-                    "limits: {}, mapping: {}}}",
-                    rpc, job.id(), sources, targets, limits, mapping);
+        const auto request_id = supplied_request_id.empty()
+                                        ? generate_request_id()
+                                        : supplied_request_id;
 
-        if(const auto& call_rv = endp.call(rpc.name(), job.id(), sources,
-                                           targets, limits, mapping);
-           call_rv.has_value()) {
+        std::size_t payload_size = 0;
+
+        for(const auto& datasets : {std::cref(sources), std::cref(targets)}) {
+            for(const auto& d : datasets.get()) {
+                payload_size += d.id().size();
+            }
+        }
+
+        // Large manifests are packed into a single buffer and exposed to the
+        // server, which pulls them with one bulk transfer instead of
+        // receiving them in the RPC's eager buffer. Since the call is
+        // synchronous, the buffer outlives the server's pull.
+        std::vector<char> manifest;
+
+        const auto call_rv = [&]() -> std::optional<thallium::packed_data<>> {
+            if(payload_size <= network::bulk::threshold) {
+                LOGGER_INFO("rpc {:<} body: {{job_id: {}, sources: {}, "
+                            "targets: {}, limits: {}, mapping: {}, "
+                            "request_id: {:?}}}",
+                            rpc, job.id(), sources, targets, limits, mapping,
+                            request_id);
+
+                return endp.call(rpc.name(), job.id(), sources, targets,
+                                 limits, mapping, request_id, rpc.trace());
+            }
+
+            const auto get_id = [](const auto& d) { return d.id(); };
+            manifest = network::bulk::pack(sources, get_id);
+            const auto tail = network::bulk::pack(targets, get_id);
+            manifest.insert(manifest.end(), tail.begin(), tail.end());
+
+            LOGGER_INFO("rpc {:<} body: {{job_id: {}, sources: {} datasets, "
+                        "targets: {} datasets, manifest: {} bytes, limits: {}, "
+                        "mapping: {}, request_id: {:?}}}",
+                        rpc, job.id(), sources.size(), targets.size(),
+                        manifest.size(), limits, mapping, request_id);
+
+            auto engine = endp.engine();
+            return endp.call("ADM_transfer_datasets_bulk"s, job.id(),
+                             network::bulk::expose(engine, manifest),
+                             static_cast<std::uint64_t>(sources.size()),
+                             limits, mapping, request_id, rpc.trace());
+        }();
+
+        if(call_rv.has_value()) {
 
             const network::response_with_id resp{call_rv.value()};
 
             LOGGER_EVAL(resp.error_code(), INFO, ERROR,
                         "rpc {:>} body: {{retval: {}, tx_id: {}}} [op_id: {}]",
-                        rpc, resp.error_code(), resp.value(), resp.op_id());
+                        rpc, resp.error_code(), resp.value_or_none(),
+                        resp.op_id());
 
             if(const auto ec = resp.error_code(); !ec) {
                 return tl::make_unexpected(ec);
@@ -527,6 +728,7 @@ transfer_datasets(const server& srv, const job& job,
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return tl::make_unexpected(scord::error_code::other);
 }
 
@@ -536,11 +738,11 @@ query_transfer(const server& srv, const job& job, const transfer& transfer) {
 
     using response_type = network::response_with_value<transfer_state>;
 
-    network::client rpc_client{srv.protocol()};
+    const auto rpc_session = session::get(srv.protocol());
 
     const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
 
-    if(const auto lookup_rv = rpc_client.lookup(srv.address());
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
        lookup_rv.has_value()) {
         const auto& endp = lookup_rv.value();
 
@@ -554,7 +756,379 @@ query_transfer(const server& srv, const job& job, const transfer& transfer) {
             LOGGER_EVAL(
                     resp.error_code(), INFO, ERROR,
                     "rpc {:>} body: {{retval: {}, tx_state: {}}} [op_id: {}]",
-                    rpc, resp.error_code(), resp.value(), resp.op_id());
+                    rpc, resp.error_code(), resp.value_or_none(), resp.op_id());
+
+            if(!resp.error_code()) {
+                return tl::make_unexpected(resp.error_code());
+            }
+
+            return resp.value();
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return tl::make_unexpected(scord::error_code::other);
+}
+
+tl::expected<std::vector<transfer_info>, error_code>
+query_transfers(const server& srv, const job& job,
+                const std::vector<transfer>& transfers) {
+
+    using response_type =
+            network::response_with_value<std::vector<transfer_info>>;
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        std::vector<transfer_id> tx_ids;
+        tx_ids.reserve(transfers.size());
+
+        for(const auto& tx : transfers) {
+            tx_ids.emplace_back(tx.id());
+        }
+
+        LOGGER_INFO("rpc {:<} body: {{job_id: {}, tx_ids: {}}}", rpc,
+                    job.id(), tx_ids);
+
+        if(const auto call_rv = endp.call(rpc.name(), job.id(), tx_ids);
+           call_rv.has_value()) {
+
+            const response_type resp{call_rv.value()};
+
+            LOGGER_EVAL(
+                    resp.error_code(), INFO, ERROR,
+                    "rpc {:>} body: {{retval: {}, tx_infos: {}}} [op_id: {}]",
+                    rpc, resp.error_code(), resp.value_or({}), resp.op_id());
+
+            if(!resp.error_code()) {
+                return tl::make_unexpected(resp.error_code());
+            }
+
+            return resp.value();
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return tl::make_unexpected(scord::error_code::other);
+}
+
+tl::expected<transfer_state, error_code>
+wait_transfer(const server& srv, const job& job, const transfer& transfer,
+              std::chrono::milliseconds timeout) {
+
+    using response_type = network::response_with_value<transfer_state>;
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        const std::uint64_t timeout_ms =
+                std::max<std::chrono::milliseconds::rep>(timeout.count(), 0);
+
+        LOGGER_INFO("rpc {:<} body: {{job_id: {}, tx_id: {}, timeout_ms: {}}}",
+                    rpc, job.id(), transfer.id(), timeout_ms);
+
+        if(const auto call_rv = endp.timed_call(
+                   rpc.name(), std::chrono::milliseconds{timeout_ms} +
+                                       long_poll_margin,
+                   job.id(), transfer.id(), timeout_ms);
+           call_rv.has_value()) {
+
+            const response_type resp{call_rv.value()};
+
+            LOGGER_EVAL(
+                    resp.error_code(), INFO, ERROR,
+                    "rpc {:>} body: {{retval: {}, tx_state: {}}} [op_id: {}]",
+                    rpc, resp.error_code(), resp.value_or_none(),
+                    resp.op_id());
+
+            if(!resp.error_code()) {
+                return tl::make_unexpected(resp.error_code());
+            }
+
+            return resp.value();
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return tl::make_unexpected(scord::error_code::other);
+}
+
+std::shared_ptr<pending_rpc<transfer>>
+transfer_datasets_async(const server& srv, const job& job,
+                        const std::vector<dataset>& sources,
+                        const std::vector<dataset>& targets,
+                        const std::vector<qos::limit>& limits,
+                        transfer::mapping mapping,
+                        const std::string& supplied_request_id) {
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc = network::rpc_info::create("ADM_transfer_datasets"s,
+                                               srv.address());
+
+    if(const auto& lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        const auto request_id = supplied_request_id.empty()
+                                        ? generate_request_id()
+                                        : supplied_request_id;
+
+        LOGGER_INFO("rpc {:<} body: {{job_id: {}, sources: {}, targets: {}, "
+                    "limits: {}, mapping: {}, request_id: {:?}}}",
+                    rpc, job.id(), sources, targets, limits, mapping,
+                    request_id);
+
+        if(auto call_rv =
+                   endp.async_call(rpc.name(), job.id(), sources, targets,
+                                   limits, mapping, request_id, rpc.trace());
+           call_rv.has_value()) {
+
+            return std::make_shared<pending_rpc<transfer>>(
+                    rpc_session, endp, rpc, std::move(call_rv.value()),
+                    [rpc](auto& output) -> tl::expected<transfer, error_code> {
+                        const network::response_with_id resp{output};
+
+                        LOGGER_EVAL(resp.error_code(), INFO, ERROR,
+                                    "rpc {:>} body: {{retval: {}, tx_id: {}}} "
+                                    "[op_id: {}]",
+                                    rpc, resp.error_code(),
+                                    resp.value_or_none(), resp.op_id());
+
+                        if(const auto ec = resp.error_code(); !ec) {
+                            return tl::make_unexpected(ec);
+                        }
+
+                        return scord::transfer{resp.value()};
+                    });
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return std::make_shared<pending_rpc<transfer>>(rpc,
+                                                   scord::error_code::other);
+}
+
+std::shared_ptr<pending_rpc<transfer_state>>
+query_transfer_async(const server& srv, const job& job,
+                     const transfer& transfer) {
+
+    using response_type = network::response_with_value<transfer_state>;
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc =
+            network::rpc_info::create("ADM_query_transfer"s, srv.address());
+
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        LOGGER_INFO("rpc {:<} body: {{job_id: {}, tx_id: {}}}", rpc, job.id(),
+                    transfer.id());
+
+        if(auto call_rv = endp.async_call(rpc.name(), job.id(), transfer.id());
+           call_rv.has_value()) {
+
+            return std::make_shared<pending_rpc<transfer_state>>(
+                    rpc_session, endp, rpc, std::move(call_rv.value()),
+                    [rpc](auto& output)
+                            -> tl::expected<transfer_state, error_code> {
+                        const response_type resp{output};
+
+                        LOGGER_EVAL(resp.error_code(), INFO, ERROR,
+                                    "rpc {:>} body: {{retval: {}, tx_state: "
+                                    "{}}} [op_id: {}]",
+                                    rpc, resp.error_code(),
+                                    resp.value_or_none(), resp.op_id());
+
+                        if(!resp.error_code()) {
+                            return tl::make_unexpected(resp.error_code());
+                        }
+
+                        return resp.value();
+                    });
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return std::make_shared<pending_rpc<transfer_state>>(
+            rpc, scord::error_code::other);
+}
+
+tl::expected<operation_id, error_code>
+update_adhoc_storage_async(const server& srv, const adhoc_storage& adhoc_storage,
+                           const adhoc_storage::resources& new_resources) {
+
+    using response_type = network::response_with_id;
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+    const network::tracing::span span{rpc};
+
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        LOGGER_INFO("rpc {:<} body: {{adhoc_id: {}, new_resources: {}}}", rpc,
+                    adhoc_storage.id(), new_resources);
+
+        if(const auto call_rv = endp.call(rpc.name(), adhoc_storage.id(),
+                                          new_resources, rpc.trace());
+           call_rv.has_value()) {
+
+            const response_type resp{call_rv.value()};
+
+            LOGGER_EVAL(
+                    resp.error_code(), INFO, ERROR,
+                    "rpc {:>} body: {{retval: {}, operation: {}}} [op_id: {}]",
+                    rpc, resp.error_code(), resp.value_or_none(), resp.op_id());
+
+            if(!resp.error_code()) {
+                return tl::make_unexpected(resp.error_code());
+            }
+
+            return resp.value();
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return tl::make_unexpected(scord::error_code::other);
+}
+
+tl::expected<operation_id, error_code>
+deploy_adhoc_storage_async(const server& srv,
+                           const adhoc_storage& adhoc_storage) {
+
+    using response_type = network::response_with_id;
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+    const network::tracing::span span{rpc};
+
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        LOGGER_INFO("rpc {:<} body: {{adhoc_id: {}}}", rpc, adhoc_storage.id());
+
+        if(const auto call_rv =
+                   endp.call(rpc.name(), adhoc_storage.id(), rpc.trace());
+           call_rv.has_value()) {
+
+            const response_type resp{call_rv.value()};
+
+            LOGGER_EVAL(
+                    resp.error_code(), INFO, ERROR,
+                    "rpc {:>} body: {{retval: {}, operation: {}}} [op_id: {}]",
+                    rpc, resp.error_code(), resp.value_or_none(), resp.op_id());
+
+            if(!resp.error_code()) {
+                return tl::make_unexpected(resp.error_code());
+            }
+
+            return resp.value();
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return tl::make_unexpected(scord::error_code::other);
+}
+
+tl::expected<operation_id, error_code>
+terminate_adhoc_storage_async(const server& srv,
+                              const adhoc_storage& adhoc_storage) {
+
+    using response_type = network::response_with_id;
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+    const network::tracing::span span{rpc};
+
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        LOGGER_INFO("rpc {:<} body: {{adhoc_id: {}}}", rpc, adhoc_storage.id());
+
+        if(const auto call_rv =
+                   endp.call(rpc.name(), adhoc_storage.id(), rpc.trace());
+           call_rv.has_value()) {
+
+            const response_type resp{call_rv.value()};
+
+            LOGGER_EVAL(
+                    resp.error_code(), INFO, ERROR,
+                    "rpc {:>} body: {{retval: {}, operation: {}}} [op_id: {}]",
+                    rpc, resp.error_code(), resp.value_or_none(), resp.op_id());
+
+            if(!resp.error_code()) {
+                return tl::make_unexpected(resp.error_code());
+            }
+
+            return resp.value();
+        }
+    }
+
+    LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
+    return tl::make_unexpected(scord::error_code::other);
+}
+
+tl::expected<operation_info, error_code>
+wait_operation(const server& srv, operation_id op_id,
+               std::chrono::milliseconds timeout) {
+
+    using response_type = network::response_with_value<operation_info>;
+
+    const auto rpc_session = session::get(srv.protocol());
+
+    const auto rpc = network::rpc_info::create(RPC_NAME(), srv.address());
+    const network::tracing::span span{rpc};
+
+    if(const auto lookup_rv = rpc_session->lookup(srv.address());
+       lookup_rv.has_value()) {
+        const auto& endp = lookup_rv.value();
+
+        const std::uint64_t timeout_ms =
+                std::max<std::chrono::milliseconds::rep>(timeout.count(), 0);
+
+        LOGGER_INFO("rpc {:<} body: {{op_id: {}, timeout_ms: {}}}", rpc,
+                    op_id, timeout_ms);
+
+        if(const auto call_rv = endp.timed_call(
+                   rpc.name(), std::chrono::milliseconds{timeout_ms} +
+                                       long_poll_margin,
+                   op_id, timeout_ms, rpc.trace());
+           call_rv.has_value()) {
+
+            const response_type resp{call_rv.value()};
+
+            LOGGER_EVAL(
+                    resp.error_code(), INFO, ERROR,
+                    "rpc {:>} body: {{retval: {}, op_info: {}}} [op_id: {}]",
+                    rpc, resp.error_code(), resp.value_or_none(),
+                    resp.op_id());
 
             if(!resp.error_code()) {
                 return tl::make_unexpected(resp.error_code());
@@ -565,6 +1139,7 @@ query_transfer(const server& srv, const job& job, const transfer& transfer) {
     }
 
     LOGGER_ERROR("rpc call failed");
+    rpc_session->invalidate(srv.address());
     return tl::make_unexpected(scord::error_code::other);
 }
 
@@ -26,6 +26,7 @@
 #ifndef SCORD_ADMIRE_IMPL_HPP
 #define SCORD_ADMIRE_IMPL_HPP
 
+#include <chrono>
 #include <scord/scord.hpp>
 #include <tl/expected.hpp>
 
@@ -34,13 +35,21 @@ namespace scord::detail {
 scord::error_code
 ping(const server& srv);
 
+tl::expected<std::string, scord::error_code>
+get_metrics(const server& srv);
+
+scord::error_code
+set_log_level(const server& srv, const std::string& subsystem,
+              const std::string& level);
+
 tl::expected<scord::job_info, scord::error_code>
 query(const server& srv, slurm_job_id job_id);
 
 tl::expected<scord::job, scord::error_code>
 register_job(const server& srv, const job::resources& job_resources,
              const job::requirements& job_requirements,
-             scord::slurm_job_id slurm_id);
+             scord::slurm_job_id slurm_id,
+             const std::string& request_id = {});
 
 scord::error_code
 update_job(const server& srv, const job& job,
@@ -84,11 +93,48 @@ transfer_datasets(const server& srv, const job& job,
                   const std::vector<dataset>& sources,
                   const std::vector<dataset>& targets,
                   const std::vector<qos::limit>& limits,
-                  transfer::mapping mapping);
+                  transfer::mapping mapping,
+                  const std::string& request_id = {});
 
 tl::expected<transfer_state, error_code>
 query_transfer(const server& srv, const job& job, const transfer& transfer);
 
+tl::expected<std::vector<transfer_info>, error_code>
+query_transfers(const server& srv, const job& job,
+                const std::vector<transfer>& transfers);
+
+tl::expected<transfer_state, error_code>
+wait_transfer(const server& srv, const job& job, const transfer& transfer,
+              std::chrono::milliseconds timeout);
+
+std::shared_ptr<pending_rpc<transfer>>
+transfer_datasets_async(const server& srv, const job& job,
+                        const std::vector<dataset>& sources,
+                        const std::vector<dataset>& targets,
+                        const std::vector<qos::limit>& limits,
+                        transfer::mapping mapping,
+                        const std::string& request_id = {});
+
+std::shared_ptr<pending_rpc<transfer_state>>
+query_transfer_async(const server& srv, const job& job,
+                     const transfer& transfer);
+
+tl::expected<operation_id, error_code>
+update_adhoc_storage_async(const server& srv, const adhoc_storage& adhoc_storage,
+                           const adhoc_storage::resources& new_resources);
+
+tl::expected<operation_id, error_code>
+deploy_adhoc_storage_async(const server& srv,
+                           const adhoc_storage& adhoc_storage);
+
+tl::expected<operation_id, error_code>
+terminate_adhoc_storage_async(const server& srv,
+                              const adhoc_storage& adhoc_storage);
+
+tl::expected<operation_info, error_code>
+wait_operation(const server& srv, operation_id op_id,
+               std::chrono::milliseconds timeout);
+
 
 
 } // namespace scord::detail
@@ -0,0 +1,228 @@
+/******************************************************************************
+ * Copyright 2021-2022, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <string_view>
+#include <logger/logger.hpp>
+#include <env.hpp>
+#include "session.hpp"
+
+using namespace std::literals;
+
+namespace {
+
+// RPCs that can be retried safely if an attempt fails, either because they
+// only read state from the server or because they carry a request id that
+// the server uses to detect replays
+constexpr std::array idempotent_rpcs = {
+        "ADM_ping", "ADM_get_metrics", "ADM_set_log_level", "ADM_query",
+        "ADM_query_transfer", "ADM_query_transfers", "ADM_wait_transfer",
+        "ADM_wait_operation", "ADM_register_job", "ADM_transfer_datasets",
+        "ADM_transfer_datasets_bulk"};
+
+// RPCs that block the server until an adhoc storage controller completes
+// a (potentially lengthy) deployment step
+constexpr std::array long_running_rpcs = {"ADM_deploy_adhoc_storage",
+                                          "ADM_update_adhoc_storage",
+                                          "ADM_terminate_adhoc_storage"};
+
+constexpr std::uint32_t idempotent_max_retries = 3;
+constexpr auto long_running_timeout = 10min;
+
+// Requests to servers running on the same node go through shared memory
+// unless disabled with LIBSCORD_SHARED_MEMORY=0 (e.g. if /dev/shm is not
+// usable)
+bool
+use_shared_memory() {
+    const char* p = std::getenv(scord::env::SHARED_MEMORY);
+    return p == nullptr || (std::string_view{p} != "0" &&
+                            std::string_view{p} != "false" &&
+                            std::string_view{p} != "no");
+}
+
+// Sessions drive network progress from a dedicated thread unless disabled
+// with LIBSCORD_PROGRESS_THREAD=0. Without it, requests only make progress
+// while the application is blocked in a library call, so `ADM_test()`
+// cannot observe the completion of an asynchronous request. Applications
+// that only use the synchronous API can disable it to save a thread
+bool
+use_progress_thread() {
+    const char* p = std::getenv(scord::env::PROGRESS_THREAD);
+    return p == nullptr || (std::string_view{p} != "0" &&
+                            std::string_view{p} != "false" &&
+                            std::string_view{p} != "no");
+}
+
+void
+configure_policies(network::call_policies& policies) {
+
+    auto default_policy = policies.get_default();
+
+    if(const char* p = std::getenv(scord::env::RPC_TIMEOUT); p != nullptr) {
+        char* end = nullptr;
+        const auto timeout_ms = std::strtoull(p, &end, 10);
+
+        if(end != p && *end == '\0' && timeout_ms != 0) {
+            default_policy.timeout = std::chrono::milliseconds{timeout_ms};
+            policies.set_default(default_policy);
+        } else {
+            LOGGER_WARN("Ignoring invalid value for {}: {:?}",
+                        scord::env::RPC_TIMEOUT, p);
+        }
+    }
+
+    for(const auto& name : idempotent_rpcs) {
+        auto policy = default_policy;
+        policy.idempotent = true;
+        policy.max_retries = idempotent_max_retries;
+        policies.set(name, policy);
+    }
+
+    for(const auto& name : long_running_rpcs) {
+        policies.set_timeout(name, std::max<std::chrono::milliseconds>(
+                                           default_policy.timeout,
+                                           long_running_timeout));
+    }
+}
+
+
+struct registry_entry {
+    std::shared_ptr<scord::detail::session> m_session;
+    std::size_t m_handles = 0;
+};
+
+using registry_type = std::unordered_map<std::string, registry_entry>;
+
+std::mutex registry_mutex;
+
+// The registry is intentionally leaked so that it is still alive when the
+// `atexit()` handler calls `session::release_all()`
+registry_type&
+registry() {
+    static auto* r = new registry_type;
+    return *r;
+}
+
+registry_entry&
+find_or_create(const std::string& protocol) {
+
+    auto it = registry().find(protocol);
+
+    if(it == registry().end()) {
+        LOGGER_INFO("Creating new session for protocol {:?}", protocol);
+        it = registry()
+                     .emplace(protocol,
+                              registry_entry{std::make_shared<
+                                      scord::detail::session>(protocol)})
+                     .first;
+
+        // Finalize all engines at exit, before the static state of Margo
+        // and Argobots is torn down. The handler is registered once the
+        // first engine exists so that it runs before any exit handler that
+        // the engine itself may have registered
+        static bool finalize_at_exit = false;
+
+        if(!finalize_at_exit) {
+            std::atexit(&scord::detail::session::release_all);
+            finalize_at_exit = true;
+        }
+    }
+
+    return it->second;
+}
+
+} // namespace
+
+namespace scord::detail {
+
+session::session(std::string protocol)
+    : m_protocol(std::move(protocol)),
+      m_client(m_protocol, use_progress_thread(), use_shared_memory()) {
+    configure_policies(m_client.policies());
+}
+
+std::string
+session::protocol() const {
+    return m_protocol;
+}
+
+std::optional<network::endpoint>
+session::lookup(const std::string& address) noexcept {
+    return m_client.lookup(address);
+}
+
+void
+session::invalidate(const std::string& address) noexcept {
+    m_client.invalidate(address);
+}
+
+std::shared_ptr<session>
+session::get(const std::string& protocol) {
+    std::lock_guard lock(registry_mutex);
+    return find_or_create(protocol).m_session;
+}
+
+std::shared_ptr<session>
+session::acquire(const std::string& protocol) {
+    std::lock_guard lock(registry_mutex);
+    auto& entry = find_or_create(protocol);
+    ++entry.m_handles;
+    return entry.m_session;
+}
+
+void
+session::release(const std::string& protocol) {
+
+    std::shared_ptr<session> s;
+
+    {
+        std::lock_guard lock(registry_mutex);
+
+        const auto it = registry().find(protocol);
+
+        if(it == registry().end() || --it->second.m_handles != 0) {
+            return;
+        }
+
+        // defer the (potentially slow) engine finalization until after
+        // the registry lock has been released
+        s = std::move(it->second.m_session);
+        registry().erase(it);
+    }
+}
+
+void
+session::release_all() {
+
+    registry_type sessions;
+
+    {
+        std::lock_guard lock(registry_mutex);
+        sessions.swap(registry());
+    }
+}
+
+} // namespace scord::detail
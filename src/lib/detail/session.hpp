@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright 2021-2022, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef SCORD_DETAIL_SESSION_HPP
+#define SCORD_DETAIL_SESSION_HPP
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <net/client.hpp>
+#include <net/endpoint.hpp>
+
+namespace scord::detail {
+
+/**
+ * A long-lived client session. A session owns a network engine for a
+ * given protocol (along with its cached endpoints) and is shared by all the
+ * API calls (and threads) that target servers reachable through that
+ * protocol.
+ *
+ * Sessions are created lazily by `session::get()` the first time a protocol
+ * is used and are kept alive until the process exits or the last explicit
+ * handle to them (see `scord::session` and `ADM_session_t`) is released.
+ */
+class session {
+
+public:
+    explicit session(std::string protocol);
+
+    session(const session&) = delete;
+    session&
+    operator=(const session&) = delete;
+
+    std::string
+    protocol() const;
+
+    std::optional<network::endpoint>
+    lookup(const std::string& address) noexcept;
+
+    void
+    invalidate(const std::string& address) noexcept;
+
+    /**
+     * Find the session for `protocol`, creating it if needed.
+     */
+    static std::shared_ptr<session>
+    get(const std::string& protocol);
+
+    /**
+     * Find the session for `protocol`, creating it if needed, and register
+     * an explicit handle to it.
+     */
+    static std::shared_ptr<session>
+    acquire(const std::string& protocol);
+
+    /**
+     * Drop an explicit handle to the session for `protocol`. When the last
+     * handle is dropped the session is removed from the registry, and its
+     * network engine is finalized as soon as no in-flight calls reference
+     * it.
+     */
+    static void
+    release(const std::string& protocol);
+
+    /**
+     * Remove all sessions from the registry. Called at exit so that
+     * network engines are finalized before the process tears down the
+     * libraries they depend on.
+     */
+    static void
+    release_all();
+
+private:
+    std::string m_protocol;
+    network::client m_client;
+};
+
+} // namespace scord::detail
+
+#endif // SCORD_DETAIL_SESSION_HPP
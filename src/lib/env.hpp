@@ -32,6 +32,12 @@ namespace scord::env {
 
 static constexpr auto LOG = ADD_PREFIX("LOG");
 static constexpr auto LOG_OUTPUT = ADD_PREFIX("LOG_OUTPUT");
+static constexpr auto SERVER_ADDRESS = ADD_PREFIX("SERVER_ADDRESS");
+static constexpr auto JOB_ID = ADD_PREFIX("JOB_ID");
+static constexpr auto RPC_TIMEOUT = ADD_PREFIX("RPC_TIMEOUT");
+static constexpr auto SHARED_MEMORY = ADD_PREFIX("SHARED_MEMORY");
+static constexpr auto PROGRESS_THREAD = ADD_PREFIX("PROGRESS_THREAD");
+static constexpr auto TRACE_FILE = ADD_PREFIX("TRACE_FILE");
 
 } // namespace scord::env
 
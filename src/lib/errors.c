@@ -40,6 +40,7 @@ const char* const adm_errlist[ADM_ERR_MAX + 1] = {
         [ADM_ENO_RESOURCES] = "No resources available",
         [ADM_ETIMEOUT] = "Timeout",
         [ADM_EOTHER] = "Undetermined error",
+        [ADM_EBUSY] = "Server busy, try again later",
 
         /* fallback */
         [ADM_ERR_MAX] = "Unknown error",
@@ -0,0 +1,249 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of the scord API.
+ *
+ * The scord API is free software: you can redistribute it and/or modify
+ * it under the terms of the Lesser GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The scord API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with the scord API.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ *****************************************************************************/
+
+#include <scord/scord-user.h>
+#include <scord/types.hpp>
+#include <logger/logger.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "detail/impl.hpp"
+#include "env.hpp"
+#include "types_private.h"
+
+namespace {
+
+/**
+ * The user API does not receive a server or job handle: both are inherited
+ * from the environment that the job scheduler (e.g. the Slurm plugin)
+ * defines for the application.
+ */
+struct user_context {
+    scord::server c_server;
+    scord::job c_job;
+};
+
+std::optional<user_context>
+get_user_context() {
+
+    const char* address = std::getenv(scord::env::SERVER_ADDRESS);
+    const char* job_id = std::getenv(scord::env::JOB_ID);
+
+    if(!address || !job_id) {
+        LOGGER_ERROR("{} and {} must be defined to use the scord user API",
+                     scord::env::SERVER_ADDRESS, scord::env::JOB_ID);
+        return {};
+    }
+
+    const std::string_view addr{address};
+    const auto pos = addr.find("://");
+
+    if(pos == std::string_view::npos) {
+        LOGGER_ERROR("Invalid scord server address: {}", addr);
+        return {};
+    }
+
+    char* end = nullptr;
+    const auto id = std::strtoull(job_id, &end, 10);
+
+    if(end == job_id || *end != '\0') {
+        LOGGER_ERROR("Invalid scord job id: {}", job_id);
+        return {};
+    }
+
+    scord::slurm_job_id slurm_id = 0;
+
+    if(const char* p = std::getenv("SLURM_JOB_ID"); p != nullptr) {
+        slurm_id = std::strtoull(p, nullptr, 10);
+    }
+
+    return user_context{
+            scord::server{std::string{addr.substr(0, pos)},
+                          std::string{addr}},
+            scord::job{id, slurm_id}};
+}
+
+constexpr bool
+is_terminal(scord::transfer_state::type state) {
+    return state != scord::transfer_state::type::queued &&
+           state != scord::transfer_state::type::running;
+}
+
+/**
+ * Ask the server for the state of `transfer`, blocking server-side for up to
+ * `timeout` if the transfer is still active. The server retains the final
+ * state of ended transfers, so those that it does not know about are
+ * reported as `no_such_entity`.
+ */
+tl::expected<scord::transfer_state::type, scord::error_code>
+wait_for_state(const user_context& ctx, const scord::transfer& transfer,
+               std::chrono::milliseconds timeout) {
+
+    const auto rv = scord::detail::wait_transfer(ctx.c_server, ctx.c_job,
+                                                 transfer, timeout);
+
+    if(!rv) {
+        return tl::make_unexpected(rv.error());
+    }
+
+    return rv->status();
+}
+
+} // namespace
+
+ADM_return_t
+ADM_transfer_datasets(ADM_dataset_t sources[], size_t sources_len,
+                      ADM_dataset_t targets[], size_t targets_len,
+                      ADM_transfer_t* transfer) {
+
+    if(!sources || !targets || !transfer) {
+        return ADM_EBADARGS;
+    }
+
+    const auto ctx = ::get_user_context();
+
+    if(!ctx) {
+        return ADM_EBADARGS;
+    }
+
+    std::vector<scord::dataset> src;
+    std::vector<scord::dataset> dst;
+    src.reserve(sources_len);
+    dst.reserve(targets_len);
+
+    for(size_t i = 0; i < sources_len; ++i) {
+        src.emplace_back(sources[i]);
+    }
+
+    for(size_t i = 0; i < targets_len; ++i) {
+        dst.emplace_back(targets[i]);
+    }
+
+    const auto rv = scord::detail::transfer_datasets(
+            ctx->c_server, ctx->c_job, src, dst, {},
+            scord::transfer::mapping::n_to_n);
+
+    if(!rv) {
+        return rv.error();
+    }
+
+    *transfer = static_cast<ADM_transfer_t>(rv.value());
+
+    return ADM_SUCCESS;
+}
+
+
+ADM_return_t
+ADM_transfer_wait(ADM_transfer_t transfer, ADM_transfer_status_t* status,
+                  struct timespec* timeout) {
+
+    using namespace std::chrono;
+
+    if(transfer == NULL || status == NULL) {
+        return ADM_EBADARGS;
+    }
+
+    if(timeout != NULL && (timeout->tv_sec < 0 || timeout->tv_nsec < 0)) {
+        return ADM_EBADARGS;
+    }
+
+    const auto ctx = ::get_user_context();
+
+    if(!ctx) {
+        return ADM_EBADARGS;
+    }
+
+    const scord::transfer tx{transfer};
+
+    // A NULL timeout means that we should just query the current state.
+    // Otherwise, the server parks the request until the transfer finishes
+    // or the timeout expires. Since the server caps how long a single
+    // request may be parked, keep asking until our own deadline expires.
+    const auto budget =
+            timeout == NULL
+                    ? milliseconds::zero()
+                    : duration_cast<milliseconds>(seconds{timeout->tv_sec} +
+                                                  nanoseconds{timeout->tv_nsec});
+    const auto deadline = steady_clock::now() + budget;
+
+    auto rv = ::wait_for_state(*ctx, tx, budget);
+
+    while(rv && !::is_terminal(rv.value())) {
+
+        const auto remaining =
+                duration_cast<milliseconds>(deadline - steady_clock::now());
+
+        if(remaining <= milliseconds::zero()) {
+            break;
+        }
+
+        rv = ::wait_for_state(*ctx, tx, remaining);
+    }
+
+    if(!rv) {
+        return rv.error();
+    }
+
+    *status = ADM_transfer_status_create(
+            static_cast<ADM_transfer_state_t>(rv.value()));
+
+    if(*status == NULL) {
+        return ADM_ENOMEM;
+    }
+
+    (*status)->s_error = rv.value() == scord::transfer_state::type::failed
+                                 ? ADM_EOTHER
+                                 : ADM_SUCCESS;
+
+    return ::is_terminal(rv.value()) ? ADM_SUCCESS : ADM_ETIMEOUT;
+}
+
+bool
+__adm_transfer_succeeded(ADM_transfer_status_t st) {
+    return st->s_state == ADM_TRANSFER_FINISHED && st->s_error == ADM_SUCCESS;
+}
+
+bool
+__adm_transfer_failed(ADM_transfer_status_t st) {
+    return (st->s_state == ADM_TRANSFER_FINISHED &&
+            st->s_error != ADM_SUCCESS) ||
+           st->s_state == ADM_TRANSFER_FAILED;
+}
+
+bool
+__adm_transfer_pending(ADM_transfer_status_t st) {
+    return st->s_state == ADM_TRANSFER_QUEUED;
+}
+
+bool
+__adm_transfer_in_progress(ADM_transfer_status_t st) {
+    return st->s_state == ADM_TRANSFER_RUNNING;
+}
+
+ADM_return_t
+__adm_transfer_error(ADM_transfer_status_t st) {
+    return st->s_error;
+}
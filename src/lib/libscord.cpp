@@ -27,7 +27,11 @@
 #include <utils/ctype_ptr.hpp>
 #include <env.hpp>
 #include <iostream>
+#include <unistd.h>
+#include <net/tracing.hpp>
 #include "detail/impl.hpp"
+#include "detail/async.hpp"
+#include "detail/session.hpp"
 
 
 namespace {
@@ -35,12 +39,28 @@ namespace {
 [[maybe_unused]] void
 init_library() __attribute__((constructor));
 
+[[maybe_unused]] void
+fini_library() __attribute__((destructor));
+
 void
 init_logger();
 
+void
+init_tracing();
+
 [[maybe_unused]] void
 init_library() {
     init_logger();
+    init_tracing();
+}
+
+[[maybe_unused]] void
+fini_library() {
+    // network engines are not finalized here: Margo may need to join its
+    // progress thread or talk to Argobots, which is unsafe once the dynamic
+    // loader has started running destructors. Sessions finalize their
+    // engines from an `atexit()` handler instead (see session.cpp)
+    network::tracing::disable();
 }
 
 /** Logging for the library */
@@ -67,6 +87,26 @@ init_logger() {
     }
 }
 
+/** RPC tracing for the library */
+void
+init_tracing() {
+
+    const auto trace_file = std::getenv(scord::env::TRACE_FILE);
+
+    if(!trace_file || std::string{trace_file}.empty()) {
+        return;
+    }
+
+    // several processes of the same job may share the environment, so each
+    // of them writes to its own file
+    const auto path = fmt::format("{}.{}", trace_file, ::getpid());
+
+    if(!network::tracing::enable(path)) {
+        std::cerr << fmt::format("WARNING: Error opening trace file: {}\n",
+                                 path);
+    }
+}
+
 
 #if 0
 void
@@ -200,6 +240,47 @@ rpc_registration_cb(scord::network::rpc_client* client) {
 
 namespace scord {
 
+class session::impl {
+
+public:
+    explicit impl(std::string protocol)
+        : m_protocol(std::move(protocol)),
+          m_session(detail::session::acquire(m_protocol)) {}
+
+    impl(const impl&) = delete;
+    impl&
+    operator=(const impl&) = delete;
+
+    ~impl() {
+        m_session.reset();
+        detail::session::release(m_protocol);
+    }
+
+    std::string
+    protocol() const {
+        return m_protocol;
+    }
+
+private:
+    std::string m_protocol;
+    std::shared_ptr<detail::session> m_session;
+};
+
+session::session(std::string protocol)
+    : m_pimpl(std::make_unique<session::impl>(std::move(protocol))) {}
+
+session::session(session&&) noexcept = default;
+
+session&
+session::operator=(session&&) noexcept = default;
+
+session::~session() = default;
+
+std::string
+session::protocol() const {
+    return m_pimpl->protocol();
+}
+
 void
 ping(const server& srv) {
     if(const auto rv = detail::ping(srv); !rv) {
@@ -208,6 +289,25 @@ ping(const server& srv) {
     }
 }
 
+std::string
+get_metrics(const server& srv) {
+    return detail::get_metrics(srv)
+            .or_else([](auto ec) {
+                throw std::runtime_error(fmt::format(
+                        "ADM_get_metrics() error: {}", ec.message()));
+            })
+            .value();
+}
+
+void
+set_log_level(const server& srv, const std::string& subsystem,
+              const std::string& level) {
+    if(const auto rv = detail::set_log_level(srv, subsystem, level); !rv) {
+        throw std::runtime_error(
+                fmt::format("ADM_set_log_level() error: {}", rv.message()));
+    }
+}
+
 job_info
 query(const server& srv, slurm_job_id id) {
     return detail::query(srv, id)
@@ -221,10 +321,10 @@ query(const server& srv, slurm_job_id id) {
 scord::job
 register_job(const server& srv, const job::resources& resources,
              const job::requirements& job_requirements,
-             scord::slurm_job_id slurm_job_id) {
+             scord::slurm_job_id slurm_job_id, const std::string& request_id) {
 
     const auto rv = detail::register_job(srv, resources, job_requirements,
-                                         slurm_job_id);
+                                         slurm_job_id, request_id);
 
     if(!rv) {
         throw std::runtime_error(fmt::format("ADM_register_job() error: {}",
@@ -320,6 +420,66 @@ terminate_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage) {
     }
 }
 
+scord::operation_id
+update_adhoc_storage_async(const server& srv, const adhoc_storage& adhoc_storage,
+                           const adhoc_storage::resources& new_resources) {
+
+    const auto rv = detail::update_adhoc_storage_async(srv, adhoc_storage,
+                                                       new_resources);
+
+    if(!rv) {
+        throw std::runtime_error(
+                fmt::format("ADM_update_adhoc_storage_async() error: {}",
+                            rv.error().message()));
+    }
+
+    return rv.value();
+}
+
+scord::operation_id
+deploy_adhoc_storage_async(const server& srv,
+                           const adhoc_storage& adhoc_storage) {
+
+    const auto rv = detail::deploy_adhoc_storage_async(srv, adhoc_storage);
+
+    if(!rv) {
+        throw std::runtime_error(
+                fmt::format("ADM_deploy_adhoc_storage_async() error: {}",
+                            rv.error().message()));
+    }
+
+    return rv.value();
+}
+
+scord::operation_id
+terminate_adhoc_storage_async(const server& srv,
+                              const adhoc_storage& adhoc_storage) {
+
+    const auto rv = detail::terminate_adhoc_storage_async(srv, adhoc_storage);
+
+    if(!rv) {
+        throw std::runtime_error(
+                fmt::format("ADM_terminate_adhoc_storage_async() error: {}",
+                            rv.error().message()));
+    }
+
+    return rv.value();
+}
+
+scord::operation_info
+wait_operation(const server& srv, scord::operation_id op_id,
+               std::chrono::milliseconds timeout) {
+
+    const auto rv = detail::wait_operation(srv, op_id, timeout);
+
+    if(!rv) {
+        throw std::runtime_error(fmt::format("ADM_wait_operation() error: {}",
+                                             rv.error().message()));
+    }
+
+    return rv.value();
+}
+
 scord::pfs_storage
 register_pfs_storage(const server& srv, const std::string& name,
                      enum pfs_storage::type type, const pfs_storage::ctx& ctx) {
@@ -364,10 +524,10 @@ transfer_datasets(const server& srv, const job& job,
                   const std::vector<dataset>& sources,
                   const std::vector<dataset>& targets,
                   const std::vector<qos::limit>& limits,
-                  transfer::mapping mapping) {
+                  transfer::mapping mapping, const std::string& request_id) {
 
     const auto rv = detail::transfer_datasets(srv, job, sources, targets,
-                                              limits, mapping);
+                                              limits, mapping, request_id);
 
     if(!rv) {
         throw std::runtime_error(fmt::format(
@@ -390,6 +550,85 @@ query_transfer(const server& srv, const job& job, const transfer& transfer) {
     return rv.value();
 }
 
+std::vector<scord::transfer_info>
+query_transfers(const server& srv, const job& job,
+                const std::vector<transfer>& transfers) {
+
+    const auto rv = detail::query_transfers(srv, job, transfers);
+
+    if(!rv) {
+        throw std::runtime_error(fmt::format("ADM_query_transfers() error: {}",
+                                             rv.error().message()));
+    }
+
+    return rv.value();
+}
+
+scord::transfer_state
+wait_transfer(const server& srv, const job& job, const transfer& transfer,
+              std::chrono::milliseconds timeout) {
+
+    const auto rv = detail::wait_transfer(srv, job, transfer, timeout);
+
+    if(!rv) {
+        throw std::runtime_error(fmt::format("ADM_wait_transfer() error: {}",
+                                             rv.error().message()));
+    }
+
+    return rv.value();
+}
+
+template <typename T>
+future<T>::future(std::shared_ptr<detail::pending_rpc<T>> rpc)
+    : m_rpc(std::move(rpc)) {}
+
+template <typename T>
+bool
+future<T>::ready() const {
+    return m_rpc->test();
+}
+
+template <typename T>
+void
+future<T>::wait() const {
+    m_rpc->wait();
+}
+
+template <typename T>
+T
+future<T>::get() const {
+
+    const auto rv = m_rpc->wait();
+
+    if(!rv) {
+        throw std::runtime_error(fmt::format("{}() error: {}", m_rpc->name(),
+                                             rv.error().message()));
+    }
+
+    return rv.value();
+}
+
+template class future<scord::transfer>;
+template class future<scord::transfer_state>;
+
+future<scord::transfer>
+transfer_datasets_async(const server& srv, const job& job,
+                        const std::vector<dataset>& sources,
+                        const std::vector<dataset>& targets,
+                        const std::vector<qos::limit>& limits,
+                        transfer::mapping mapping,
+                        const std::string& request_id) {
+    return future<scord::transfer>{detail::transfer_datasets_async(
+            srv, job, sources, targets, limits, mapping, request_id)};
+}
+
+future<scord::transfer_state>
+query_transfer_async(const server& srv, const job& job,
+                     const transfer& transfer) {
+    return future<scord::transfer_state>{
+            detail::query_transfer_async(srv, job, transfer)};
+}
+
 ADM_return_t
 set_dataset_information(const server& srv, ADM_job_t job, ADM_dataset_t target,
                         ADM_dataset_info_t info) {
@@ -43,7 +43,13 @@ extern "C" {
  * @param[in] targets The destination datasets.
  * @param[in] targets_len The number of destination datasets.
  * @param[out] transfer A transfer handle to query the operation status.
- * @return
+ *
+ * @remark The request is sent to the server defined in the
+ * `LIBSCORD_SERVER_ADDRESS` environment variable on behalf of the job defined
+ * in `LIBSCORD_JOB_ID`. Both are set up by the job scheduler plugin.
+ *
+ * @return ADM_SUCCESS if the transfer was successfully started. A specific
+ * ADM_E* error code otherwise.
  */
 ADM_return_t
 ADM_transfer_datasets(ADM_dataset_t sources[], size_t sources_len,
@@ -61,10 +67,14 @@ ADM_transfer_datasets(ADM_dataset_t sources[], size_t sources_len,
  * structure.
  * @param[out] timeout The maximum time to wait for the transfer to complete. If
  * NULL, query the transfer status and return immediately. If not NULL, wait for
- * the transfer to complete or the timeout to expire.
+ * the transfer to complete or the timeout to expire. The wait happens on the
+ * server side, so the caller is not required to poll.
  * @return ADM_SUCCESS if the transfer completed successfully. ADM_ETIMEOUT if
- * the transfer did not complete before the timeout expired. An
- * specifc ADM_E* error code otherwise.
+ * the transfer did not complete before the timeout expired. ADM_ENOENT if the
+ * server does not know about the transfer (e.g. an invalid handle). An specifc
+ * ADM_E* error code otherwise. Transfers that ended before calling this
+ * function (e.g. while the application was computing) are reported with
+ * their final state, since the server keeps it for a while after they end.
  */
 ADM_return_t
 ADM_transfer_wait(ADM_transfer_t transfer, ADM_transfer_status_t* status,
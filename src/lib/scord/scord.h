@@ -28,6 +28,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 #include <scord/types.h>
 
 #ifdef __cplusplus
@@ -51,6 +52,31 @@ extern "C" {
 /* Public prototypes                                                          */
 /******************************************************************************/
 
+/**
+ * Open a long-lived client session for a protocol.
+ *
+ * @remark Sessions are created lazily by all other API functions, so calling
+ * this function is optional. Opening a session explicitly allows paying the
+ * initialization cost of the network engine upfront.
+ *
+ * @remark Sessions need to be freed by calling ADM_session_destroy().
+ *
+ * @param[in] protocol The protocol that will be used to access servers.
+ * @return A valid ADM_session_t if successful or NULL in case of failure.
+ */
+ADM_session_t
+ADM_session_create(const char* protocol);
+
+/**
+ * Destroy a session created by ADM_session_create(). The network engine
+ * is finalized when the last session for its protocol is destroyed.
+ *
+ * @param[in] session A valid ADM_session_t
+ * @return ADM_SUCCESS or corresponding ADM error code
+ */
+ADM_return_t
+ADM_session_destroy(ADM_session_t session);
+
 /**
  * Send an RPC to a server to check if it's online.
  *
@@ -80,6 +106,32 @@ ADM_register_job(ADM_server_t server, ADM_job_resources_t res,
                  ADM_job_requirements_t reqs, uint64_t slurm_id,
                  ADM_job_t* job);
 
+/**
+ * Register a job and its requirements, identifying the request with a
+ * caller-supplied id.
+ *
+ * The server answers requests that reuse an id with the response of the
+ * first one instead of registering the job again. ADM_register_job()
+ * generates a new id on each call, so callers that may repeat the call
+ * themselves (e.g. a Slurm prolog that is run again) should use this
+ * function with an id that is stable across attempts.
+ *
+ * @param[in] server The server to which the request is directed
+ * @param[in] res The resources for the job.
+ * @param[in] reqs The requirements for the job.
+ * @param[in] slurm_id The SLURM_JOB_ID for the newly-registered job.
+ * @param[in] request_id A string identifying the request. If NULL or empty,
+ * a unique id is generated.
+ * @param[out] job An ADM_JOB referring to the newly-registered job.
+ * @return Returns ADM_SUCCESS if the remote procedure has completed
+ * successfully.
+ */
+ADM_return_t
+ADM_register_job_with_request_id(ADM_server_t server, ADM_job_resources_t res,
+                                 ADM_job_requirements_t reqs,
+                                 uint64_t slurm_id, const char* request_id,
+                                 ADM_job_t* job);
+
 /**
  * Update a registered job resources.
  *
@@ -174,6 +226,84 @@ ADM_return_t
 ADM_terminate_adhoc_storage(ADM_server_t server,
                             ADM_adhoc_storage_t adhoc_storage);
 
+/**
+ * Asynchronous version of ADM_update_adhoc_storage(). The function returns
+ * as soon as the server has accepted the operation, which then runs in the
+ * background.
+ *
+ * @param[in] server The server to which the request is directed
+ * @param[in] adhoc_storage An ADM_STORAGE referring to the adhoc storage
+ * instance of interest.
+ * @param[in] new_resources The new resources for the adhoc storage instance.
+ * @param[out] op_id An operation id that can be passed to
+ * ADM_wait_operation().
+ * @return Returns ADM_SUCCESS if the operation was successfully started.
+ */
+ADM_return_t
+ADM_update_adhoc_storage_async(ADM_server_t server,
+                               ADM_adhoc_storage_t adhoc_storage,
+                               ADM_adhoc_resources_t new_resources,
+                               uint64_t* op_id);
+
+/**
+ * Asynchronous version of ADM_deploy_adhoc_storage(). The function returns
+ * as soon as the server has accepted the operation, which then runs in the
+ * background.
+ *
+ * @param[in] server The server to which the request is directed
+ * @param[in] adhoc_storage An ADM_STORAGE referring to the adhoc storage
+ * instance of interest.
+ * @param[out] op_id An operation id that can be passed to
+ * ADM_wait_operation().
+ * @return Returns ADM_SUCCESS if the operation was successfully started.
+ */
+ADM_return_t
+ADM_deploy_adhoc_storage_async(ADM_server_t server,
+                               ADM_adhoc_storage_t adhoc_storage,
+                               uint64_t* op_id);
+
+/**
+ * Asynchronous version of ADM_terminate_adhoc_storage(). The function
+ * returns as soon as the server has accepted the operation, which then runs
+ * in the background.
+ *
+ * @param[in] server The server to which the request is directed
+ * @param[in] adhoc_storage An ADM_STORAGE referring to the adhoc storage
+ * instance of interest.
+ * @param[out] op_id An operation id that can be passed to
+ * ADM_wait_operation().
+ * @return Returns ADM_SUCCESS if the operation was successfully started.
+ */
+ADM_return_t
+ADM_terminate_adhoc_storage_async(ADM_server_t server,
+                                  ADM_adhoc_storage_t adhoc_storage,
+                                  uint64_t* op_id);
+
+/**
+ * Wait for an adhoc storage operation started with one of the
+ * ADM_*_adhoc_storage_async() functions to complete.
+ *
+ * @remark Results of completed operations are kept by the server for a
+ * limited amount of time, after which waiting on them returns ADM_ENOENT.
+ *
+ * @param[in] server The server to which the request is directed
+ * @param[in] op_id The operation id.
+ * @param[in] timeout The maximum time to wait for the operation to complete.
+ * If NULL, query the operation progress and return immediately.
+ * @param[out] op_retval The result of the operation if it has completed.
+ * @param[out] adhoc_storage_path For completed deployments, a
+ * dynamically-allocated string that will be set to the path where the adhoc
+ * storage system data will be stored. Can be NULL. The caller is responsible
+ * for freeing it.
+ * @return Returns ADM_SUCCESS if the operation has completed, ADM_ETIMEOUT if
+ * it did not complete before the timeout expired, or a specific ADM_E* error
+ * code otherwise.
+ */
+ADM_return_t
+ADM_wait_operation(ADM_server_t server, uint64_t op_id,
+                   const struct timespec* timeout, ADM_return_t* op_retval,
+                   char** adhoc_storage_path);
+
 /**
  * Register a PFS storage tier.
  *
@@ -241,8 +371,10 @@ ADM_remove_pfs_storage(ADM_server_t server, ADM_pfs_storage_t adhoc_storage);
  * @param[out] transfer A ADM_TRANSFER allowing clients to interact
  * with the transfer (e.g. wait for its completion, query its status, cancel it,
  * etc.
+ * @param[in] wait If true, block until the transfer ends.
  * @return Returns if the remote procedure has been completed
- * successfully or not.
+ * successfully or not. If `wait` is true, ADM_EOTHER is returned if the
+ * transfer failed or was cancelled.
  */
 ADM_return_t
 ADM_transfer_datasets(ADM_server_t server, ADM_job_t job,
@@ -251,6 +383,24 @@ ADM_transfer_datasets(ADM_server_t server, ADM_job_t job,
                       ADM_qos_limit_t limits[], size_t limits_len,
                       ADM_transfer_mapping_t mapping, ADM_transfer_t* transfer, bool wait);
 
+/**
+ * Version of ADM_transfer_datasets() that identifies the request with a
+ * caller-supplied id, so that a request repeated by the caller with the
+ * same id starts the transfer only once.
+ *
+ * @param[in] request_id A string identifying the request. If NULL or empty,
+ * a unique id is generated.
+ *
+ * See ADM_transfer_datasets() for the remaining arguments and the return
+ * value.
+ */
+ADM_return_t
+ADM_transfer_datasets_with_request_id(
+        ADM_server_t server, ADM_job_t job, ADM_dataset_t sources[],
+        size_t sources_len, ADM_dataset_t targets[], size_t targets_len,
+        ADM_qos_limit_t limits[], size_t limits_len,
+        ADM_transfer_mapping_t mapping, const char* request_id,
+        ADM_transfer_t* transfer, bool wait);
 
 ADM_return_t
 ADM_transfer_datasets_1(ADM_server_t server, ADM_job_t job,
@@ -259,6 +409,140 @@ ADM_transfer_datasets_1(ADM_server_t server, ADM_job_t job,
                       uint64_t limit, size_t limits_len,
                       ADM_transfer_mapping_t mapping, ADM_transfer_t* transfer, bool wait);
 
+/**
+ * Query the state of several transfers in a single round-trip.
+ *
+ * @param[in] server The server to which the request is directed
+ * @param[in] job An ADM_JOB identifying the originating job.
+ * @param[in] transfers An array of ADM_TRANSFERs to query.
+ * @param[in] transfers_len The number of ADM_TRANSFERs stored in transfers.
+ * @param[out] states An array of at least transfers_len elements where the
+ * state of each transfer will be stored.
+ * @param[out] errors An array of at least transfers_len elements where the
+ * result of querying each transfer will be stored (e.g. ADM_ENOENT if a
+ * transfer could not be found). Can be NULL.
+ * @return Returns ADM_SUCCESS if the remote procedure has completed
+ * successfully.
+ */
+ADM_return_t
+ADM_query_transfers(ADM_server_t server, ADM_job_t job,
+                    ADM_transfer_t transfers[], size_t transfers_len,
+                    ADM_transfer_state_t states[], ADM_return_t errors[]);
+
+/**
+ * Query the state of all the transfers of a job in a single round-trip.
+ *
+ * @remark Transfers that have finished or failed are reported for a limited
+ * time after they end, after which they are no longer listed.
+ *
+ * @param[in] server The server to which the request is directed
+ * @param[in] job An ADM_JOB identifying the originating job.
+ * @param[out] transfers An array where an ADM_TRANSFER for each of the job's
+ * transfers will be stored.
+ * @param[out] states An array where the state of each transfer will be
+ * stored.
+ * @param[in,out] transfers_len On input, the number of elements available
+ * in transfers and states. On output, the number of transfers the job has,
+ * which may exceed the input value: only the first elements that fit are
+ * stored.
+ * @return Returns ADM_SUCCESS if the remote procedure has completed
+ * successfully.
+ */
+ADM_return_t
+ADM_query_job_transfers(ADM_server_t server, ADM_job_t job,
+                        ADM_transfer_t transfers[],
+                        ADM_transfer_state_t states[], size_t* transfers_len);
+
+/**
+ * Asynchronous version of ADM_transfer_datasets(). The function returns as
+ * soon as the request has been sent to the server.
+ *
+ * @remark The request must be completed by calling ADM_wait(), which also
+ * frees it, or released with ADM_request_destroy(). The `transfer` output
+ * argument is only valid after ADM_wait() has returned ADM_SUCCESS and must
+ * remain accessible until then.
+ *
+ * @param[in] server The server to which the request is directed
+ * @param[in] job An ADM_JOB identifying the originating job.
+ * @param[in] sources An array of DATASETs identifying the source dataset/s
+ * to be transferred.
+ * @param[in] sources_len The number of DATASETs stored in sources.
+ * @param[in] targets An array of DATASETs identifying the destination
+ * dataset/s and its/their desired locations in a storage tier.
+ * @param[in] targets_len The number of DATASETs stored in targets.
+ * @param[in] limits An array of QOS_CONSTRAINTS that must be applied to
+ * the transfer.
+ * @param[in] limits_len The number of QOS_CONSTRAINTS stored in limits.
+ * @param[in] mapping A distribution strategy for the transfers.
+ * @param[out] transfer A ADM_TRANSFER allowing clients to interact
+ * with the transfer once the request completes.
+ * @param[out] request An ADM_REQUEST that can be used to test or wait for
+ * the completion of the request.
+ * @return Returns ADM_SUCCESS if the request has been sent successfully.
+ */
+ADM_return_t
+ADM_transfer_datasets_async(ADM_server_t server, ADM_job_t job,
+                            ADM_dataset_t sources[], size_t sources_len,
+                            ADM_dataset_t targets[], size_t targets_len,
+                            ADM_qos_limit_t limits[], size_t limits_len,
+                            ADM_transfer_mapping_t mapping,
+                            ADM_transfer_t* transfer, ADM_request_t* request);
+
+/**
+ * Asynchronously query the state of a transfer.
+ *
+ * @remark The request must be completed by calling ADM_wait(), which also
+ * frees it, or released with ADM_request_destroy(). The `state` output
+ * argument is only valid after ADM_wait() has returned ADM_SUCCESS and must
+ * remain accessible until then.
+ *
+ * @param[in] server The server to which the request is directed
+ * @param[in] job An ADM_JOB identifying the originating job.
+ * @param[in] transfer An ADM_TRANSFER identifying the transfer.
+ * @param[out] state The state of the transfer once the request completes.
+ * @param[out] request An ADM_REQUEST that can be used to test or wait for
+ * the completion of the request.
+ * @return Returns ADM_SUCCESS if the request has been sent successfully.
+ */
+ADM_return_t
+ADM_query_transfer_async(ADM_server_t server, ADM_job_t job,
+                         ADM_transfer_t transfer, ADM_transfer_state_t* state,
+                         ADM_request_t* request);
+
+/**
+ * Check whether an asynchronous request has completed without blocking.
+ *
+ * @param[in] request A valid ADM_REQUEST.
+ * @param[out] completed Set to true if the request has completed and
+ * ADM_wait() would not block.
+ * @return ADM_SUCCESS or corresponding ADM error code
+ */
+ADM_return_t
+ADM_test(ADM_request_t request, bool* completed);
+
+/**
+ * Wait for an asynchronous request to complete, fill in its output
+ * arguments and free it.
+ *
+ * @param[in] request A valid ADM_REQUEST.
+ * @return Returns ADM_SUCCESS if the remote procedure has completed
+ * successfully.
+ */
+ADM_return_t
+ADM_wait(ADM_request_t request);
+
+/**
+ * Free an asynchronous request without waiting for it to complete. The
+ * request's outcome is discarded and its output arguments are never
+ * filled in. Requests completed with ADM_wait() are already freed and must
+ * not be passed to this function.
+ *
+ * @param[in] request A valid ADM_REQUEST.
+ * @return ADM_SUCCESS or corresponding ADM error code
+ */
+ADM_return_t
+ADM_request_destroy(ADM_request_t request);
+
 /**
  * Sets the obtained bw for the transfer operation
  *
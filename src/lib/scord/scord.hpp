@@ -23,6 +23,8 @@
  *****************************************************************************/
 
 #include <scord/scord.h>
+#include <chrono>
+#include <memory>
 #include <string>
 #include <utility>
 #include "scord/types.hpp"
@@ -43,16 +45,98 @@
 
 namespace scord {
 
+/**
+ * A handle to the long-lived client session that the library uses to
+ * communicate with servers through a given protocol.
+ *
+ * The library creates sessions lazily, so using this class is never
+ * required. It is useful, however, to pay the cost of initializing the
+ * network engine upfront and to control when it is finalized: the session
+ * is released when the last handle referring to it is destroyed.
+ */
+class session {
+
+public:
+    explicit session(std::string protocol);
+    session(session&&) noexcept;
+    session&
+    operator=(session&&) noexcept;
+    ~session();
+
+    std::string
+    protocol() const;
+
+private:
+    class impl;
+    std::unique_ptr<impl> m_pimpl;
+};
+
+namespace detail {
+template <typename T>
+class pending_rpc;
+} // namespace detail
+
+/**
+ * A handle to the result of an asynchronous API call.
+ *
+ * Asynchronous calls return as soon as their request has been sent,
+ * which allows clients to keep many requests in flight at the same time.
+ * The result can be checked with `ready()` without blocking, or retrieved
+ * with `get()`, which blocks until the response arrives and throws if the
+ * remote procedure failed.
+ */
+template <typename T>
+class future {
+
+public:
+    explicit future(std::shared_ptr<detail::pending_rpc<T>> rpc);
+
+    bool
+    ready() const;
+
+    void
+    wait() const;
+
+    T
+    get() const;
+
+private:
+    std::shared_ptr<detail::pending_rpc<T>> m_rpc;
+};
+
 void
 ping(const server& srv);
 
+std::string
+get_metrics(const server& srv);
+
+/**
+ * Change the level of the messages logged by `subsystem` ("general", "rpc",
+ * "network", "scheduler" or "all") in a running scord or scord-ctl
+ * server to `level` ("trace", "debug", "info", "warning", "error",
+ * "critical" or "off").
+ */
+void
+set_log_level(const server& srv, const std::string& subsystem,
+              const std::string& level);
+
 job_info
 query(const server& srv, slurm_job_id job_id);
 
+/**
+ * Register a job and its requirements.
+ *
+ * The server uses `request_id` to recognize retries of the same request and
+ * answer them without registering the job again. If it is empty, a unique
+ * id is generated, which only deduplicates the retries made internally by
+ * this call. Callers that may replay the request themselves (e.g. a Slurm
+ * prolog that is run again) should supply an id that is stable across
+ * attempts.
+ */
 scord::job
 register_job(const server& srv, const job::resources& job_resources,
              const job::requirements& job_requirements,
-             scord::slurm_job_id slurm_id);
+             scord::slurm_job_id slurm_id, const std::string& request_id = {});
 
 void
 update_job(const server& srv, const job&, const job::resources& job_resources);
@@ -79,6 +163,31 @@ deploy_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage);
 void
 terminate_adhoc_storage(const server& srv, const adhoc_storage& adhoc_storage);
 
+/**
+ * The following functions start the corresponding adhoc storage operation
+ * in the background and return an operation id that can be passed to
+ * `wait_operation()` to wait for its completion or poll its progress.
+ */
+scord::operation_id
+update_adhoc_storage_async(const server& srv, const adhoc_storage& adhoc_storage,
+                           const adhoc_storage::resources& new_resources);
+
+scord::operation_id
+deploy_adhoc_storage_async(const server& srv,
+                           const adhoc_storage& adhoc_storage);
+
+scord::operation_id
+terminate_adhoc_storage_async(const server& srv,
+                              const adhoc_storage& adhoc_storage);
+
+/**
+ * Wait for up to `timeout` for the operation `op_id` to complete. A zero
+ * timeout just returns its current progress.
+ */
+scord::operation_info
+wait_operation(const server& srv, scord::operation_id op_id,
+               std::chrono::milliseconds timeout);
+
 scord::pfs_storage
 register_pfs_storage(const server& srv, const std::string& name,
                      enum scord::pfs_storage::type type,
@@ -91,16 +200,62 @@ update_pfs_storage(const server& srv, const pfs_storage& pfs_storage,
 void
 remove_pfs_storage(const server& srv, const pfs_storage& pfs_storage);
 
+/**
+ * Transfer datasets on behalf of `job`.
+ *
+ * As with register_job(), `request_id` lets the server recognize retries
+ * of the same request so that the transfer is only started once. If it is
+ * empty, a unique id is generated for this call.
+ */
 scord::transfer
 transfer_datasets(const server& srv, const job& job,
                   const std::vector<dataset>& sources,
                   const std::vector<dataset>& targets,
                   const std::vector<qos::limit>& limits,
-                  transfer::mapping mapping);
+                  transfer::mapping mapping,
+                  const std::string& request_id = {});
 
 scord::transfer_state
 query_transfer(const server& srv, const job& job, const transfer& transfer);
 
+/**
+ * Query the state of several transfers of a job in a single round-trip.
+ * If `transfers` is empty, information about all the transfers of `job`
+ * is returned. Transfers that could not be found are reported with a
+ * `no_such_entity` error code in their corresponding `transfer_info`.
+ */
+std::vector<scord::transfer_info>
+query_transfers(const server& srv, const job& job,
+                const std::vector<transfer>& transfers = {});
+
+/**
+ * Wait until a transfer reaches a terminal state (i.e. finished, failed or
+ * cancelled) or `timeout` expires, whatever happens first. The wait happens
+ * on the server side, which notifies the client as soon as the state of the
+ * transfer changes. Note that the server may cap the maximum timeout, so
+ * callers should always check the returned state. The server keeps the
+ * final state of a transfer for a while (10 minutes) after it ends, so
+ * waiting on a transfer that has already ended returns its outcome
+ * immediately.
+ *
+ * @return The state of the transfer when the wait completed.
+ */
+scord::transfer_state
+wait_transfer(const server& srv, const job& job, const transfer& transfer,
+              std::chrono::milliseconds timeout);
+
+future<scord::transfer>
+transfer_datasets_async(const server& srv, const job& job,
+                        const std::vector<dataset>& sources,
+                        const std::vector<dataset>& targets,
+                        const std::vector<qos::limit>& limits,
+                        transfer::mapping mapping,
+                        const std::string& request_id = {});
+
+future<scord::transfer_state>
+query_transfer_async(const server& srv, const job& job,
+                     const transfer& transfer);
+
 void
 transfer_update(const server& srv, uint64_t transfer_id, float obtained_bw);
 
@@ -56,6 +56,9 @@ typedef enum {
     ADM_ENO_RESOURCES,
     ADM_ETIMEOUT,
     ADM_EOTHER,
+    /* codes added after ADM_EOTHER go below so that the values of the
+     * existing ones do not change */
+    ADM_EBUSY,
     ADM_ERR_MAX = 512
 } ADM_return_t;
 
@@ -67,6 +70,12 @@ typedef enum {
 /** A RPC server */
 typedef struct adm_server* ADM_server_t;
 
+/** A client session */
+typedef struct adm_session* ADM_session_t;
+
+/** A handle to an asynchronous request */
+typedef struct adm_request* ADM_request_t;
+
 /** Node types */
 typedef enum {
     ADM_NODE_REGULAR,
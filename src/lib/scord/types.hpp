@@ -54,6 +54,7 @@ struct error_code {
     static const error_code subprocess_error;
     static const error_code no_resources;
     static const error_code timeout;
+    static const error_code busy;
     static const error_code other;
 
     constexpr error_code() : m_value(ADM_SUCCESS) {}
@@ -94,6 +95,7 @@ struct error_code {
             ADM_ERROR_CASE(ADM_ESUBPROCESS_ERROR);
             ADM_ERROR_CASE(ADM_ETIMEOUT);
             ADM_ERROR_CASE(ADM_EOTHER);
+            ADM_ERROR_CASE(ADM_EBUSY);
             ADM_ERROR_DEFAULT_MSG("INVALID_ERROR_VALUE");
         }
 #undef ADM_ERROR_CASE
@@ -128,11 +130,13 @@ constexpr error_code error_code::adhoc_dir_exists{ADM_EADHOC_DIR_EXISTS};
 constexpr error_code error_code::subprocess_error{ADM_ESUBPROCESS_ERROR};
 constexpr error_code error_code::no_resources{ADM_ENO_RESOURCES};
 constexpr error_code error_code::timeout{ADM_ETIMEOUT};
+constexpr error_code error_code::busy{ADM_EBUSY};
 constexpr error_code error_code::other{ADM_EOTHER};
 
 using job_id = std::uint64_t;
 using slurm_job_id = std::uint64_t;
 using transfer_id = std::uint64_t;
+using operation_id = std::uint64_t;
 
 namespace internal {
 struct job_metadata;
@@ -187,7 +191,11 @@ struct node {
     // after the declaration of the PIMPL class
     template <class Archive>
     void
-    serialize(Archive& ar);
+    save(Archive& ar) const;
+
+    template <class Archive>
+    void
+    load(Archive& ar);
 
 private:
     class impl;
@@ -605,6 +613,128 @@ private:
     std::unique_ptr<impl> m_pimpl;
 };
 
+/**
+ * @brief The result of querying a transfer with `query_transfers()`: the
+ * transfer's state and measured bandwidth or, if the transfer could not be
+ * found, the corresponding error.
+ */
+class transfer_info {
+
+public:
+    transfer_info() = default;
+    transfer_info(transfer_id id, scord::error_code ec)
+        : m_id(id), m_error_code(ec) {}
+    transfer_info(transfer_id id, transfer_state state, float bandwidth)
+        : m_id(id), m_state(std::move(state)), m_bandwidth(bandwidth) {}
+
+    transfer_id
+    id() const {
+        return m_id;
+    }
+
+    scord::error_code
+    error_code() const {
+        return m_error_code;
+    }
+
+    const transfer_state&
+    state() const {
+        return m_state;
+    }
+
+    /**
+     * @brief Get the last bandwidth measured for the transfer.
+     * @return The bandwidth in MB/s or a negative value if it has not been
+     * measured yet.
+     */
+    float
+    bandwidth() const {
+        return m_bandwidth;
+    }
+
+private:
+    friend class cereal::access;
+    template <class Archive>
+    void
+    serialize(Archive& ar) {
+        ar & m_id;
+        ar & m_error_code;
+        ar & m_state;
+        ar & m_bandwidth;
+    }
+
+    transfer_id m_id{};
+    scord::error_code m_error_code;
+    transfer_state m_state;
+    float m_bandwidth = -1.0f;
+};
+
+/**
+ * @brief The progress of an adhoc storage operation that runs in the
+ * background in the server (e.g. one started with
+ * `deploy_adhoc_storage_async()`).
+ */
+class operation_info {
+
+public:
+    enum class type : std::uint8_t { pending, running, completed };
+
+    operation_info() = default;
+    operation_info(operation_id id, type st, scord::error_code ec = {},
+                   std::string adhoc_dir = {})
+        : m_id(id), m_state(st), m_error_code(ec),
+          m_adhoc_dir(std::move(adhoc_dir)) {}
+
+    operation_id
+    id() const {
+        return m_id;
+    }
+
+    type
+    status() const {
+        return m_state;
+    }
+
+    bool
+    completed() const {
+        return m_state == type::completed;
+    }
+
+    /**
+     * @brief The result of the operation. Only meaningful once the operation
+     * has completed.
+     */
+    scord::error_code
+    error_code() const {
+        return m_error_code;
+    }
+
+    /**
+     * @brief The directory where the adhoc storage was deployed. Only
+     * meaningful for deployments that completed successfully.
+     */
+    const std::string&
+    adhoc_dir() const {
+        return m_adhoc_dir;
+    }
+
+private:
+    friend class cereal::access;
+    template <class Archive>
+    void
+    serialize(Archive& ar) {
+        ar & m_id;
+        ar & m_state;
+        ar & m_error_code;
+        ar & m_adhoc_dir;
+    }
+
+    operation_id m_id{};
+    type m_state = type::pending;
+    scord::error_code m_error_code;
+    std::string m_adhoc_dir;
+};
+
 namespace qos {
 
 enum class subclass : std::underlying_type<ADM_qos_class_t>::type {
@@ -683,7 +813,11 @@ struct limit {
     // after the declaration of the PIMPL class
     template <class Archive>
     void
-    serialize(Archive& ar);
+    save(Archive& ar) const;
+
+    template <class Archive>
+    void
+    load(Archive& ar);
 
 private:
     class impl;
@@ -712,7 +846,11 @@ struct dataset {
     // after the declaration of the PIMPL class
     template <class Archive>
     void
-    serialize(Archive& ar);
+    save(Archive& ar) const;
+
+    template <class Archive>
+    void
+    load(Archive& ar);
 
 private:
     class impl;
@@ -739,7 +877,11 @@ struct dataset_route {
 
     template <class Archive>
     void
-    serialize(Archive& ar);
+    save(Archive& ar) const;
+
+    template <class Archive>
+    void
+    load(Archive& ar);
 
 private:
     class impl;
@@ -1316,4 +1458,57 @@ struct fmt::formatter<scord::transfer_state> : fmt::formatter<std::string_view>
     }
 };
 
+template <>
+struct fmt::formatter<scord::transfer_info>
+    : fmt::formatter<std::string_view> {
+    // parse is inherited from formatter<string_view>.
+    template <typename FormatContext>
+    auto
+    format(const scord::transfer_info& ti, FormatContext& ctx) const
+            -> format_context::iterator {
+        const auto str =
+                ti.error_code()
+                        ? fmt::format("{{tx_id: {}, state: {}, bw: {}}}",
+                                      ti.id(), ti.state(), ti.bandwidth())
+                        : fmt::format("{{tx_id: {}, retval: {}}}", ti.id(),
+                                      ti.error_code());
+        return formatter<std::string_view>::format(str, ctx);
+    }
+};
+
+template <>
+struct fmt::formatter<scord::operation_info>
+    : fmt::formatter<std::string_view> {
+    // parse is inherited from formatter<string_view>.
+    template <typename FormatContext>
+    auto
+    format(const scord::operation_info& oi, FormatContext& ctx) const
+            -> format_context::iterator {
+
+        std::string_view state = "unknown";
+
+        switch(oi.status()) {
+            case scord::operation_info::type::pending:
+                state = "pending";
+                break;
+            case scord::operation_info::type::running:
+                state = "running";
+                break;
+            case scord::operation_info::type::completed:
+                state = "completed";
+                break;
+        }
+
+        const auto str =
+                oi.completed()
+                        ? fmt::format("{{op_id: {}, state: {}, retval: {}, "
+                                      "adhoc_dir: {:?}}}",
+                                      oi.id(), state, oi.error_code(),
+                                      oi.adhoc_dir())
+                        : fmt::format("{{op_id: {}, state: {}}}", oi.id(),
+                                      state);
+        return formatter<std::string_view>::format(str, ctx);
+    }
+};
+
 #endif // SCORD_TYPES_HPP
@@ -40,6 +40,38 @@ const char*
 ADM_strerror(ADM_return_t errnum);
 };
 
+namespace {
+
+/**
+ * Serialize a PIMPL in place rather than through cereal's std::unique_ptr
+ * support, which would add a validity flag to the wire format. A null
+ * PIMPL (e.g. that of a moved-from object) is sent as a default one.
+ */
+template <class Archive, typename Impl>
+inline void
+save_pimpl(Archive& ar, const std::unique_ptr<Impl>& pimpl) {
+    if(!pimpl) {
+        Impl{}.save(ar);
+        return;
+    }
+    pimpl->save(ar);
+}
+
+/**
+ * Deserialize a PIMPL in place, reusing the existing one (if any) instead
+ * of allocating a new PIMPL on every load.
+ */
+template <class Archive, typename Impl>
+inline void
+load_pimpl(Archive& ar, std::unique_ptr<Impl>& pimpl) {
+    if(!pimpl) {
+        pimpl = std::make_unique<Impl>();
+    }
+    pimpl->load(ar);
+}
+
+} // namespace
+
 namespace scord {
 
 std::string_view
@@ -163,11 +195,17 @@ node::get_type() const {
 }
 
 // since the PIMPL class is fully defined at this point, we can now
-// define the serialization function
+// define the serialization functions
 template <class Archive>
 inline void
-node::serialize(Archive& ar) {
-    ar(SCORD_SERIALIZATION_NVP(m_pimpl));
+node::save(Archive& ar) const {
+    ::save_pimpl(ar, m_pimpl);
+}
+
+template <class Archive>
+inline void
+node::load(Archive& ar) {
+    ::load_pimpl(ar, m_pimpl);
 }
 
 //  we must also explicitly instantiate our template functions for
@@ -181,11 +219,11 @@ node::impl::load<network::serialization::input_archive>(
         network::serialization::input_archive&);
 
 template void
-node::serialize<network::serialization::output_archive>(
-        network::serialization::output_archive&);
+node::save<network::serialization::output_archive>(
+        network::serialization::output_archive&) const;
 
 template void
-node::serialize<network::serialization::input_archive>(
+node::load<network::serialization::input_archive>(
         network::serialization::input_archive&);
 
 class job::impl {
@@ -618,11 +656,17 @@ dataset::id() const {
 }
 
 // since the PIMPL class is fully defined at this point, we can now
-// define the serialization function
+// define the serialization functions
 template <class Archive>
 inline void
-dataset::serialize(Archive& ar) {
-    ar(SCORD_SERIALIZATION_NVP(m_pimpl));
+dataset::save(Archive& ar) const {
+    ::save_pimpl(ar, m_pimpl);
+}
+
+template <class Archive>
+inline void
+dataset::load(Archive& ar) {
+    ::load_pimpl(ar, m_pimpl);
 }
 
 //  we must also explicitly instantiate our template functions for
@@ -636,11 +680,11 @@ dataset::impl::load<network::serialization::input_archive>(
         network::serialization::input_archive&);
 
 template void
-dataset::serialize<network::serialization::output_archive>(
-        network::serialization::output_archive&);
+dataset::save<network::serialization::output_archive>(
+        network::serialization::output_archive&) const;
 
 template void
-dataset::serialize<network::serialization::input_archive>(
+dataset::load<network::serialization::input_archive>(
         network::serialization::input_archive&);
 
 class dataset_route::impl {
@@ -722,11 +766,17 @@ dataset_route::destination() const {
 }
 
 // since the PIMPL class is fully defined at this point, we can now
-// define the serialization function
+// define the serialization functions
 template <class Archive>
 inline void
-dataset_route::serialize(Archive& ar) {
-    ar(SCORD_SERIALIZATION_NVP(m_pimpl));
+dataset_route::save(Archive& ar) const {
+    ::save_pimpl(ar, m_pimpl);
+}
+
+template <class Archive>
+inline void
+dataset_route::load(Archive& ar) {
+    ::load_pimpl(ar, m_pimpl);
 }
 
 //  we must also explicitly instantiate our template functions for
@@ -740,11 +790,11 @@ dataset_route::impl::load<network::serialization::input_archive>(
         network::serialization::input_archive&);
 
 template void
-dataset_route::serialize<network::serialization::output_archive>(
-        network::serialization::output_archive&);
+dataset_route::save<network::serialization::output_archive>(
+        network::serialization::output_archive&) const;
 
 template void
-dataset_route::serialize<network::serialization::input_archive>(
+dataset_route::load<network::serialization::input_archive>(
         network::serialization::input_archive&);
 
 adhoc_storage::resources::resources(std::vector<scord::node> nodes)
@@ -1438,11 +1488,17 @@ limit::value() const {
 }
 
 // since the PIMPL class is fully defined at this point, we can now
-// define the serialization function
+// define the serialization functions
 template <class Archive>
 inline void
-limit::serialize(Archive& ar) {
-    ar(SCORD_SERIALIZATION_NVP(m_pimpl));
+limit::save(Archive& ar) const {
+    ::save_pimpl(ar, m_pimpl);
+}
+
+template <class Archive>
+inline void
+limit::load(Archive& ar) {
+    ::load_pimpl(ar, m_pimpl);
 }
 
 //  we must also explicitly instantiate our template functions for
@@ -1456,11 +1512,11 @@ limit::impl::load<network::serialization::input_archive>(
         network::serialization::input_archive&);
 
 template void
-limit::serialize<network::serialization::output_archive>(
-        network::serialization::output_archive&);
+limit::save<network::serialization::output_archive>(
+        network::serialization::output_archive&) const;
 
 template void
-limit::serialize<network::serialization::input_archive>(
+limit::load<network::serialization::input_archive>(
         network::serialization::input_archive&);
 
 } // namespace qos
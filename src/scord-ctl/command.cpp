@@ -1,36 +1,138 @@
 #include <ranges>
-#include <regex>
-#include <cassert>
-#include <unistd.h>
-#include <sys/wait.h>
-#include <logger/logger.hpp>
+#include <algorithm>
+#include <cstdint>
 #include "command.hpp"
 
 
 namespace {
+
 /**
- * @brief Convert a vector of strings into a vector of C strings.
- * The returned vector is null-terminated.
+ * @brief Find the position of a keyword in `scord_ctl::command::keywords`.
+ *
+ * @param keyword The keyword to find.
  *
- * @note The const char* stored into the resulting vector are valid only as
- * long as the input vector is not modified or destroyed. The caller is
- * responsible for ensuring this.
+ * @return The index of the keyword.
+ */
+constexpr std::size_t
+keyword_index(std::string_view keyword) {
+    using scord_ctl::command;
+    return std::ranges::find(command::keywords, keyword) -
+           command::keywords.begin();
+}
+
+constexpr auto adhoc_id_kw = keyword_index("{ADHOC_ID}");
+constexpr auto adhoc_directory_kw = keyword_index("{ADHOC_DIRECTORY}");
+constexpr auto adhoc_nodes_kw = keyword_index("{ADHOC_NODES}");
+constexpr auto adhoc_nodes_file_kw = keyword_index("{ADHOC_NODES_FILE}");
+constexpr auto adhoc_nodes_ranged_kw = keyword_index("{ADHOC_NODES_RANGED}");
+
+/**
+ * @brief Compress a list of hostnames into a Slurm-style hostlist expression
+ * (e.g. `node[001-004,010],login1`). Hostnames are grouped by their prefix
+ * and the width of their numeric suffix, in order of first appearance.
+ * Hostnames without a numeric suffix are kept as they are.
  *
- * @param v Vector of strings.
+ * @param hostnames The hostnames to compress.
  *
- * @return Vector of C strings.
+ * @return The hostlist expression.
  */
-[[nodiscard]] std::unique_ptr<const char*[]>
-as_char_array(const std::vector<std::string>& v) {
+std::string
+ranged_hostlist(const std::vector<std::string>& hostnames) {
+
+    // numeric suffixes longer than this would not fit in a std::uint64_t
+    constexpr std::size_t max_width = 18;
+
+    struct group {
+        std::string prefix;
+        std::size_t width;
+        std::vector<std::uint64_t> ids;
+    };
+
+    std::vector<group> groups;
+    std::unordered_map<std::string, std::size_t> index;
+
+    for(const auto& hostname : hostnames) {
 
-    auto tmp = std::make_unique<const char*[]>(v.size() + 1);
-    tmp[v.size()] = nullptr;
+        const auto pos = hostname.find_last_not_of("0123456789");
+        const auto start = pos == std::string::npos ? 0 : pos + 1;
+        auto width = hostname.size() - start;
 
-    for(const auto i : std::views::iota(0u, v.size())) {
-        tmp[i] = v[i].c_str();
+        if(width > max_width) {
+            width = 0;
+        }
+
+        auto prefix = width == 0 ? hostname : hostname.substr(0, start);
+        auto key = prefix;
+        key += '\0';
+        key += std::to_string(width);
+
+        const auto [it, inserted] =
+                index.try_emplace(std::move(key), groups.size());
+
+        if(inserted) {
+            groups.push_back({std::move(prefix), width, {}});
+        }
+
+        if(width != 0) {
+            groups[it->second].ids.push_back(
+                    std::stoull(hostname.substr(start)));
+        }
     }
 
-    return tmp;
+    std::string result;
+
+    for(auto& [prefix, width, ids] : groups) {
+
+        if(!result.empty()) {
+            result += ',';
+        }
+
+        result += prefix;
+
+        if(width == 0) {
+            continue;
+        }
+
+        std::ranges::sort(ids);
+        const auto [first, last] = std::ranges::unique(ids);
+        ids.erase(first, last);
+
+        const auto id = [w = width](std::uint64_t n) {
+            return fmt::format("{:0{}}", n, w);
+        };
+
+        if(ids.size() == 1) {
+            result += id(ids.front());
+            continue;
+        }
+
+        result += '[';
+
+        for(std::size_t i = 0; i < ids.size();) {
+
+            auto j = i;
+            while(j + 1 < ids.size() && ids[j + 1] == ids[j] + 1) {
+                ++j;
+            }
+
+            if(i != 0) {
+                result += ',';
+            }
+
+            result += id(ids[i]);
+
+            if(j != i) {
+                result += '-';
+                result += id(ids[j]);
+            }
+
+            i = j + 1;
+        }
+
+        result += ']';
+    }
+
+    return result;
 }
 
 } // namespace
@@ -74,8 +176,18 @@ environment::end() const {
     return m_env.end();
 }
 
-command::command(std::string cmdline, std::optional<environment> env)
-    : m_cmdline(std::move(cmdline)), m_env(std::move(env)) {}
+command::command(std::string cmdline, std::optional<environment> env,
+                 std::optional<std::chrono::seconds> timeout,
+                 enum scope scope)
+    : m_cmdline(std::move(cmdline)), m_env(std::move(env)),
+      m_timeout(timeout), m_scope(scope), m_segments(parse(m_cmdline)) {}
+
+command::command(std::string cmdline, std::vector<segment> segments,
+                 std::optional<environment> env,
+                 std::optional<std::chrono::seconds> timeout,
+                 enum scope scope)
+    : m_cmdline(std::move(cmdline)), m_env(std::move(env)),
+      m_timeout(timeout), m_scope(scope), m_segments(std::move(segments)) {}
 
 const std::string&
 command::cmdline() const {
@@ -87,98 +199,151 @@ command::env() const {
     return m_env;
 }
 
-command
-command::eval(const std::string& adhoc_id,
-              const std::filesystem::path& adhoc_directory,
-              const std::vector<std::string>& adhoc_nodes) const {
-
-    // generate a regex from a map of key/value pairs
-    constexpr auto regex_from_map =
-            [](const std::map<std::string, std::string>& m) -> std::regex {
-        std::string result;
-        for(const auto& [key, value] : m) {
-            const auto escaped_key =
-                    std::regex_replace(key, std::regex{R"([{}])"}, R"(\$&)");
-            result += fmt::format("{}|", escaped_key);
-        }
-        result.pop_back();
-        return std::regex{result};
-    };
+const std::optional<std::chrono::seconds>&
+command::timeout() const {
+    return m_timeout;
+}
+
+enum command::scope
+command::scope() const {
+    return m_scope;
+}
 
-    const std::map<std::string, std::string> replacements{
-            {std::string{keywords.at(0)}, adhoc_id},
-            {std::string{keywords.at(1)}, adhoc_directory.string()},
-            {std::string{keywords.at(2)},
-             fmt::format("\"{}\"", fmt::join(adhoc_nodes, ","))}};
+std::vector<command::segment>
+command::parse(const std::string& cmdline) {
 
-    // make sure that we fail if we ever add a new keyword and forget to add
-    // a replacement for it
-    assert(replacements.size() == keywords.size());
+    std::vector<segment> segments;
+    std::string_view rest{cmdline};
+    std::string literal;
 
-    std::string result;
+    while(!rest.empty()) {
+
+        const auto it = std::ranges::find_if(keywords, [&](const auto& kw) {
+            return rest.starts_with(kw);
+        });
 
-    const auto re = regex_from_map(replacements);
-    auto it = std::sregex_iterator(m_cmdline.begin(), m_cmdline.end(), re);
-    auto end = std::sregex_iterator{};
+        if(it == keywords.end()) {
+            literal += rest.front();
+            rest.remove_prefix(1);
+            continue;
+        }
 
-    std::string::size_type last_pos = 0;
+        if(!literal.empty()) {
+            segments.push_back({segment::literal, std::move(literal)});
+            literal.clear();
+        }
 
-    for(; it != end; ++it) {
-        const auto& match = *it;
-        result += m_cmdline.substr(last_pos, match.position() - last_pos);
-        result += replacements.at(match.str());
-        last_pos = match.position() + match.length();
+        segments.push_back({static_cast<std::size_t>(it - keywords.begin()),
+                            std::string{*it}});
+        rest.remove_prefix(it->size());
     }
 
-    result += m_cmdline.substr(last_pos, m_cmdline.length() - last_pos);
+    if(!literal.empty()) {
+        segments.push_back({segment::literal, std::move(literal)});
+    }
 
-    return command{result, m_env};
+    return segments;
 }
 
 command
-command::eval(const std::string& adhoc_id,
-              const std::vector<std::string>& adhoc_nodes) const {
-
-    // generate a regex from a map of key/value pairs
-    constexpr auto regex_from_map =
-            [](const std::map<std::string, std::string>& m) -> std::regex {
-        std::string result;
-        for(const auto& [key, value] : m) {
-            const auto escaped_key =
-                    std::regex_replace(key, std::regex{R"([{}])"}, R"(\$&)");
-            result += fmt::format("{}|", escaped_key);
+command::expand(const keyword_values& values) const {
+
+    const auto text = [&](const segment& s) -> const std::string& {
+        if(s.keyword != segment::literal && values[s.keyword]) {
+            return *values[s.keyword];
         }
-        result.pop_back();
-        return std::regex{result};
+        return s.text;
     };
 
-    const std::map<std::string, std::string> replacements{
-            {std::string{keywords_malleability.at(0)}, adhoc_id},
-            {std::string{keywords_malleability.at(1)},
-             fmt::format("\"{}\"", fmt::join(adhoc_nodes, ","))}};
+    std::size_t length = 0;
 
-    // make sure that we fail if we ever add a new keyword and forget to add
-    // a replacement for it
-    assert(replacements.size() == keywords_malleability.size());
+    for(const auto& s : m_segments) {
+        length += text(s).size();
+    }
 
     std::string result;
+    result.reserve(length);
+
+    // expanded keywords become part of the surrounding literal text, while
+    // unexpanded ones are kept so that a later `eval()` can expand them
+    std::vector<segment> segments;
+    std::size_t literal_start = 0;
+
+    for(const auto& s : m_segments) {
+        if(s.keyword != segment::literal && !values[s.keyword]) {
+            if(literal_start != result.size()) {
+                segments.push_back(
+                        {segment::literal, result.substr(literal_start)});
+            }
+            segments.push_back(s);
+            result += s.text;
+            literal_start = result.size();
+            continue;
+        }
+        result += text(s);
+    }
+
+    if(literal_start != result.size()) {
+        segments.push_back({segment::literal, result.substr(literal_start)});
+    }
+
+    return command{std::move(result), std::move(segments), m_env, m_timeout,
+                   m_scope};
+}
 
-    const auto re = regex_from_map(replacements);
-    auto it = std::sregex_iterator(m_cmdline.begin(), m_cmdline.end(), re);
-    auto end = std::sregex_iterator{};
+bool
+command::uses(std::size_t keyword) const {
+    return std::ranges::any_of(m_segments, [&](const auto& s) {
+        return s.keyword == keyword;
+    });
+}
+
+command::keyword_values
+command::node_values(
+        const std::vector<std::string>& adhoc_nodes,
+        const std::optional<std::filesystem::path>& adhoc_nodes_file) const {
+
+    keyword_values values;
 
-    std::string::size_type last_pos = 0;
+    // node lists can be large: only build the ones the template refers to
+    if(uses(adhoc_nodes_kw)) {
+        values[adhoc_nodes_kw] =
+                fmt::format("\"{}\"", fmt::join(adhoc_nodes, ","));
+    }
+
+    if(uses(adhoc_nodes_ranged_kw)) {
+        values[adhoc_nodes_ranged_kw] = ::ranged_hostlist(adhoc_nodes);
+    }
 
-    for(; it != end; ++it) {
-        const auto& match = *it;
-        result += m_cmdline.substr(last_pos, match.position() - last_pos);
-        result += replacements.at(match.str());
-        last_pos = match.position() + match.length();
+    if(adhoc_nodes_file) {
+        values[adhoc_nodes_file_kw] = adhoc_nodes_file->string();
     }
 
-    result += m_cmdline.substr(last_pos, m_cmdline.length() - last_pos);
+    return values;
+}
+
+command
+command::eval(
+        const std::string& adhoc_id,
+        const std::filesystem::path& adhoc_directory,
+        const std::vector<std::string>& adhoc_nodes,
+        const std::optional<std::filesystem::path>& adhoc_nodes_file) const {
+
+    auto values = node_values(adhoc_nodes, adhoc_nodes_file);
+    values[adhoc_id_kw] = adhoc_id;
+    values[adhoc_directory_kw] = adhoc_directory.string();
+    return expand(values);
+}
 
-    return command{result, m_env};
+command
+command::eval(
+        const std::string& adhoc_id,
+        const std::vector<std::string>& adhoc_nodes,
+        const std::optional<std::filesystem::path>& adhoc_nodes_file) const {
+
+    auto values = node_values(adhoc_nodes, adhoc_nodes_file);
+    values[adhoc_id_kw] = adhoc_id;
+    return expand(values);
 }
 
 std::vector<std::string>
@@ -195,111 +360,5 @@ command::as_vector() const {
 
     return tmp;
 }
-// Function to join two sets of environment variables
-char**
-joinEnvironments(char** env1, const char** env2) {
-    // Count the number of variables in each environment
-    int count1 = 0;
-    while(env1[count1] != nullptr) {
-        ++count1;
-    }
-
-    int count2 = 0;
-    while(env2[count2] != nullptr) {
-        ++count2;
-    }
-
-    // Allocate memory for the combined environment
-    char** combinedEnv = new char*[count1 + count2 + 1];
-
-    // Copy the variables from the first environment
-    for(int i = 0; i < count1; ++i) {
-        combinedEnv[i] = strdup(env1[i]);
-    }
-
-    // Copy the variables from the second environment
-    for(int i = 0; i < count2; ++i) {
-        combinedEnv[count1 + i] = strdup(env2[i]);
-    }
-
-    // Null-terminate the combined environment
-    combinedEnv[count1 + count2] = nullptr;
-
-    return combinedEnv;
-}
-
-void
-command::exec() const {
-
-    const auto envs = m_env.value_or(environment{}).as_vector();
-    const auto args = this->as_vector();
-
-    const auto argv = ::as_char_array(args);
-    const auto envp = ::as_char_array(envs);
-
-    switch(const auto pid = ::fork()) {
-        case 0: {
-
-            // Join the environments
-            char** combinedEnv = joinEnvironments(environ, envp.get());
-            ::execvpe(argv[0], const_cast<char* const*>(argv.get()),
-                      const_cast<char* const*>(combinedEnv));
-            // We cannot use the default logger in the child process because it
-            // is not fork-safe, and even though we received a copy of the
-            // global logger, it is not valid because the child process does
-            // not have the same threads as the parent process.
-            // Instead, we create a new logger with the same configuration as
-            // the global logger, and use it to log the error. This new logger
-            // must be synchronous to avoid issues with accessing the
-            // (existing but invalid) internal thread pool of the global logger.
-            const auto msg = fmt::format("Failed to execute command: {}",
-                                         ::strerror(errno));
-            if(const auto logger = logger::get_default_logger(); logger) {
-                auto cfg = logger->config();
-                logger::sync_logger lg{cfg};
-                lg.error("{}", msg);
-            } else {
-                fmt::print(stderr, "{}", msg);
-            }
-
-            // We cannot call ::exit() here because it will attempt to destruct
-            // the global logger, and as we mentioned the global logger in
-            // the child process contains the same information as the global
-            // logger of the parent process, but without the proper threads
-            // (since fork() only copies the calling thread). Thus, attempting
-            // to call its destructor will end up hanging the process while it
-            // tries to join() a non-existing thread. Instead, we call ::_exit()
-            // which will terminate the process without calling any functions
-            // registered with atexit() or similar. This is safe because we know
-            // the process is about to be destroyed anyway...
-            ::_exit(EXIT_FAILURE);
-        }
-        case -1:
-            throw std::runtime_error{fmt::format(
-                    "Failed to create subprocess: {}", ::strerror(errno))};
-        default: {
-            int wstatus = 0;
-            do {
-                if(const auto retwait = ::waitpid(pid, &wstatus, 0);
-                   retwait == -1) {
-                    throw std::runtime_error{
-                            fmt::format("Failed to wait for subprocess: {}",
-                                        ::strerror(errno))};
-                }
-
-                if(!WIFEXITED(wstatus)) {
-                    throw std::runtime_error{
-                            "Subprocess did not exit normally"};
-                }
-
-                if(WEXITSTATUS(wstatus) != 0) {
-                    throw std::runtime_error{
-                            fmt::format("Subprocess exited with status {}",
-                                        WEXITSTATUS(wstatus))};
-                }
-            } while(!WIFEXITED(wstatus));
-        }
-    }
-}
 
 } // namespace scord_ctl
@@ -25,7 +25,10 @@
 #ifndef SCORD_CTL_COMMAND_HPP
 #define SCORD_CTL_COMMAND_HPP
 
+#include <array>
+#include <chrono>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <optional>
@@ -106,20 +109,35 @@ public:
      * @brief Keywords that can be used in the command line and
      * will be expanded with appropriate values when calling `eval()`.
      */
-    static constexpr std::array<std::string_view, 3> keywords = {
-            "{ADHOC_ID}", "{ADHOC_DIRECTORY}", "{ADHOC_NODES}"};
+    static constexpr std::array<std::string_view, 5> keywords = {
+            "{ADHOC_ID}", "{ADHOC_DIRECTORY}", "{ADHOC_NODES}",
+            "{ADHOC_NODES_FILE}", "{ADHOC_NODES_RANGED}"};
+
+    /**
+     * @brief Where a command should be run.
+     */
+    enum class scope {
+        // once, by the scord-ctl that receives the request
+        job,
+        // on every node of the adhoc storage instance, by the scord-ctl
+        // running on it
+        node
+    };
 
-    static constexpr std::array<std::string_view, 2> keywords_malleability = {
-            "{ADHOC_ID}", "{ADHOC_NODES}"};
     /**
      * @brief Construct a command.
      *
      * @param cmdline The command line to be executed.
      * @param env The environment variables to be set when executing the
      * command.
+     * @param timeout The maximum time the command is allowed to run for, if
+     * any.
+     * @param scope Where the command should be run.
      */
-    explicit command(std::string cmdline,
-                     std::optional<environment> env = std::nullopt);
+    explicit command(
+            std::string cmdline, std::optional<environment> env = std::nullopt,
+            std::optional<std::chrono::seconds> timeout = std::nullopt,
+            enum scope scope = scope::job);
 
     /**
      * @brief Get the template command line to be executed (i.e. without having
@@ -139,6 +157,23 @@ public:
     const std::optional<environment>&
     env() const;
 
+    /**
+     * @brief Get the maximum time the command is allowed to run for.
+     *
+     * @return The timeout of the command, or std::nullopt if it may run
+     * indefinitely.
+     */
+    const std::optional<std::chrono::seconds>&
+    timeout() const;
+
+    /**
+     * @brief Get where the command should be run.
+     *
+     * @return The scope of the command.
+     */
+    enum scope
+    scope() const;
+
     /**
      * @brief Return a copy of the current `command` where all the keywords in
      * its command line template have been replaced with string
@@ -147,12 +182,16 @@ public:
      * @param adhoc_id The ID of the adhoc storage system.
      * @param adhoc_directory The directory where the adhoc storage will run.
      * @param adhoc_nodes The nodes where the adhoc storage will run.
+     * @param adhoc_nodes_file A file listing `adhoc_nodes`, one per line. If
+     * not provided, `{ADHOC_NODES_FILE}` is left unexpanded.
      * @return The evaluated command.
      */
     command
     eval(const std::string& adhoc_id,
          const std::filesystem::path& adhoc_directory,
-         const std::vector<std::string>& adhoc_nodes) const;
+         const std::vector<std::string>& adhoc_nodes,
+         const std::optional<std::filesystem::path>& adhoc_nodes_file =
+                 std::nullopt) const;
 
 
     /**
@@ -160,13 +199,19 @@ public:
      * its command line template have been replaced with string
      * representations of the arguments provided.
      *
+     * `{ADHOC_DIRECTORY}` is left unexpanded.
+     *
      * @param adhoc_id The ID of the adhoc storage system.
      * @param adhoc_nodes The nodes where the adhoc storage will run.
+     * @param adhoc_nodes_file A file listing `adhoc_nodes`, one per line. If
+     * not provided, `{ADHOC_NODES_FILE}` is left unexpanded.
      * @return The evaluated command.
      */
     command
     eval(const std::string& adhoc_id,
-         const std::vector<std::string>& adhoc_nodes) const;
+         const std::vector<std::string>& adhoc_nodes,
+         const std::optional<std::filesystem::path>& adhoc_nodes_file =
+                 std::nullopt) const;
 
     /**
      * @brief Get the command line to be executed as a vector of strings. The
@@ -178,15 +223,54 @@ public:
     std::vector<std::string>
     as_vector() const;
 
+private:
     /**
-     * @brief Execute the command and wait for it to finish.
+     * @brief A piece of the command line template: either literal text or
+     * one of the `keywords`.
      */
-    void
-    exec() const;
+    struct segment {
+        static constexpr std::size_t literal = keywords.size();
+
+        // index of the keyword in `keywords`, or `literal`
+        std::size_t keyword;
+        std::string text;
+    };
+
+    // the value of each keyword, or std::nullopt to leave it unexpanded
+    using keyword_values =
+            std::array<std::optional<std::string>, keywords.size()>;
+
+    /**
+     * @brief Construct a command from an already parsed command line, e.g.
+     * one produced by `expand()`. Keywords appearing in the text of literal
+     * segments (e.g. in the values substituted for other keywords) are not
+     * expanded later on.
+     */
+    command(std::string cmdline, std::vector<segment> segments,
+            std::optional<environment> env,
+            std::optional<std::chrono::seconds> timeout, enum scope scope);
+
+    static std::vector<segment>
+    parse(const std::string& cmdline);
+
+    bool
+    uses(std::size_t keyword) const;
+
+    keyword_values
+    node_values(const std::vector<std::string>& adhoc_nodes,
+                const std::optional<std::filesystem::path>& adhoc_nodes_file)
+            const;
+
+    command
+    expand(const keyword_values& values) const;
 
-private:
     std::string m_cmdline;
     std::optional<environment> m_env;
+    std::optional<std::chrono::seconds> m_timeout;
+    enum scope m_scope;
+    // the command line template split into segments, so that evaluating it
+    // does not need to search for keywords again
+    std::vector<segment> m_segments;
 };
 
 } // namespace scord_ctl
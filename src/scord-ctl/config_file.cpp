@@ -30,6 +30,7 @@
 #include <fmt/ostream.h>
 #include <fstream>
 #include "config_file.hpp"
+#include "defaults.hpp"
 
 namespace {
 
@@ -132,6 +133,8 @@ parse_environment_node(const ryml::ConstNodeRef& node) {
  *    <key>: <value>
  *    ...
  *  command: <value>
+ *  timeout: <seconds> (optional)
+ *  scope: job|node (optional)
  *
  * @param node The ryml node to parse.
  *
@@ -142,6 +145,8 @@ parse_command_node(const ryml::ConstNodeRef& node) {
 
     std::string cmdline;
     std::optional<scord_ctl::environment> env;
+    std::optional<std::chrono::seconds> timeout;
+    auto scope = scord_ctl::command::scope::job;
 
     for(const auto& child : node) {
         if(!child.has_key()) {
@@ -156,6 +161,23 @@ parse_command_node(const ryml::ConstNodeRef& node) {
             }
             cmdline = ::to_string(child.val());
             ::validate_command(cmdline);
+        } else if(child.key() == "timeout") {
+            std::chrono::seconds::rep value;
+            if(child.val_is_null() || !c4::atoi(child.val(), &value) ||
+               value <= 0) {
+                throw std::runtime_error{
+                        "`timeout` key must be a positive number of seconds"};
+            }
+            timeout = std::chrono::seconds{value};
+        } else if(child.key() == "scope") {
+            if(child.val() == "job") {
+                scope = scord_ctl::command::scope::job;
+            } else if(child.val() == "node") {
+                scope = scord_ctl::command::scope::node;
+            } else {
+                throw std::runtime_error{
+                        "`scope` key must be either `job` or `node`"};
+            }
         } else {
             fmt::print(stderr, "WARNING: Unknown key: '{}'. Ignored.\n",
                        child.key().data());
@@ -166,7 +188,151 @@ parse_command_node(const ryml::ConstNodeRef& node) {
         throw std::runtime_error{"missing required `command` key"};
     }
 
-    return scord_ctl::command{cmdline, env};
+    return scord_ctl::command{cmdline, env, timeout, scope};
+}
+
+/**
+ * @brief Parse a ryml node into a `scord_ctl::probe` object.
+ *
+ * The node is expected to be a map with exactly one of the following keys:
+ *  file: <path>
+ *  socket: <path>|<host>:<port>
+ *  command: <value>
+ *  log: <path>
+ *  contains: <text> (required with `log`)
+ *
+ * @param node The ryml node to parse.
+ * @param timeout The maximum time allowed for a `command` probe.
+ *
+ * @return The parsed `scord_ctl::probe` object.
+ */
+scord_ctl::probe
+parse_probe_node(const ryml::ConstNodeRef& node,
+                 std::chrono::seconds timeout) {
+
+    using scord_ctl::probe;
+
+    std::optional<probe::type> type;
+    std::string target;
+    std::string pattern;
+
+    for(const auto& child : node) {
+        if(!child.has_key()) {
+            continue;
+        }
+
+        std::optional<probe::type> child_type;
+
+        if(child.key() == "file") {
+            child_type = probe::type::file;
+        } else if(child.key() == "socket") {
+            child_type = probe::type::socket;
+        } else if(child.key() == "command") {
+            child_type = probe::type::command;
+        } else if(child.key() == "log") {
+            child_type = probe::type::log;
+        } else if(child.key() == "contains") {
+            if(child.val_is_null()) {
+                throw std::runtime_error{"`contains` key cannot be empty"};
+            }
+            pattern = ::to_string(child.val());
+            continue;
+        } else {
+            fmt::print(stderr, "WARNING: Unknown key: '{}'. Ignored.\n",
+                       child.key().data());
+            continue;
+        }
+
+        if(type) {
+            throw std::runtime_error{
+                    "readiness probes must have exactly one of `file`, "
+                    "`socket`, `command` or `log`"};
+        }
+
+        if(child.val_is_null()) {
+            throw std::runtime_error{fmt::format("`{}` key cannot be empty",
+                                                 ::to_string(child.key()))};
+        }
+
+        type = child_type;
+        target = ::to_string(child.val());
+    }
+
+    if(!type) {
+        throw std::runtime_error{
+                "readiness probes must have exactly one of `file`, "
+                "`socket`, `command` or `log`"};
+    }
+
+    if(*type == probe::type::log && pattern.empty()) {
+        throw std::runtime_error{"`log` probes require a `contains` key"};
+    }
+
+    if(*type == probe::type::command) {
+        ::validate_command(target);
+        return probe{*type,
+                     scord_ctl::command{target, std::nullopt, timeout}};
+    }
+
+    return probe{*type, scord_ctl::command{target}, pattern};
+}
+
+/**
+ * @brief Parse a ryml node into a `scord_ctl::readiness_check` object.
+ *
+ * The node is expected to be a map with the following structure:
+ *  timeout: <seconds> (optional)
+ *  probes:
+ *    - <probe>
+ *    ...
+ *
+ * @param node The ryml node to parse.
+ *
+ * @return The parsed `scord_ctl::readiness_check` object.
+ */
+scord_ctl::readiness_check
+parse_readiness_node(const ryml::ConstNodeRef& node) {
+
+    auto timeout = scord_ctl::config::defaults::readiness_timeout;
+
+    // the timeout also bounds `command` probes, so read it first
+    for(const auto& child : node) {
+        if(child.has_key() && child.key() == "timeout") {
+            std::chrono::seconds::rep value;
+            if(child.val_is_null() || !c4::atoi(child.val(), &value) ||
+               value <= 0) {
+                throw std::runtime_error{
+                        "`timeout` key must be a positive number of seconds"};
+            }
+            timeout = std::chrono::seconds{value};
+        }
+    }
+
+    std::vector<scord_ctl::probe> probes;
+
+    for(const auto& child : node) {
+        if(!child.has_key() || child.key() == "timeout") {
+            continue;
+        }
+
+        if(child.key() == "probes") {
+            if(!child.is_seq()) {
+                throw std::runtime_error{"`probes` key must be a list"};
+            }
+            for(const auto& item : child) {
+                probes.emplace_back(::parse_probe_node(item, timeout));
+            }
+        } else {
+            fmt::print(stderr, "WARNING: Unknown key: '{}'. Ignored.\n",
+                       child.key().data());
+        }
+    }
+
+    if(probes.empty()) {
+        throw std::runtime_error{"`readiness` requires at least one probe"};
+    }
+
+    return scord_ctl::readiness_check{std::move(probes), timeout};
 }
 
 /**
@@ -186,6 +352,8 @@ parse_command_node(const ryml::ConstNodeRef& node) {
  *        <key>: <value>
  *        ...
  *      command: <value>
+ *    readiness: (optional)
+ *      <readiness_check>
  *
  * @param node The ryml node to parse.
  * @param tag  A tag to dispatch the parsing to the correct overload.
@@ -200,7 +368,7 @@ parse_adhoc_config_node(const ryml::ConstNodeRef& node) {
     std::optional<scord_ctl::command> shutdown_command;
     std::optional<scord_ctl::command> expand_command;
     std::optional<scord_ctl::command> shrink_command;
-
+    std::optional<scord_ctl::readiness_check> readiness;
 
     for(const auto& child : node) {
 
@@ -222,6 +390,8 @@ parse_adhoc_config_node(const ryml::ConstNodeRef& node) {
             expand_command = ::parse_command_node(child);
         } else if(child.key() == "shrink") {
             shrink_command = ::parse_command_node(child);
+        } else if(child.key() == "readiness") {
+            readiness = ::parse_readiness_node(child);
         } else {
             fmt::print(stderr, "WARNING: Unknown key: '{}'. Ignored.\n",
                        child.key().data());
@@ -233,7 +403,7 @@ parse_adhoc_config_node(const ryml::ConstNodeRef& node) {
     }
 
     return {working_directory, *startup_command, *shutdown_command,
-            *expand_command, *shrink_command};
+            *expand_command, *shrink_command, readiness};
 }
 
 /**
@@ -314,12 +484,13 @@ namespace scord_ctl::config {
 adhoc_storage_config::adhoc_storage_config(
         std::filesystem::path working_directory, command startup_command,
         command shutdown_command, command expand_command,
-        command shrink_command)
+        command shrink_command, std::optional<readiness_check> readiness)
     : m_working_directory(std::move(working_directory)),
       m_startup_command(std::move(startup_command)),
       m_shutdown_command(std::move(shutdown_command)),
       m_expand_command(std::move(expand_command)),
-      m_shrink_command(std::move(shrink_command)) {}
+      m_shrink_command(std::move(shrink_command)),
+      m_readiness(std::move(readiness)) {}
 
 const std::filesystem::path&
 adhoc_storage_config::working_directory() const {
@@ -346,6 +517,11 @@ adhoc_storage_config::shrink_command() const {
     return m_shrink_command;
 }
 
+const std::optional<readiness_check>&
+adhoc_storage_config::readiness() const {
+    return m_readiness;
+}
+
 config_file::config_file(const std::filesystem::path& path) {
     std::ifstream input{path};
 
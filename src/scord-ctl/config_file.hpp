@@ -28,7 +28,9 @@
 
 #include <scord/types.hpp>
 #include <filesystem>
+#include <optional>
 #include "command.hpp"
+#include "readiness.hpp"
 
 namespace scord_ctl::config {
 
@@ -50,10 +52,14 @@ public:
      * storage.
      * @param shrink_command The command to be executed to shrink the adhoc
      * storage.
+     * @param readiness The probes that must succeed after the startup command
+     * before the adhoc storage is considered ready.
      */
-    adhoc_storage_config(std::filesystem::path working_directory,
-                         command startup_command, command shutdown_command,
-                         command expand_command, command shrink_command);
+    adhoc_storage_config(
+            std::filesystem::path working_directory, command startup_command,
+            command shutdown_command, command expand_command,
+            command shrink_command,
+            std::optional<readiness_check> readiness = std::nullopt);
 
     /**
      * @brief Get the directory where the adhoc storage will run.
@@ -97,12 +103,21 @@ public:
     const command&
     shrink_command() const;
 
+    /**
+     * @brief Get the readiness probes of the adhoc storage, if any.
+     *
+     * @return The readiness probes of the adhoc storage.
+     */
+    const std::optional<readiness_check>&
+    readiness() const;
+
 private:
     std::filesystem::path m_working_directory;
     command m_startup_command;
     command m_shutdown_command;
     command m_expand_command;
     command m_shrink_command;
+    std::optional<readiness_check> m_readiness;
 };
 
 #if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 11
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include <algorithm>
+#include <fmt/format.h>
+#include "fanout.hpp"
+
+namespace scord_ctl {
+
+std::string
+peer_address(std::string_view listen_address, std::string_view hostname) {
+
+    // composite addresses list one address per transport, separated by `#`:
+    // the network one comes last
+    if(const auto pos = listen_address.rfind('#');
+       pos != std::string_view::npos) {
+        listen_address.remove_prefix(pos + 1);
+    }
+
+    const auto sep = listen_address.find("://");
+
+    if(sep == std::string_view::npos) {
+        return fmt::format("{}://{}", listen_address, hostname);
+    }
+
+    // Mercury may report the provider stack, e.g. `ofi+tcp;ofi_rxm`
+    auto protocol = listen_address.substr(0, sep);
+    protocol = protocol.substr(0, protocol.find(';'));
+
+    const auto host = listen_address.substr(sep + 3);
+    const auto port = host.rfind(':');
+
+    return fmt::format("{}://{}{}", protocol, hostname,
+                       port == std::string_view::npos ? std::string_view{}
+                                                      : host.substr(port));
+}
+
+std::vector<std::pair<std::uint32_t, std::uint32_t>>
+split_subtrees(std::uint32_t first, std::uint32_t last, std::uint32_t degree) {
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> subtrees;
+
+    if(first >= last || degree == 0) {
+        return subtrees;
+    }
+
+    const auto n = last - first;
+    const auto count = std::min(n, degree);
+    subtrees.reserve(count);
+
+    for(std::uint32_t i = 0; i < count; ++i) {
+        const auto begin = first + static_cast<std::uint32_t>(
+                                           std::uint64_t{n} * i / count);
+        const auto end = first + static_cast<std::uint32_t>(
+                                         std::uint64_t{n} * (i + 1) / count);
+        subtrees.emplace_back(begin, end);
+    }
+
+    return subtrees;
+}
+
+} // namespace scord_ctl
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef SCORD_CTL_FANOUT_HPP
+#define SCORD_CTL_FANOUT_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace scord_ctl {
+
+/**
+ * @brief Build the address of the scord-ctl running on `hostname`. All the
+ * scord-ctl instances of a job are expected to listen on the same protocol
+ * and port, e.g. `ofi+tcp://node002:52000` for `ofi+tcp://0.0.0.0:52000`.
+ *
+ * @param listen_address The address this scord-ctl was configured to listen
+ * on. Addresses resolved by Mercury (e.g. `ofi+tcp;ofi_rxm://...` or
+ * composite shared memory addresses such as `na+sm://...#ofi+tcp://...`) are
+ * also accepted, but the configured one is preferred since Mercury may
+ * rewrite the protocol.
+ * @param hostname The hostname of the peer.
+ * @return The address of the peer.
+ */
+std::string
+peer_address(std::string_view listen_address, std::string_view hostname);
+
+/**
+ * @brief Split the nodes in [first, last) into at most `degree` contiguous
+ * subtrees of similar size. The first node of each subtree is its root and
+ * is in charge of the rest of it, so that reaching `n` nodes takes
+ * O(log_degree(n)) rounds of RPCs.
+ *
+ * @param first The index of the first node.
+ * @param last The index past the last node.
+ * @param degree The maximum number of subtrees.
+ * @return The [first, last) range of each subtree.
+ */
+std::vector<std::pair<std::uint32_t, std::uint32_t>>
+split_subtrees(std::uint32_t first, std::uint32_t last, std::uint32_t degree);
+
+} // namespace scord_ctl
+
+#endif // SCORD_CTL_FANOUT_HPP
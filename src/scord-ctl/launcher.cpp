@@ -0,0 +1,448 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#include <array>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <unordered_set>
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <abt_cxx/condition_variable.hpp>
+#include <logger/logger.hpp>
+#include "launcher.hpp"
+
+extern char** environ;
+
+namespace {
+
+/**
+ * @brief Convert a vector of strings into a vector of C strings.
+ * The returned vector is null-terminated.
+ *
+ * @note The const char* stored into the resulting vector are valid only as
+ * long as the input vector is not modified or destroyed. The caller is
+ * responsible for ensuring this.
+ *
+ * @param v Vector of strings.
+ *
+ * @return Vector of C strings.
+ */
+[[nodiscard]] std::unique_ptr<char*[]>
+as_char_array(const std::vector<std::string>& v) {
+
+    auto tmp = std::make_unique<char*[]>(v.size() + 1);
+    tmp[v.size()] = nullptr;
+
+    for(const auto i : std::views::iota(0u, v.size())) {
+        tmp[i] = const_cast<char*>(v[i].c_str());
+    }
+
+    return tmp;
+}
+
+/**
+ * @brief Build the environment for a command: the environment of scord-ctl
+ * with the variables defined by the command added or replaced.
+ *
+ * @param env The environment variables defined by the command.
+ *
+ * @return The environment as a vector of `key=value` strings.
+ */
+std::vector<std::string>
+merge_environment(const std::optional<scord_ctl::environment>& env) {
+
+    std::vector<std::string> result;
+    std::unordered_set<std::string_view> overridden;
+
+    if(env) {
+        for(const auto& [key, value] : *env) {
+            overridden.insert(key);
+        }
+    }
+
+    for(char** var = environ; *var != nullptr; ++var) {
+        const std::string_view v{*var};
+        if(!overridden.contains(v.substr(0, v.find('=')))) {
+            result.emplace_back(v);
+        }
+    }
+
+    if(env) {
+        std::ranges::move(env->as_vector(), std::back_inserter(result));
+    }
+
+    return result;
+}
+
+std::string
+errno_message(std::string_view what, int error) {
+    return fmt::format("{}: {}", what, ::strerror(error));
+}
+
+int
+pidfd_open(pid_t pid) {
+    return static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+}
+
+} // namespace
+
+namespace scord_ctl {
+
+struct launcher::child {
+    child(pid_t pid, int pidfd) : m_pid(pid), m_pidfd(pidfd) {}
+
+    /**
+     * @brief Block the calling ULT until the child has been reaped or
+     * `timeout` expires.
+     *
+     * @return The exit information of the child if it was reaped in time,
+     * std::nullopt otherwise.
+     */
+    std::optional<siginfo_t>
+    wait(std::optional<std::chrono::seconds> timeout) {
+
+        std::unique_lock lock(m_mutex);
+
+        if(!timeout) {
+            while(!m_info) {
+                m_cv.wait(lock);
+            }
+            return m_info;
+        }
+
+        scord::abt::wait_for(m_cv, lock, *timeout,
+                             [&] { return m_info.has_value(); });
+        return m_info;
+    }
+
+    /**
+     * @brief Send `signum` to the child's process group, unless the child
+     * has already been reaped.
+     *
+     * @note Once reaped, the child's pid (and therefore its process group
+     * id) may be reused by an unrelated process. Checking and signalling
+     * under the same lock that `reap()` holds guarantees that this does not
+     * happen while the signal is being sent.
+     */
+    void
+    signal(int signum) {
+        std::unique_lock lock(m_mutex);
+        if(!m_info) {
+            ::kill(-m_pid, signum);
+        }
+    }
+
+    /**
+     * @brief Reap the child and wake up any ULT waiting for it.
+     */
+    void
+    reap() {
+
+        std::unique_lock lock(m_mutex);
+
+        siginfo_t info{};
+
+        while(::waitid(P_PID, static_cast<id_t>(m_pid), &info, WEXITED) ==
+              -1) {
+            if(errno != EINTR) {
+                LOGGER_ERROR("Failed to reap subprocess {}: {}", m_pid,
+                             ::strerror(errno));
+                info.si_code = 0;
+                break;
+            }
+        }
+
+        m_info = info;
+        m_cv.notify_all();
+    }
+
+    pid_t m_pid;
+    int m_pidfd;
+    thallium::mutex m_mutex;
+    thallium::condition_variable m_cv;
+    std::optional<siginfo_t> m_info;
+};
+
+launcher::launcher(std::chrono::seconds kill_timeout)
+    : m_kill_timeout(kill_timeout), m_epollfd(::epoll_create1(EPOLL_CLOEXEC)),
+      m_eventfd(::eventfd(0, EFD_CLOEXEC)) {
+
+    if(m_epollfd == -1 || m_eventfd == -1) {
+        throw std::runtime_error{
+                ::errno_message("Failed to create launcher", errno)};
+    }
+
+    ::epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = m_eventfd;
+
+    if(::epoll_ctl(m_epollfd, EPOLL_CTL_ADD, m_eventfd, &ev) == -1) {
+        throw std::runtime_error{
+                ::errno_message("Failed to create launcher", errno)};
+    }
+
+    m_reaper_ess = thallium::xstream::create();
+    m_reaper_ult = m_reaper_ess->make_thread([this]() { reap(); });
+}
+
+launcher::~launcher() {
+    stop();
+    ::close(m_eventfd);
+    ::close(m_epollfd);
+}
+
+void
+launcher::stop() {
+
+    if(m_stopped.exchange(true)) {
+        return;
+    }
+
+    const std::uint64_t one = 1;
+    if(::write(m_eventfd, &one, sizeof(one)) == -1) {
+        LOGGER_ERROR("Failed to stop launcher: {}", ::strerror(errno));
+    }
+
+    m_reaper_ult->join();
+    m_reaper_ult = thallium::managed<thallium::thread>{};
+    m_reaper_ess->join();
+    m_reaper_ess = thallium::managed<thallium::xstream>{};
+}
+
+void
+launcher::run(const command& cmd,
+              const std::optional<std::filesystem::path>& output_prefix) {
+
+    if(m_stopped) {
+        throw std::runtime_error{"Launcher is stopped"};
+    }
+
+    const auto args = cmd.as_vector();
+    const auto envs = ::merge_environment(cmd.env());
+    const auto argv = ::as_char_array(args);
+    const auto envp = ::as_char_array(envs);
+
+    ::posix_spawn_file_actions_t actions;
+    ::posix_spawnattr_t attr;
+    ::posix_spawn_file_actions_init(&actions);
+    ::posix_spawnattr_init(&attr);
+
+    ::posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null",
+                                       O_RDONLY, 0);
+
+    if(output_prefix) {
+        auto out = *output_prefix;
+        auto err = *output_prefix;
+        out += ".out";
+        err += ".err";
+
+        constexpr auto flags = O_WRONLY | O_CREAT | O_APPEND;
+        ::posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO,
+                                           out.c_str(), flags, 0644);
+        ::posix_spawn_file_actions_addopen(&actions, STDERR_FILENO,
+                                           err.c_str(), flags, 0644);
+    }
+
+    // Run the child in its own process group so that a timeout also kills
+    // anything it started, and undo any signal handling of scord-ctl
+    ::sigset_t mask;
+    ::sigemptyset(&mask);
+    ::posix_spawnattr_setsigmask(&attr, &mask);
+
+    ::sigset_t defaults;
+    ::sigemptyset(&defaults);
+    for(const auto signum : {SIGHUP, SIGINT, SIGPIPE, SIGTERM, SIGCHLD}) {
+        ::sigaddset(&defaults, signum);
+    }
+    ::posix_spawnattr_setsigdefault(&attr, &defaults);
+
+    ::posix_spawnattr_setpgroup(&attr, 0);
+    ::posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP |
+                                              POSIX_SPAWN_SETSIGMASK |
+                                              POSIX_SPAWN_SETSIGDEF);
+
+    pid_t pid;
+    const auto rv = ::posix_spawnp(&pid, argv[0], &actions, &attr, argv.get(),
+                                   envp.get());
+
+    ::posix_spawnattr_destroy(&attr);
+    ::posix_spawn_file_actions_destroy(&actions);
+
+    if(rv != 0) {
+        throw std::runtime_error{
+                ::errno_message("Failed to execute command", rv)};
+    }
+
+    const auto pidfd = ::pidfd_open(pid);
+
+    if(pidfd == -1) {
+        const auto error = errno;
+        ::kill(pid, SIGKILL);
+        ::waitpid(pid, nullptr, 0);
+        throw std::runtime_error{
+                ::errno_message("Failed to track subprocess", error)};
+    }
+
+    const auto c = std::make_shared<child>(pid, pidfd);
+
+    {
+        std::unique_lock lock(m_children_mutex);
+        m_children.emplace(pidfd, c);
+    }
+
+    ::epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = pidfd;
+
+    if(::epoll_ctl(m_epollfd, EPOLL_CTL_ADD, pidfd, &ev) == -1) {
+        const auto error = errno;
+        ::kill(pid, SIGKILL);
+        complete(pidfd);
+        throw std::runtime_error{
+                ::errno_message("Failed to track subprocess", error)};
+    }
+
+    LOGGER_DEBUG("Started subprocess {}: {}", pid, cmd);
+
+    auto info = c->wait(cmd.timeout());
+
+    if(!info) {
+        // the reaper may reap the child at any point from now on, so
+        // signals must go through `child::signal()`
+        LOGGER_WARN("Subprocess {} timed out after {}s, sending SIGTERM", pid,
+                    cmd.timeout()->count());
+        c->signal(SIGTERM);
+
+        if(info = c->wait(m_kill_timeout); !info) {
+            LOGGER_WARN("Subprocess {} did not exit, sending SIGKILL", pid);
+            c->signal(SIGKILL);
+            info = c->wait(std::nullopt);
+        }
+
+        throw std::runtime_error{
+                fmt::format("Subprocess timed out after {}s",
+                            cmd.timeout()->count())};
+    }
+
+    switch(info->si_code) {
+        case CLD_EXITED:
+            if(info->si_status != 0) {
+                throw std::runtime_error{fmt::format(
+                        "Subprocess exited with status {}", info->si_status)};
+            }
+            break;
+        case CLD_KILLED:
+        case CLD_DUMPED:
+            throw std::runtime_error{
+                    fmt::format("Subprocess killed by signal {} ({})",
+                                info->si_status, ::strsignal(info->si_status))};
+        default:
+            throw std::runtime_error{"Subprocess did not exit normally"};
+    }
+}
+
+void
+launcher::reap() {
+
+    std::array<::epoll_event, 32> events{};
+
+    while(true) {
+        const auto n = ::epoll_wait(m_epollfd, events.data(),
+                                    static_cast<int>(events.size()), -1);
+
+        if(n == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            LOGGER_ERROR("Failed to wait for subprocesses: {}",
+                         ::strerror(errno));
+            break;
+        }
+
+        bool stopping = false;
+
+        for(const auto& ev : std::span{events.data(),
+                                       static_cast<std::size_t>(n)}) {
+            if(ev.data.fd == m_eventfd) {
+                stopping = true;
+            } else {
+                complete(ev.data.fd);
+            }
+        }
+
+        if(stopping) {
+            break;
+        }
+    }
+
+    // Nobody will reap the children still running after this point: kill
+    // them so that their callers do not wait forever
+    std::vector<int> pidfds;
+
+    {
+        std::unique_lock lock(m_children_mutex);
+        for(const auto& [pidfd, c] : m_children) {
+            c->signal(SIGKILL);
+            pidfds.push_back(pidfd);
+        }
+    }
+
+    for(const auto pidfd : pidfds) {
+        complete(pidfd);
+    }
+}
+
+void
+launcher::complete(int pidfd) {
+
+    std::shared_ptr<child> c;
+
+    {
+        std::unique_lock lock(m_children_mutex);
+        if(const auto it = m_children.find(pidfd); it != m_children.end()) {
+            c = std::move(it->second);
+            m_children.erase(it);
+        }
+    }
+
+    if(!c) {
+        return;
+    }
+
+    ::epoll_ctl(m_epollfd, EPOLL_CTL_DEL, pidfd, nullptr);
+    c->reap();
+    ::close(pidfd);
+
+    LOGGER_DEBUG("Subprocess {} finished", c->m_pid);
+}
+
+} // namespace scord_ctl
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#ifndef SCORD_CTL_LAUNCHER_HPP
+#define SCORD_CTL_LAUNCHER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <thallium.hpp>
+#include "command.hpp"
+
+namespace scord_ctl {
+
+/**
+ * @brief Runs commands as child processes without blocking the execution
+ * stream of the caller.
+ *
+ * Children are spawned with `posix_spawn()` in their own process group and
+ * tracked through a pidfd. A dedicated execution stream waits on all pidfds
+ * with `epoll()` and reaps children as soon as they exit, while callers wait
+ * for them on Argobots condition variables so that other ULTs can run in the
+ * meantime.
+ */
+class launcher {
+
+public:
+    /**
+     * @brief Construct a launcher and start its reaper.
+     *
+     * @param kill_timeout The time that a command that has timed out is
+     * given to exit after receiving SIGTERM, before it is sent SIGKILL.
+     */
+    explicit launcher(std::chrono::seconds kill_timeout);
+
+    launcher(const launcher&) = delete;
+    launcher&
+    operator=(const launcher&) = delete;
+
+    ~launcher();
+
+    /**
+     * @brief Run a command and wait for it to finish.
+     *
+     * If the command defines a timeout and does not finish in time, its
+     * process group is sent SIGTERM and, if it is still running after the
+     * kill timeout, SIGKILL.
+     *
+     * @param cmd The command to run.
+     * @param output_prefix If provided, the standard output and error of the
+     * command are appended to `<output_prefix>.out` and `<output_prefix>.err`
+     * respectively. Otherwise, they are inherited from scord-ctl.
+     *
+     * @throws std::runtime_error If the command cannot be started, times out,
+     * is killed by a signal, or exits with a non-zero status.
+     */
+    void
+    run(const command& cmd,
+        const std::optional<std::filesystem::path>& output_prefix =
+                std::nullopt);
+
+    /**
+     * @brief Stop the reaper. Any children still running are killed and
+     * reaped before this function returns.
+     */
+    void
+    stop();
+
+private:
+    struct child;
+
+    void
+    reap();
+
+    void
+    complete(int pidfd);
+
+    std::chrono::seconds m_kill_timeout;
+    int m_epollfd = -1;
+    // used to wake up the reaper when stopping
+    int m_eventfd = -1;
+    std::atomic<bool> m_stopped = false;
+    // children being waited for, indexed by pidfd
+    thallium::mutex m_children_mutex;
+    std::unordered_map<int, std::shared_ptr<child>> m_children;
+    // dedicated execution stream for the reaper ULT
+    thallium::managed<thallium::xstream> m_reaper_ess;
+    thallium::managed<thallium::thread> m_reaper_ult;
+};
+
+} // namespace scord_ctl
+
+#endif // SCORD_CTL_LAUNCHER_HPP
@@ -0,0 +1,250 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <fstream>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thallium.hpp>
+#include <logger/logger.hpp>
+#include "launcher.hpp"
+#include "readiness.hpp"
+
+namespace {
+
+// delays between two rounds of probes
+constexpr std::chrono::milliseconds initial_backoff{100};
+constexpr std::chrono::milliseconds max_backoff{2'000};
+
+bool
+try_connect(int domain, const ::sockaddr* addr, ::socklen_t addrlen) {
+
+    const auto fd = ::socket(domain, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if(fd == -1) {
+        return false;
+    }
+
+    // don't let an unresponsive host stall the execution stream for long
+    const ::timeval tv{1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    const auto rv = ::connect(fd, addr, addrlen);
+    ::close(fd);
+    return rv == 0;
+}
+
+/**
+ * @brief Check whether a connection can be established to `target`: a UNIX
+ * socket if it is an absolute path, or a TCP `host:port` otherwise.
+ */
+bool
+connectable(const std::string& target) {
+
+    if(target.starts_with('/')) {
+        ::sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+
+        if(target.size() >= sizeof(addr.sun_path)) {
+            return false;
+        }
+
+        std::ranges::copy(target, addr.sun_path);
+        return ::try_connect(AF_UNIX, reinterpret_cast<::sockaddr*>(&addr),
+                             sizeof(addr));
+    }
+
+    const auto colon = target.rfind(':');
+
+    if(colon == std::string::npos) {
+        return false;
+    }
+
+    const auto host = target.substr(0, colon);
+    const auto port = target.substr(colon + 1);
+
+    ::addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    ::addrinfo* result = nullptr;
+
+    if(::getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0) {
+        return false;
+    }
+
+    bool connected = false;
+
+    for(auto* ai = result; ai != nullptr && !connected; ai = ai->ai_next) {
+        connected = ::try_connect(ai->ai_family, ai->ai_addr, ai->ai_addrlen);
+    }
+
+    ::freeaddrinfo(result);
+    return connected;
+}
+
+bool
+contains_line(const std::filesystem::path& path, const std::string& pattern) {
+
+    std::ifstream ifs{path};
+
+    for(std::string line; std::getline(ifs, line);) {
+        if(line.find(pattern) != std::string::npos) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace
+
+namespace scord_ctl {
+
+probe::probe(enum type type, command target, std::string pattern)
+    : m_type(type), m_target(std::move(target)),
+      m_pattern(std::move(pattern)) {}
+
+enum probe::type
+probe::type() const {
+    return m_type;
+}
+
+const command&
+probe::target() const {
+    return m_target;
+}
+
+const std::string&
+probe::pattern() const {
+    return m_pattern;
+}
+
+probe
+probe::eval(const std::string& adhoc_id,
+            const std::filesystem::path& adhoc_directory,
+            const std::vector<std::string>& adhoc_nodes,
+            const std::optional<std::filesystem::path>& adhoc_nodes_file)
+        const {
+    return probe{m_type,
+                 m_target.eval(adhoc_id, adhoc_directory, adhoc_nodes,
+                               adhoc_nodes_file),
+                 m_pattern};
+}
+
+bool
+probe::check(launcher& launcher) const {
+
+    switch(m_type) {
+        case type::file:
+            return std::filesystem::exists(m_target.cmdline());
+        case type::socket:
+            return ::connectable(m_target.cmdline());
+        case type::command:
+            try {
+                launcher.run(m_target);
+                return true;
+            } catch(const std::exception& ex) {
+                LOGGER_DEBUG("Readiness probe {} failed: {}", m_target,
+                             ex.what());
+                return false;
+            }
+        case type::log:
+            return ::contains_line(m_target.cmdline(), m_pattern);
+    }
+
+    return false;
+}
+
+readiness_check::readiness_check(std::vector<probe> probes,
+                                 std::chrono::seconds timeout)
+    : m_probes(std::move(probes)), m_timeout(timeout) {}
+
+const std::vector<probe>&
+readiness_check::probes() const {
+    return m_probes;
+}
+
+std::chrono::seconds
+readiness_check::timeout() const {
+    return m_timeout;
+}
+
+bool
+readiness_check::wait(
+        thallium::engine& engine, launcher& launcher,
+        const std::string& adhoc_id,
+        const std::filesystem::path& adhoc_directory,
+        const std::vector<std::string>& adhoc_nodes,
+        const std::optional<std::filesystem::path>& adhoc_nodes_file) const {
+
+    using namespace std::chrono;
+
+    // probes that have not succeeded yet
+    std::vector<probe> pending;
+    pending.reserve(m_probes.size());
+
+    for(const auto& p : m_probes) {
+        pending.emplace_back(p.eval(adhoc_id, adhoc_directory, adhoc_nodes,
+                                    adhoc_nodes_file));
+    }
+
+    const auto start = steady_clock::now();
+    const auto deadline = start + m_timeout;
+    auto backoff = initial_backoff;
+
+    while(true) {
+
+        std::erase_if(pending,
+                      [&](const auto& p) { return p.check(launcher); });
+
+        if(pending.empty()) {
+            LOGGER_DEBUG("[{}] ready after {}ms", adhoc_id,
+                         duration_cast<milliseconds>(steady_clock::now() -
+                                                     start)
+                                 .count());
+            return true;
+        }
+
+        const auto now = steady_clock::now();
+
+        if(now >= deadline) {
+            LOGGER_ERROR("[{}] not ready after {}s: {} probe(s) pending, "
+                         "e.g. {}",
+                         adhoc_id, m_timeout.count(), pending.size(),
+                         pending.front().target());
+            return false;
+        }
+
+        // block the calling ULT (but not its execution stream)
+        const auto delay = std::min(
+                backoff, duration_cast<milliseconds>(deadline - now));
+        thallium::thread::sleep(engine, static_cast<double>(delay.count()));
+        backoff = std::min(backoff * 2, max_backoff);
+    }
+}
+
+} // namespace scord_ctl
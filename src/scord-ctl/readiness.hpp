@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+
+#ifndef SCORD_CTL_READINESS_HPP
+#define SCORD_CTL_READINESS_HPP
+
+#include <chrono>
+#include <string_view>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include "command.hpp"
+
+namespace thallium {
+class engine;
+} // namespace thallium
+
+namespace scord_ctl {
+
+class launcher;
+
+/**
+ * @brief A check that tells whether an adhoc storage instance is ready to
+ * serve requests. Its target may contain the same keywords as commands.
+ */
+class probe {
+
+public:
+    enum class type {
+        // the target file exists
+        file,
+        // a connection to the target can be established, either a UNIX
+        // socket (if it is an absolute path) or a TCP `host:port`
+        socket,
+        // the target command exits with status 0
+        command,
+        // the target file contains a line with `pattern`
+        log
+    };
+
+    /**
+     * @brief Construct a probe.
+     *
+     * @param type The type of the probe.
+     * @param target The file, socket or command to check.
+     * @param pattern The text to look for in the target file (only for `log`
+     * probes).
+     */
+    probe(enum type type, command target, std::string pattern = {});
+
+    enum type
+    type() const;
+
+    const command&
+    target() const;
+
+    const std::string&
+    pattern() const;
+
+    /**
+     * @brief Return a copy of the probe with the keywords in its target
+     * expanded (see `command::eval()`).
+     */
+    probe
+    eval(const std::string& adhoc_id,
+         const std::filesystem::path& adhoc_directory,
+         const std::vector<std::string>& adhoc_nodes,
+         const std::optional<std::filesystem::path>& adhoc_nodes_file) const;
+
+    /**
+     * @brief Check the probe once.
+     *
+     * @param launcher The launcher used to run `command` probes.
+     * @return Whether the check succeeded.
+     */
+    bool
+    check(launcher& launcher) const;
+
+private:
+    enum type m_type;
+    command m_target;
+    std::string m_pattern;
+};
+
+/**
+ * @brief The probes that must succeed before an adhoc storage instance is
+ * considered ready, and how long to wait for them.
+ */
+class readiness_check {
+
+public:
+    readiness_check(std::vector<probe> probes, std::chrono::seconds timeout);
+
+    const std::vector<probe>&
+    probes() const;
+
+    std::chrono::seconds
+    timeout() const;
+
+    /**
+     * @brief Poll the probes with an exponential backoff until all of them
+     * have succeeded once or the timeout expires. Only the calling ULT is
+     * blocked while waiting, using the timers of `engine`.
+     *
+     * @return Whether all probes succeeded in time.
+     */
+    bool
+    wait(thallium::engine& engine, launcher& launcher,
+         const std::string& adhoc_id,
+         const std::filesystem::path& adhoc_directory,
+         const std::vector<std::string>& adhoc_nodes,
+         const std::optional<std::filesystem::path>& adhoc_nodes_file) const;
+
+private:
+    std::vector<probe> m_probes;
+    std::chrono::seconds m_timeout;
+};
+
+} // namespace scord_ctl
+
+/**
+ * @brief Formatter for `scord_ctl::probe::type`.
+ */
+template <>
+struct fmt::formatter<enum scord_ctl::probe::type>
+    : formatter<std::string_view> {
+    template <typename FormatContext>
+    auto
+    format(enum scord_ctl::probe::type t, FormatContext& ctx) const {
+
+        using scord_ctl::probe;
+        std::string_view name = "unknown";
+
+        switch(t) {
+            case probe::type::file:
+                name = "file";
+                break;
+            case probe::type::socket:
+                name = "socket";
+                break;
+            case probe::type::command:
+                name = "command";
+                break;
+            case probe::type::log:
+                name = "log";
+                break;
+        }
+
+        return formatter<std::string_view>::format(name, ctx);
+    }
+};
+
+#endif // SCORD_CTL_READINESS_HPP
@@ -22,34 +22,141 @@
  * SPDX-License-Identifier: GPL-3.0-or-later
  *****************************************************************************/
 
+#include <deque>
 #include <ranges>
+#include <fstream>
 #include <net/request.hpp>
 #include <net/serialization.hpp>
 #include <net/utilities.hpp>
+#include <net/tracing.hpp>
 #include "rpc_server.hpp"
-
-extern char** environ;
+#include "defaults.hpp"
+#include "fanout.hpp"
 
 using namespace std::literals;
 
+namespace {
+
+// name of the file listing the nodes of an adhoc storage instance, created in
+// its working directory and passed to commands as `{ADHOC_NODES_FILE}`
+constexpr auto nodes_filename = "hostfile";
+
+/**
+ * @brief Write the hostnames of an adhoc storage instance into its working
+ * directory, one per line. An existing file is replaced atomically so that
+ * a running instance never reads a partial list.
+ *
+ * @param adhoc_dir The working directory of the adhoc storage instance.
+ * @param hostnames The hostnames to write.
+ * @return The path of the file.
+ */
+std::filesystem::path
+write_nodes_file(const std::filesystem::path& adhoc_dir,
+                 const std::vector<std::string>& hostnames) {
+
+    const auto path = adhoc_dir / nodes_filename;
+    auto tmp = path;
+    tmp += ".tmp";
+
+    std::ofstream ofs{tmp, std::ios::trunc};
+
+    for(const auto& hostname : hostnames) {
+        ofs << hostname << '\n';
+    }
+
+    ofs.close();
+
+    if(!ofs) {
+        throw std::runtime_error{
+                fmt::format("Failed to write {}", tmp.string())};
+    }
+
+    std::filesystem::rename(tmp, path);
+    return path;
+}
+
+/**
+ * @brief Read the hostnames of an adhoc storage instance written by
+ * `write_nodes_file()`.
+ *
+ * @param path The path of the file.
+ * @return The hostnames in the file.
+ */
+std::vector<std::string>
+read_nodes_file(const std::filesystem::path& path) {
+
+    std::ifstream ifs{path};
+    std::vector<std::string> hostnames;
+
+    for(std::string hostname; std::getline(ifs, hostname);) {
+        if(!hostname.empty()) {
+            hostnames.emplace_back(std::move(hostname));
+        }
+    }
+
+    return hostnames;
+}
+
+/**
+ * @brief Find the command that implements `action` for an adhoc storage type.
+ *
+ * @param adhoc_cfg The configuration of the adhoc storage type.
+ * @param action One of "startup", "shutdown", "expand" or "shrink".
+ * @return The command, or nullptr if `action` is not valid.
+ */
+const scord_ctl::command*
+find_command(const scord_ctl::config::adhoc_storage_config& adhoc_cfg,
+             std::string_view action) {
+
+    if(action == "startup") {
+        return &adhoc_cfg.startup_command();
+    }
+
+    if(action == "shutdown") {
+        return &adhoc_cfg.shutdown_command();
+    }
+
+    if(action == "expand") {
+        return &adhoc_cfg.expand_command();
+    }
+
+    if(action == "shrink") {
+        return &adhoc_cfg.shrink_command();
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
 namespace scord_ctl {
 
 rpc_server::rpc_server(std::string name, std::string address, bool daemonize,
                        std::filesystem::path rundir,
-                       std::optional<std::filesystem::path> pidfile)
+                       std::optional<std::filesystem::path> pidfile,
+                       bool shared_memory)
     : server::server(std::move(name), std::move(address), std::move(daemonize),
-                     std::move(rundir), std::move(pidfile)),
-      provider::provider(m_network_engine, 0) {
+                     std::move(rundir), std::move(pidfile), shared_memory),
+      provider::provider(m_network_engine, 0),
+      m_fanout_degree(config::defaults::fanout_degree),
+      m_fanout_timeout(config::defaults::fanout_timeout),
+      m_launcher(config::defaults::command_kill_timeout) {
 
 #define EXPAND(rpc_name) "ADM_" #rpc_name##s, &rpc_server::rpc_name
 
     provider::define(EXPAND(ping));
+    provider::define(EXPAND(set_log_level));
     provider::define(EXPAND(deploy_adhoc_storage));
     provider::define(EXPAND(expand_adhoc_storage));
     provider::define(EXPAND(shrink_adhoc_storage));
     provider::define(EXPAND(terminate_adhoc_storage));
+    provider::define(EXPAND(fanout_adhoc_storage));
 
 #undef EXPAND
+
+    set_fanout_timeout(config::defaults::fanout_timeout);
+
+    m_network_engine.push_prefinalize_callback([this]() { m_launcher.stop(); });
 }
 
 void
@@ -57,6 +164,17 @@ rpc_server::set_config(std::optional<config::config_file> config) {
     m_config = std::move(config);
 }
 
+void
+rpc_server::set_fanout_degree(std::uint32_t degree) {
+    m_fanout_degree = degree;
+}
+
+void
+rpc_server::set_fanout_timeout(std::chrono::seconds timeout) {
+    m_fanout_timeout = timeout;
+    policies().set_timeout("ADM_fanout_adhoc_storage"s, timeout);
+}
+
 void
 rpc_server::print_configuration() const {
 
@@ -77,6 +195,10 @@ rpc_server::print_configuration() const {
 
         LOGGER_INFO("        - command:");
         LOGGER_INFO("            {:?}", (command.cmdline()));
+
+        if(const auto& timeout = command.timeout(); timeout.has_value()) {
+            LOGGER_INFO("        - timeout: {}s", timeout->count());
+        }
     };
 
     LOGGER_INFO("  - adhoc storage configurations:");
@@ -88,7 +210,18 @@ rpc_server::print_configuration() const {
         print_command(adhoc_cfg.startup_command());
         LOGGER_INFO("      - shutdown:");
         print_command(adhoc_cfg.shutdown_command());
+
+        if(const auto& readiness = adhoc_cfg.readiness(); readiness) {
+            LOGGER_INFO("      - readiness (timeout: {}s):",
+                        readiness->timeout().count());
+            for(const auto& probe : readiness->probes()) {
+                LOGGER_INFO("        - {}: {:?}", probe.type(),
+                            (probe.target().cmdline()));
+            }
+        }
     }
+    LOGGER_INFO("  - fan-out degree: {}", m_fanout_degree);
+    LOGGER_INFO("  - fan-out timeout: {}s", m_fanout_timeout.count());
     LOGGER_INFO("");
 }
 
@@ -114,17 +247,44 @@ rpc_server::ping(const network::request& req) {
     req.respond(resp);
 }
 
+void
+rpc_server::set_log_level(const network::request& req,
+                          const std::string& subsystem,
+                          const std::string& level) {
+
+    using network::generic_response;
+    using network::get_address;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+
+    LOGGER_INFO("rpc {:>} body: {{subsystem: {:?}, level: {:?}}}", rpc,
+                subsystem, level);
+
+    const auto ec = logger::set_default_logger_level(subsystem, level)
+                            ? scord::error_code::success
+                            : scord::error_code::bad_args;
+
+    const auto resp = generic_response{rpc.id(), ec};
+
+    LOGGER_EVAL(ec, INFO, ERROR, "rpc {:<} body: {{retval: {}}}", rpc, ec);
+
+    req.respond(resp);
+}
+
 void
 rpc_server::deploy_adhoc_storage(
         const network::request& req, const std::string& adhoc_uuid,
         enum scord::adhoc_storage::type adhoc_type,
-        const scord::adhoc_storage::resources& adhoc_resources) {
+        const scord::adhoc_storage::resources& adhoc_resources,
+        const network::trace_context& trace) {
 
     using network::get_address;
     using network::response_with_value;
     using network::rpc_info;
 
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
     std::optional<std::filesystem::path> adhoc_dir;
 
     LOGGER_INFO("rpc {:>} body: {{uuid: {:?}, type: {}, resources: {}}}", rpc,
@@ -171,19 +331,35 @@ rpc_server::deploy_adhoc_storage(
                 adhoc_resources.nodes(), std::back_inserter(hostnames),
                 [](const auto& node) { return node.hostname(); });
 
+        std::filesystem::path nodes_file;
+
+        try {
+            nodes_file = ::write_nodes_file(*adhoc_dir, hostnames);
+        } catch(const std::exception& ex) {
+            LOGGER_ERROR("[{}] Failed to create nodes file: {}", adhoc_uuid,
+                         ex.what());
+            ec = scord::error_code::adhoc_dir_create_failed;
+            goto respond;
+        }
+
         const auto cmd = adhoc_cfg.startup_command().eval(
-                adhoc_uuid, *adhoc_dir, hostnames);
-        // Fill environment
+                adhoc_uuid, *adhoc_dir, hostnames, nodes_file);
 
 
         // 4. Execute the startup command
-        try {
-            LOGGER_DEBUG("[{}] exec: {}", adhoc_uuid, cmd);
-            cmd.exec();
-        } catch(const std::exception& ex) {
-            LOGGER_ERROR("[{}] Failed to execute startup command: {}",
-                         adhoc_uuid, ex.what());
-            ec = scord::error_code::subprocess_error;
+        ec = execute(rpc, "startup", cmd, *adhoc_dir / "startup", adhoc_uuid,
+                     adhoc_type, hostnames);
+
+        // 5. Wait until the instance is ready to serve requests. For
+        // node-scoped startups, `execute()` only returns once every node has
+        // run the command and then passed the probes itself (see
+        // `fanout_adhoc_storage`), since probes may check node-local state
+        // that this node cannot see
+        if(const auto& readiness = adhoc_cfg.readiness();
+           ec && readiness && cmd.scope() == command::scope::job &&
+           !readiness->wait(m_network_engine, m_launcher, adhoc_uuid,
+                            *adhoc_dir, hostnames, nodes_file)) {
+            ec = scord::error_code::timeout;
         }
     } else {
         LOGGER_WARN(
@@ -205,13 +381,15 @@ void
 rpc_server::expand_adhoc_storage(
         const network::request& req, const std::string& adhoc_uuid,
         enum scord::adhoc_storage::type adhoc_type,
-        const scord::adhoc_storage::resources& adhoc_resources) {
+        const scord::adhoc_storage::resources& adhoc_resources,
+        const network::trace_context& trace) {
 
     using network::generic_response;
     using network::get_address;
     using network::rpc_info;
 
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
     std::optional<std::filesystem::path> adhoc_dir;
 
     LOGGER_INFO("rpc {:>} body: {{uuid: {:?}, type: {}, resources: {}}}", rpc,
@@ -237,17 +415,30 @@ rpc_server::expand_adhoc_storage(
                 adhoc_resources.nodes(), std::back_inserter(hostnames),
                 [](const auto& node) { return node.hostname(); });
 
-        const auto cmd = adhoc_cfg.expand_command().eval(adhoc_uuid, hostnames);
-
-        // 4. Execute the startup command
-        try {
-            LOGGER_DEBUG("[{}] exec: {}", adhoc_uuid, cmd);
-            cmd.exec();
-        } catch(const std::exception& ex) {
-            LOGGER_ERROR("[{}] Failed to execute expand command: {}",
-                         adhoc_uuid, ex.what());
-            ec = scord::error_code::subprocess_error;
+        // Keep the nodes file of the instance (if any) in sync with its new
+        // set of nodes, and capture the command's output next to it
+        const auto dir = adhoc_cfg.working_directory() / adhoc_uuid;
+        std::optional<std::filesystem::path> nodes_file;
+        std::optional<std::filesystem::path> output_prefix;
+
+        if(exists(dir)) {
+            try {
+                nodes_file = ::write_nodes_file(dir, hostnames);
+            } catch(const std::exception& ex) {
+                LOGGER_ERROR("[{}] Failed to update nodes file: {}",
+                             adhoc_uuid, ex.what());
+                ec = scord::error_code::adhoc_dir_create_failed;
+                goto respond;
+            }
+            output_prefix = dir / "expand";
         }
+
+        const auto cmd = adhoc_cfg.expand_command().eval(adhoc_uuid, hostnames,
+                                                          nodes_file);
+
+        // 2. Execute the expand command
+        ec = execute(rpc, "expand", cmd, output_prefix, adhoc_uuid, adhoc_type,
+                     hostnames);
     } else {
         LOGGER_WARN(
                 "Failed to find adhoc storage configuration for type '{:e}'",
@@ -266,13 +457,15 @@ void
 rpc_server::shrink_adhoc_storage(
         const network::request& req, const std::string& adhoc_uuid,
         enum scord::adhoc_storage::type adhoc_type,
-        const scord::adhoc_storage::resources& adhoc_resources) {
+        const scord::adhoc_storage::resources& adhoc_resources,
+        const network::trace_context& trace) {
 
     using network::generic_response;
     using network::get_address;
     using network::rpc_info;
 
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
     std::optional<std::filesystem::path> adhoc_dir;
 
     LOGGER_INFO("rpc {:>} body: {{uuid: {:?}, type: {}, resources: {}}}", rpc,
@@ -298,17 +491,30 @@ rpc_server::shrink_adhoc_storage(
                 adhoc_resources.nodes(), std::back_inserter(hostnames),
                 [](const auto& node) { return node.hostname(); });
 
-        const auto cmd = adhoc_cfg.shrink_command().eval(adhoc_uuid, hostnames);
-
-        // 4. Execute the startup command
-        try {
-            LOGGER_DEBUG("[{}] exec: {}", adhoc_uuid, cmd);
-            cmd.exec();
-        } catch(const std::exception& ex) {
-            LOGGER_ERROR("[{}] Failed to execute shrink command: {}",
-                         adhoc_uuid, ex.what());
-            ec = scord::error_code::subprocess_error;
+        // Keep the nodes file of the instance (if any) in sync with its new
+        // set of nodes, and capture the command's output next to it
+        const auto dir = adhoc_cfg.working_directory() / adhoc_uuid;
+        std::optional<std::filesystem::path> nodes_file;
+        std::optional<std::filesystem::path> output_prefix;
+
+        if(exists(dir)) {
+            try {
+                nodes_file = ::write_nodes_file(dir, hostnames);
+            } catch(const std::exception& ex) {
+                LOGGER_ERROR("[{}] Failed to update nodes file: {}",
+                             adhoc_uuid, ex.what());
+                ec = scord::error_code::adhoc_dir_create_failed;
+                goto respond;
+            }
+            output_prefix = dir / "shrink";
         }
+
+        const auto cmd = adhoc_cfg.shrink_command().eval(adhoc_uuid, hostnames,
+                                                          nodes_file);
+
+        // 2. Execute the shrink command
+        ec = execute(rpc, "shrink", cmd, output_prefix, adhoc_uuid, adhoc_type,
+                     hostnames);
     } else {
         LOGGER_WARN(
                 "Failed to find adhoc storage configuration for type '{:e}'",
@@ -326,13 +532,15 @@ respond:
 void
 rpc_server::terminate_adhoc_storage(
         const network::request& req, const std::string& adhoc_uuid,
-        enum scord::adhoc_storage::type adhoc_type) {
+        enum scord::adhoc_storage::type adhoc_type,
+        const network::trace_context& trace) {
 
     using network::generic_response;
     using network::get_address;
     using network::rpc_info;
 
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
 
     LOGGER_INFO("rpc {:>} body: {{uuid: {:?}, type: {}}}", rpc, (adhoc_uuid),
                 adhoc_type);
@@ -352,19 +560,26 @@ rpc_server::terminate_adhoc_storage(
         const auto adhoc_dir = adhoc_cfg.working_directory() / adhoc_uuid;
 
         // 1. Construct the shutdown command for the adhoc storage instance
-        const auto cmd =
-                adhoc_cfg.shutdown_command().eval(adhoc_uuid, adhoc_dir, {});
+        std::optional<std::filesystem::path> nodes_file;
+        std::optional<std::filesystem::path> output_prefix;
+        std::vector<std::string> hostnames;
 
-        // 2. Execute the shutdown command
-        try {
-            LOGGER_DEBUG("[{}] exec: {}", adhoc_uuid, cmd);
-            cmd.exec();
-        } catch(const std::exception& ex) {
-            LOGGER_ERROR("[{}] Failed to execute shutdown command: {}",
-                         adhoc_uuid, ex.what());
-            ec = scord::error_code::subprocess_error;
+        if(const auto path = adhoc_dir / ::nodes_filename; exists(path)) {
+            nodes_file = path;
+            hostnames = ::read_nodes_file(path);
         }
 
+        if(exists(adhoc_dir)) {
+            output_prefix = adhoc_dir / "shutdown";
+        }
+
+        const auto cmd = adhoc_cfg.shutdown_command().eval(
+                adhoc_uuid, adhoc_dir, hostnames, nodes_file);
+
+        // 2. Execute the shutdown command
+        ec = execute(rpc, "shutdown", cmd, output_prefix, adhoc_uuid,
+                     adhoc_type, hostnames);
+
     } else {
         LOGGER_WARN(
                 "Failed to find adhoc storage configuration for type '{:e}'",
@@ -379,4 +594,254 @@ respond:
     req.respond(resp);
 }
 
+void
+rpc_server::fanout_adhoc_storage(const network::request& req,
+                                 const std::string& action,
+                                 const std::string& adhoc_uuid,
+                                 enum scord::adhoc_storage::type adhoc_type,
+                                 const std::vector<std::string>& hostnames,
+                                 std::uint32_t first, std::uint32_t last,
+                                 const network::trace_context& trace) {
+
+    using network::generic_response;
+    using network::get_address;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_INFO("rpc {:>} body: {{action: {:?}, uuid: {:?}, type: {}, "
+                "nodes: [{}, {})}}",
+                rpc, action, adhoc_uuid, adhoc_type, first, last);
+
+    auto ec = scord::error_code::success;
+
+    if(!m_config.has_value() || m_config->adhoc_storage_configs().empty()) {
+        LOGGER_WARN("No adhoc storage configurations available");
+        ec = scord::error_code::snafu;
+        goto respond;
+    }
+
+    if(first >= last || last > hostnames.size()) {
+        LOGGER_ERROR("[{}] Invalid node range [{}, {}) for {} node(s)",
+                     adhoc_uuid, first, last, hostnames.size());
+        ec = scord::error_code::bad_args;
+        goto respond;
+    }
+
+    if(const auto it = m_config->adhoc_storage_configs().find(adhoc_type);
+       it != m_config->adhoc_storage_configs().end()) {
+
+        const auto& adhoc_cfg = it->second;
+        const auto* cmd = ::find_command(adhoc_cfg, action);
+
+        if(!cmd) {
+            LOGGER_ERROR("[{}] Unknown action {:?}", adhoc_uuid, action);
+            ec = scord::error_code::bad_args;
+            goto respond;
+        }
+
+        // Run the command on this node (i.e. hostnames[first]) while the
+        // rest of our subtree does the same
+        const auto run_local = [&]() {
+            const auto adhoc_dir = adhoc_cfg.working_directory() / adhoc_uuid;
+            std::optional<std::filesystem::path> nodes_file;
+            std::optional<std::filesystem::path> output_prefix;
+
+            if(action == "startup") {
+                std::error_code err;
+                create_directories(adhoc_dir, err);
+                if(err) {
+                    LOGGER_ERROR("[{}] Failed to create adhoc directory {}: {}",
+                                 adhoc_uuid, adhoc_dir, err.message());
+                    return scord::error_code::adhoc_dir_create_failed;
+                }
+            }
+
+            if(exists(adhoc_dir)) {
+                output_prefix = adhoc_dir / action;
+
+                try {
+                    if(action != "shutdown") {
+                        nodes_file = ::write_nodes_file(adhoc_dir, hostnames);
+                    } else if(exists(adhoc_dir / ::nodes_filename)) {
+                        nodes_file = adhoc_dir / ::nodes_filename;
+                    }
+                } catch(const std::exception& ex) {
+                    LOGGER_ERROR("[{}] Failed to update nodes file: {}",
+                                 adhoc_uuid, ex.what());
+                    return scord::error_code::adhoc_dir_create_failed;
+                }
+            }
+
+            const auto local_cmd =
+                    cmd->eval(adhoc_uuid, adhoc_dir, hostnames, nodes_file);
+
+            try {
+                LOGGER_DEBUG("[{}] exec: {}", adhoc_uuid, local_cmd);
+                m_launcher.run(local_cmd, output_prefix);
+            } catch(const std::exception& ex) {
+                LOGGER_ERROR("[{}] Failed to execute {} command: {}",
+                             adhoc_uuid, action, ex.what());
+                return scord::error_code::subprocess_error;
+            }
+
+            if(const auto& readiness = adhoc_cfg.readiness();
+               action == "startup" && readiness &&
+               !readiness->wait(m_network_engine, m_launcher, adhoc_uuid,
+                                adhoc_dir, hostnames, nodes_file)) {
+                return scord::error_code::timeout;
+            }
+
+            return scord::error_code::success;
+        };
+
+        ec = broadcast(rpc, action, adhoc_uuid, adhoc_type, hostnames,
+                       first + 1, last, run_local);
+    } else {
+        LOGGER_WARN(
+                "Failed to find adhoc storage configuration for type '{:e}'",
+                adhoc_type);
+        ec = scord::error_code::adhoc_type_unsupported;
+    }
+
+respond:
+    const generic_response resp{rpc.id(), ec};
+    LOGGER_INFO("rpc {:<} body: {{retval: {}}}", rpc, resp.error_code());
+    req.respond(resp);
+}
+
+scord::error_code
+rpc_server::execute(const network::rpc_info& rpc, const std::string& action,
+                    const command& cmd,
+                    const std::optional<std::filesystem::path>& output_prefix,
+                    const std::string& adhoc_uuid,
+                    enum scord::adhoc_storage::type adhoc_type,
+                    const std::vector<std::string>& hostnames) {
+
+    if(cmd.scope() == command::scope::node) {
+        LOGGER_DEBUG("[{}] broadcast {} to {} node(s)", adhoc_uuid, action,
+                     hostnames.size());
+        return broadcast(rpc, action, adhoc_uuid, adhoc_type, hostnames, 0,
+                         static_cast<std::uint32_t>(hostnames.size()));
+    }
+
+    try {
+        LOGGER_DEBUG("[{}] exec: {}", adhoc_uuid, cmd);
+        m_launcher.run(cmd, output_prefix);
+    } catch(const std::exception& ex) {
+        LOGGER_ERROR("[{}] Failed to execute {} command: {}", adhoc_uuid,
+                     action, ex.what());
+        return scord::error_code::subprocess_error;
+    }
+
+    return scord::error_code::success;
+}
+
+scord::error_code
+rpc_server::broadcast(const network::rpc_info& rpc, const std::string& action,
+                      const std::string& adhoc_uuid,
+                      enum scord::adhoc_storage::type adhoc_type,
+                      const std::vector<std::string>& hostnames,
+                      std::uint32_t first, std::uint32_t last,
+                      const std::function<scord::error_code()>& local) {
+
+    using network::generic_response;
+
+    struct pending_call {
+        std::string address;
+        network::rpc_info rpc;
+        std::optional<network::endpoint> endpoint;
+        std::optional<thallium::async_response> response;
+    };
+
+    const auto self = listen_address();
+    auto ec = scord::error_code::success;
+
+    // `spans` refer to the `rpc_info` in `calls`: deques keep both stable
+    std::deque<pending_call> calls;
+    std::deque<network::tracing::span> spans;
+
+    // 1. Forward the request to the root of each subtree
+    for(const auto& [begin, end] :
+        split_subtrees(first, last, m_fanout_degree)) {
+
+        auto address = peer_address(self, hostnames[begin]);
+        auto child_rpc = rpc.add_child("ADM_fanout_adhoc_storage"s, address);
+        auto& call = calls.emplace_back(pending_call{
+                std::move(address), std::move(child_rpc), {}, {}});
+        spans.emplace_back(call.rpc);
+
+        LOGGER_DEBUG("rpc {:<} body: {{action: {:?}, uuid: {:?}, type: {}, "
+                     "nodes: [{}, {})}}",
+                     call.rpc, action, adhoc_uuid, adhoc_type, begin, end);
+
+        call.endpoint = lookup(call.address);
+
+        if(call.endpoint) {
+            if(auto rv = call.endpoint->async_call(
+                       call.rpc.name(), action, adhoc_uuid, adhoc_type,
+                       hostnames, begin, end, call.rpc.trace());
+               rv.has_value()) {
+                call.response.emplace(std::move(rv.value()));
+            }
+        }
+
+        if(!call.response) {
+            LOGGER_ERROR("[{}] Failed to contact scord-ctl at {}", adhoc_uuid,
+                         call.address);
+            invalidate(call.address);
+            if(ec) {
+                ec = scord::error_code::snafu;
+            }
+        }
+    }
+
+    // 2. Do our own share of the work while the subtrees do theirs
+    if(local) {
+        if(const auto rv = local(); !rv && ec) {
+            ec = rv;
+        }
+    }
+
+    // 3. Gather the results of the subtrees
+    for(auto& call : calls) {
+
+        if(!call.response) {
+            continue;
+        }
+
+        // each call is bounded by the deadline configured for
+        // ADM_fanout_adhoc_storage, so that an unresponsive peer cannot
+        // block its whole subtree
+        try {
+            const generic_response resp{call.endpoint->wait(*call.response)};
+
+            LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
+                        "rpc {:>} body: {{retval: {}}} [op_id: {}]", call.rpc,
+                        resp.error_code(), resp.op_id());
+
+            if(!resp.error_code() && ec) {
+                ec = resp.error_code();
+            }
+        } catch(const thallium::timeout&) {
+            LOGGER_ERROR("[{}] scord-ctl at {} did not respond in time",
+                         adhoc_uuid, call.address);
+            invalidate(call.address);
+            if(ec) {
+                ec = scord::error_code::timeout;
+            }
+        } catch(const std::exception& ex) {
+            LOGGER_ERROR("[{}] Failed to wait for scord-ctl at {}: {}",
+                         adhoc_uuid, call.address, ex.what());
+            invalidate(call.address);
+            if(ec) {
+                ec = scord::error_code::snafu;
+            }
+        }
+    }
+
+    return ec;
+}
+
 } // namespace scord_ctl
@@ -26,9 +26,12 @@
 #ifndef SCORD_CTL_RPC_SERVER_HPP
 #define SCORD_CTL_RPC_SERVER_HPP
 
+#include <functional>
 #include <net/server.hpp>
+#include <net/utilities.hpp>
 #include <scord/types.hpp>
 #include "config_file.hpp"
+#include "launcher.hpp"
 
 namespace scord_ctl {
 
@@ -38,42 +41,110 @@ class rpc_server : public network::server,
 public:
     rpc_server(std::string name, std::string address, bool daemonize,
                std::filesystem::path rundir,
-               std::optional<std::filesystem::path> pidfile = {});
+               std::optional<std::filesystem::path> pidfile = {},
+               bool shared_memory = true);
 
     void
     set_config(std::optional<config::config_file> config);
 
+    /**
+     * @brief Set the maximum number of peers that each scord-ctl forwards
+     * requests to when running a command on every node of an adhoc storage
+     * instance.
+     */
+    void
+    set_fanout_degree(std::uint32_t degree);
+
+    /**
+     * @brief Set how long to wait for each peer that a request to run a
+     * command on every node was forwarded to. Peers that do not respond in
+     * time are reported as failed.
+     */
+    void
+    set_fanout_timeout(std::chrono::seconds timeout);
+
     void
     print_configuration() const final;
 
 private:
+    static constexpr auto logger_subsystem = logger::subsystem::rpc;
+
     void
     ping(const network::request& req);
 
+    void
+    set_log_level(const network::request& req, const std::string& subsystem,
+                  const std::string& level);
+
     void
     deploy_adhoc_storage(
             const network::request& req, const std::string& adhoc_uuid,
             enum scord::adhoc_storage::type adhoc_type,
-            const scord::adhoc_storage::resources& adhoc_resources);
+            const scord::adhoc_storage::resources& adhoc_resources,
+            const network::trace_context& trace);
 
     void
     expand_adhoc_storage(
             const network::request& req, const std::string& adhoc_uuid,
             enum scord::adhoc_storage::type adhoc_type,
-            const scord::adhoc_storage::resources& adhoc_resources);
+            const scord::adhoc_storage::resources& adhoc_resources,
+            const network::trace_context& trace);
 
     void
     shrink_adhoc_storage(
             const network::request& req, const std::string& adhoc_uuid,
             enum scord::adhoc_storage::type adhoc_type,
-            const scord::adhoc_storage::resources& adhoc_resources);
+            const scord::adhoc_storage::resources& adhoc_resources,
+            const network::trace_context& trace);
 
     void
     terminate_adhoc_storage(const network::request& req,
                             const std::string& adhoc_uuid,
-                            enum scord::adhoc_storage::type adhoc_type);
+                            enum scord::adhoc_storage::type adhoc_type,
+                            const network::trace_context& trace);
+
+    void
+    fanout_adhoc_storage(const network::request& req, const std::string& action,
+                         const std::string& adhoc_uuid,
+                         enum scord::adhoc_storage::type adhoc_type,
+                         const std::vector<std::string>& hostnames,
+                         std::uint32_t first, std::uint32_t last,
+                         const network::trace_context& trace);
+
+    /**
+     * @brief Run the `action` command of an adhoc storage instance, either
+     * locally or, if its scope is `node`, on each of `hostnames`.
+     */
+    scord::error_code
+    execute(const network::rpc_info& rpc, const std::string& action,
+            const command& cmd,
+            const std::optional<std::filesystem::path>& output_prefix,
+            const std::string& adhoc_uuid,
+            enum scord::adhoc_storage::type adhoc_type,
+            const std::vector<std::string>& hostnames);
+
+    /**
+     * @brief Ask the scord-ctl instances running on `hostnames[first, last)`
+     * to run `action` for an adhoc storage instance, forwarding the request
+     * along a tree of degree `m_fanout_degree`. `local` (if any) is run while
+     * waiting for the peers. Peers that do not respond within
+     * `m_fanout_timeout` are reported as `timeout`.
+     *
+     * @return The first error reported, or `success` if all nodes succeeded.
+     */
+    scord::error_code
+    broadcast(const network::rpc_info& rpc, const std::string& action,
+              const std::string& adhoc_uuid,
+              enum scord::adhoc_storage::type adhoc_type,
+              const std::vector<std::string>& hostnames, std::uint32_t first,
+              std::uint32_t last,
+              const std::function<scord::error_code()>& local = {});
 
     std::optional<config::config_file> m_config;
+    std::uint32_t m_fanout_degree;
+    std::chrono::seconds m_fanout_timeout;
+    // runs adhoc storage commands without blocking the RPC handlers
+    launcher m_launcher;
 };
 
 } // namespace scord_ctl
@@ -33,6 +33,7 @@
 #include <ryml_std.hpp>
 
 #include <version.hpp>
+#include <net/tracing.hpp>
 #include "rpc_server.hpp"
 #include "config_file.hpp"
 #include "defaults.hpp"
@@ -47,6 +48,12 @@ main(int argc, char* argv[]) {
         std::optional<fs::path> output_file;
         std::string address;
         std::optional<fs::path> pidfile;
+        bool no_shared_memory = false;
+        std::optional<fs::path> trace_file;
+        std::uint32_t fanout_degree =
+                scord_ctl::config::defaults::fanout_degree;
+        std::uint32_t fanout_timeout =
+                scord_ctl::config::defaults::fanout_timeout.count();
     } cli_args;
 
     const auto progname = fs::path{argv[0]}.filename().string();
@@ -72,6 +79,27 @@ main(int argc, char* argv[]) {
                    "Write the daemon's PID to FILENAME")
             ->option_text("FILENAME");
 
+    app.add_flag("--no-shared-memory", cli_args.no_shared_memory,
+                 "Do not use shared memory for requests from peers running "
+                 "on the same node");
+
+    app.add_option("--trace-file", cli_args.trace_file,
+                   "Record the spans of incoming RPCs in FILENAME")
+            ->option_text("FILENAME");
+
+    app.add_option("--fanout-degree", cli_args.fanout_degree,
+                   "Forward requests to run a command on every node of an "
+                   "adhoc storage\ninstance to at most N peers, which "
+                   "forward them in turn")
+            ->option_text("N")
+            ->check(CLI::Range(1, 1024));
+
+    app.add_option("--fanout-timeout", cli_args.fanout_timeout,
+                   "Report peers that do not complete a forwarded request "
+                   "within SECONDS\nas failed")
+            ->option_text("SECONDS")
+            ->check(CLI::PositiveNumber);
+
     app.set_config("-c,--config-file", scord_ctl::config::defaults::config_file,
                    "Ignore the system-wide configuration file and use the "
                    "configuration provided by FILENAME",
@@ -96,14 +124,26 @@ main(int argc, char* argv[]) {
                 app.get_config_ptr()->as<fs::path>());
 
         scord_ctl::rpc_server srv(progname, cli_args.address, false,
-                                  fs::current_path(), cli_args.pidfile);
+                                  fs::current_path(), cli_args.pidfile,
+                                  !cli_args.no_shared_memory);
         if(cli_args.output_file) {
             srv.configure_logger(logger::logger_type::file,
                                  *cli_args.output_file);
         }
 
+        if(cli_args.trace_file &&
+           !network::tracing::enable(*cli_args.trace_file)) {
+            fmt::print(stderr, "ERROR: unable to open trace file '{}'\n",
+                       cli_args.trace_file->string());
+            return EXIT_FAILURE;
+        }
+
         srv.set_config(config);
-        return srv.run();
+        srv.set_fanout_degree(cli_args.fanout_degree);
+        srv.set_fanout_timeout(std::chrono::seconds{cli_args.fanout_timeout});
+        const auto rv = srv.run();
+        network::tracing::disable();
+        return rv;
     } catch(const std::runtime_error& ex) {
         fmt::print(stderr, "ERROR: {}\n", ex.what());
         return EXIT_FAILURE;
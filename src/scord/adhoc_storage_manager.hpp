@@ -181,6 +181,12 @@ struct adhoc_storage_manager {
     }
 
 
+    std::size_t
+    size() const {
+        abt::shared_lock lock(m_adhoc_storages_mutex);
+        return m_adhoc_storages.size();
+    }
+
 private:
     mutable abt::shared_mutex m_adhoc_storages_mutex;
     std::unordered_map<std::uint64_t,
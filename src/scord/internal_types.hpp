@@ -26,7 +26,13 @@
 #ifndef SCORD_INTERNAL_TYPES_HPP
 #define SCORD_INTERNAL_TYPES_HPP
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <optional>
+#include <thallium/condition_variable.hpp>
+#include <thallium/mutex.hpp>
+#include <abt_cxx/condition_variable.hpp>
 #include <logger/logger.hpp>
 #include <scord/types.hpp>
 
@@ -119,15 +125,86 @@ struct pfs_storage_metadata {
 
 template <typename TransferHandle>
 struct transfer_metadata {
-    transfer_metadata(transfer_id id, TransferHandle&& handle,
+
+    using clock = std::chrono::steady_clock;
+
+    transfer_metadata(transfer_id id, scord::job_id job_id,
+                      TransferHandle&& handle,
                       std::vector<scord::qos::limit> qos)
-        : m_id(id), m_handle(handle), m_qos(std::move(qos)) {}
+        : m_id(id), m_job_id(job_id), m_handle(handle), m_qos(std::move(qos)) {
+    }
 
     transfer_id
     id() const {
         return m_id;
     }
 
+    scord::job_id
+    job_id() const {
+        return m_job_id;
+    }
+
+    /**
+     * @brief The last state reported for the transfer by the data stager.
+     * This is refreshed periodically by the scheduler so that queries do not
+     * need to contact the data stager.
+     */
+    scord::transfer_state::type
+    state() const {
+        return m_state;
+    }
+
+    void
+    set_state(scord::transfer_state::type state) {
+
+        std::unique_lock lock(m_state_mutex);
+
+        if(m_state == state) {
+            return;
+        }
+
+        m_state = state;
+
+        if(is_terminal(state)) {
+            m_completion_time = clock::now();
+        }
+
+        m_state_cv.notify_all();
+    }
+
+    /**
+     * @brief Check whether the transfer reached a terminal state more than
+     * `retention` ago, i.e. if clients have had enough time to collect its
+     * outcome.
+     */
+    bool
+    expired(clock::duration retention) {
+        std::unique_lock lock(m_state_mutex);
+        return is_terminal(m_state) &&
+               clock::now() - m_completion_time >= retention;
+    }
+
+    static constexpr bool
+    is_terminal(scord::transfer_state::type state) {
+        return state == scord::transfer_state::type::finished ||
+               state == scord::transfer_state::type::failed ||
+               state == scord::transfer_state::type::cancelled;
+    }
+
+    /**
+     * @brief Block the calling ULT until the transfer reaches a terminal
+     * state or `timeout` expires.
+     * @return The state of the transfer when the function returns.
+     */
+    scord::transfer_state::type
+    wait(std::chrono::milliseconds timeout) {
+
+        std::unique_lock lock(m_state_mutex);
+        scord::abt::wait_for(m_state_cv, lock, timeout,
+                             [&] { return is_terminal(m_state); });
+        return m_state;
+    }
+
     TransferHandle
     transfer() const {
         return m_handle;
@@ -149,11 +226,104 @@ struct transfer_metadata {
     }
 
     transfer_id m_id;
+    scord::job_id m_job_id;
+    std::atomic<scord::transfer_state::type> m_state =
+            scord::transfer_state::type::queued;
+    clock::time_point m_completion_time;
+    thallium::mutex m_state_mutex;
+    thallium::condition_variable m_state_cv;
     TransferHandle m_handle;
     std::vector<scord::qos::limit> m_qos;
     float m_measured_bandwidth = -1.0;
 };
 
+/**
+ * @brief An adhoc storage operation (deploy, terminate, expand or shrink)
+ * that runs in the background while clients poll for or wait on its result.
+ */
+struct operation_metadata {
+
+    using clock = std::chrono::steady_clock;
+
+    operation_metadata(scord::operation_id id, std::string name,
+                       std::uint64_t adhoc_id)
+        : m_id(id), m_name(std::move(name)), m_adhoc_id(adhoc_id) {}
+
+    scord::operation_id
+    id() const {
+        return m_id;
+    }
+
+    std::string const&
+    name() const {
+        return m_name;
+    }
+
+    std::uint64_t
+    adhoc_id() const {
+        return m_adhoc_id;
+    }
+
+    scord::operation_info
+    info() {
+        std::unique_lock lock(m_mutex);
+        return {m_id, m_state, m_error_code, m_adhoc_dir};
+    }
+
+    void
+    start() {
+        std::unique_lock lock(m_mutex);
+        m_state = scord::operation_info::type::running;
+    }
+
+    void
+    complete(scord::error_code ec, std::string adhoc_dir = {}) {
+
+        std::unique_lock lock(m_mutex);
+
+        m_state = scord::operation_info::type::completed;
+        m_error_code = ec;
+        m_adhoc_dir = std::move(adhoc_dir);
+        m_completion_time = clock::now();
+        m_cv.notify_all();
+    }
+
+    /**
+     * @brief Check whether the operation completed more than `retention`
+     * ago, i.e. if clients have had enough time to collect its result.
+     */
+    bool
+    expired(clock::duration retention) {
+        std::unique_lock lock(m_mutex);
+        return m_state == scord::operation_info::type::completed &&
+               clock::now() - m_completion_time >= retention;
+    }
+
+    /**
+     * @brief Block the calling ULT until the operation completes or
+     * `timeout` expires.
+     * @return The progress of the operation when the function returns.
+     */
+    scord::operation_info
+    wait(std::chrono::milliseconds timeout) {
+
+        std::unique_lock lock(m_mutex);
+        scord::abt::wait_for(m_cv, lock, timeout, [&] {
+            return m_state == scord::operation_info::type::completed;
+        });
+        return {m_id, m_state, m_error_code, m_adhoc_dir};
+    }
+
+    scord::operation_id m_id;
+    std::string m_name;
+    std::uint64_t m_adhoc_id;
+    scord::operation_info::type m_state = scord::operation_info::type::pending;
+    scord::error_code m_error_code;
+    std::string m_adhoc_dir;
+    clock::time_point m_completion_time;
+    thallium::mutex m_mutex;
+    thallium::condition_variable m_cv;
+};
 
 } // namespace scord::internal
 
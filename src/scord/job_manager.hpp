@@ -134,6 +134,12 @@ struct job_manager {
         return tl::make_unexpected(scord::error_code::no_such_entity);
     }
 
+    std::size_t
+    size() const {
+        abt::shared_lock lock(m_jobs_mutex);
+        return m_jobs.size();
+    }
+
 private:
     mutable abt::shared_mutex m_jobs_mutex;
     std::unordered_map<scord::job_id,
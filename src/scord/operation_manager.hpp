@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef SCORD_OPERATION_MANAGER_HPP
+#define SCORD_OPERATION_MANAGER_HPP
+
+#include <scord/types.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <tl/expected.hpp>
+#include <logger/logger.hpp>
+#include <abt_cxx/shared_mutex.hpp>
+#include "internal_types.hpp"
+
+namespace scord {
+
+struct operation_manager {
+
+    // How long the result of a completed operation is kept around so that
+    // clients can collect it
+    static constexpr std::chrono::minutes retention{10};
+
+    tl::expected<std::shared_ptr<scord::internal::operation_metadata>,
+                 scord::error_code>
+    create(std::string name, std::uint64_t adhoc_id) {
+
+        static std::atomic_uint64_t current_id;
+        scord::operation_id id = current_id++;
+
+        abt::unique_lock lock(m_operation_mutex);
+
+        // retire operations whose results have not been collected in time
+        std::erase_if(m_operations, [](const auto& kv) {
+            return kv.second->expired(retention);
+        });
+
+        const auto& [it, inserted] = m_operations.emplace(
+                id, std::make_shared<internal::operation_metadata>(
+                            id, std::move(name), adhoc_id));
+
+        if(!inserted) {
+            LOGGER_ERROR("{}: Operation '{}' already exists", __FUNCTION__,
+                         id);
+            return tl::make_unexpected(scord::error_code::entity_exists);
+        }
+
+        return it->second;
+    }
+
+    tl::expected<std::shared_ptr<scord::internal::operation_metadata>,
+                 scord::error_code>
+    find(scord::operation_id id) {
+
+        abt::shared_lock lock(m_operation_mutex);
+
+        if(auto it = m_operations.find(id); it != m_operations.end()) {
+            return it->second;
+        }
+
+        LOGGER_ERROR("Operation '{}' was not registered or already expired",
+                     id);
+        return tl::make_unexpected(scord::error_code::no_such_entity);
+    }
+
+    std::size_t
+    size() const {
+        abt::shared_lock lock(m_operation_mutex);
+        return m_operations.size();
+    }
+
+private:
+    mutable abt::shared_mutex m_operation_mutex;
+    std::unordered_map<scord::operation_id,
+                       std::shared_ptr<scord::internal::operation_metadata>>
+            m_operations;
+};
+
+} // namespace scord
+
+#endif // SCORD_OPERATION_MANAGER_HPP
@@ -115,6 +115,12 @@ struct pfs_storage_manager {
         return scord::error_code::no_such_entity;
     }
 
+    std::size_t
+    size() const {
+        abt::shared_lock lock(m_pfs_storages_mutex);
+        return m_pfs_storages.size();
+    }
+
 private:
     mutable abt::shared_mutex m_pfs_storages_mutex;
     std::unordered_map<std::uint64_t,
@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Copyright 2021-2023, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#ifndef SCORD_REQUEST_CACHE_HPP
+#define SCORD_REQUEST_CACHE_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <thallium/condition_variable.hpp>
+#include <thallium/mutex.hpp>
+
+namespace scord {
+
+/**
+ * A bounded table of the responses sent for requests that carry a
+ * client-supplied request id.
+ *
+ * Clients that retry a request after a timeout reuse its id, so a replayed
+ * request is answered with the original response instead of being executed
+ * again (e.g. registering the same job twice or starting a duplicate
+ * transfer). Only successful responses are kept, so that requests that
+ * failed can be retried normally. Once `capacity` responses are stored,
+ * the oldest ones are evicted.
+ */
+template <typename Response>
+class request_cache {
+
+    struct entry {
+        bool m_completed = false;
+        Response m_response{};
+    };
+
+public:
+    static constexpr std::size_t default_capacity = 8192;
+
+    explicit request_cache(std::size_t capacity = default_capacity)
+        : m_capacity(capacity) {}
+
+    /**
+     * @brief Return the response for the request identified by
+     * `request_id`, invoking `compute` to produce it if the request has not
+     * been served before. Concurrent requests with the same id wait for the
+     * first one to complete rather than executing it again.
+     *
+     * Requests with an empty id are never deduplicated.
+     *
+     * @return The response and whether it is a replay of a previous one.
+     */
+    template <typename Callable>
+    std::pair<Response, bool>
+    get_or_compute(const std::string& request_id, Callable&& compute) {
+
+        if(request_id.empty()) {
+            return {std::invoke(std::forward<Callable>(compute)), false};
+        }
+
+        {
+            std::unique_lock lock(m_mutex);
+
+            while(true) {
+                const auto it = m_entries.find(request_id);
+
+                if(it == m_entries.end()) {
+                    m_entries.emplace(request_id, entry{});
+                    break;
+                }
+
+                if(it->second.m_completed) {
+                    return {it->second.m_response, true};
+                }
+
+                m_cv.wait(lock);
+            }
+        }
+
+        try {
+            auto resp = std::invoke(std::forward<Callable>(compute));
+            complete(request_id, resp);
+            return {std::move(resp), false};
+        } catch(...) {
+            abandon(request_id);
+            throw;
+        }
+    }
+
+private:
+    void
+    complete(const std::string& request_id, const Response& resp) {
+
+        {
+            std::unique_lock lock(m_mutex);
+
+            if(!resp.error_code()) {
+                m_entries.erase(request_id);
+            } else {
+                auto& e = m_entries[request_id];
+                e.m_completed = true;
+                e.m_response = resp;
+                m_completed.push_back(request_id);
+
+                while(m_completed.size() > m_capacity) {
+                    m_entries.erase(m_completed.front());
+                    m_completed.pop_front();
+                }
+            }
+        }
+
+        m_cv.notify_all();
+    }
+
+    void
+    abandon(const std::string& request_id) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_entries.erase(request_id);
+        }
+        m_cv.notify_all();
+    }
+
+    std::size_t m_capacity;
+    thallium::mutex m_mutex;
+    thallium::condition_variable m_cv;
+    std::unordered_map<std::string, entry> m_entries;
+    // ids of completed entries, in completion order
+    std::deque<std::string> m_completed;
+};
+
+} // namespace scord
+
+#endif // SCORD_REQUEST_CACHE_HPP
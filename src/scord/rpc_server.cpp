@@ -24,12 +24,15 @@
 
 #include <scord/types.hpp>
 #include <net/request.hpp>
+#include <net/bulk.hpp>
 #include <net/endpoint.hpp>
 #include <net/serialization.hpp>
 #include <net/utilities.hpp>
+#include <net/tracing.hpp>
 #include <cargo/cargo.hpp>
 #include "rpc_server.hpp"
 #include <abt_cxx/shared_mutex.hpp>
+#include <functional>
 
 template <typename T, typename E>
 constexpr std::optional<T>
@@ -43,6 +46,14 @@ value_or_none(tl::expected<T, E>&& e) {
 using namespace std::literals;
 
 namespace {
+
+// Upper bound for the time that a `wait_transfer` RPC can keep its handler
+// ULT parked. Clients needing to wait longer should reissue the request.
+constexpr auto max_transfer_wait_timeout = 60s;
+
+// Same as above, for the `wait_operation` RPC
+constexpr auto max_operation_wait_timeout = 60s;
+
 cargo::dataset
 dataset_process(std::string id) {
 
@@ -74,36 +85,87 @@ dataset_process(std::string id) {
 namespace scord {
 
 rpc_server::rpc_server(std::string name, std::string address, bool daemonize,
-                       std::filesystem::path rundir, std::string redis_address)
+                       std::filesystem::path rundir, std::string redis_address,
+                       const rpc_pool_settings& pool_settings,
+                       bool shared_memory)
     : server::server(std::move(name), std::move(address), std::move(daemonize),
-                     std::move(rundir)),
+                     std::move(rundir), {}, shared_memory),
       provider::provider(m_network_engine, 0),
+      m_fast_pool("fast", pool_settings.fast_xstreams),
+      m_slow_pool("slow", pool_settings.slow_xstreams),
       m_scheduler_ess(thallium::xstream::create()),
       m_scheduler_ult(
               m_scheduler_ess->make_thread([this]() { scheduler_update(); })),
       m_redis_address(std::move(redis_address)) {
 
 
-#define EXPAND(rpc_name) "ADM_" #rpc_name##s, &rpc_server::rpc_name
-
-    provider::define(EXPAND(ping));
-    provider::define(EXPAND(query));
-    provider::define(EXPAND(register_job));
-    provider::define(EXPAND(update_job));
-    provider::define(EXPAND(remove_job));
-    provider::define(EXPAND(register_adhoc_storage));
-    provider::define(EXPAND(update_adhoc_storage));
-    provider::define(EXPAND(remove_adhoc_storage));
-    provider::define(EXPAND(deploy_adhoc_storage));
-    provider::define(EXPAND(terminate_adhoc_storage));
-    provider::define(EXPAND(register_pfs_storage));
-    provider::define(EXPAND(update_pfs_storage));
-    provider::define(EXPAND(remove_pfs_storage));
-    provider::define(EXPAND(transfer_datasets));
-    provider::define(EXPAND(query_transfer));
+#define EXPAND(rpc_name)                                                       \
+    "ADM_" #rpc_name##s, instrument("ADM_" #rpc_name##s, &rpc_server::rpc_name)
+
+    // RPCs that only access the daemon's internal state
+    provider::define(EXPAND(ping), m_fast_pool.pool());
+    provider::define(EXPAND(get_metrics), m_fast_pool.pool());
+    provider::define(EXPAND(set_log_level), m_fast_pool.pool());
+    provider::define(EXPAND(query), m_fast_pool.pool());
+    provider::define(EXPAND(update_job), m_fast_pool.pool());
+    provider::define(EXPAND(remove_job), m_fast_pool.pool());
+    provider::define(EXPAND(register_adhoc_storage), m_fast_pool.pool());
+    provider::define(EXPAND(remove_adhoc_storage), m_fast_pool.pool());
+    provider::define(EXPAND(register_pfs_storage), m_fast_pool.pool());
+    provider::define(EXPAND(update_pfs_storage), m_fast_pool.pool());
+    provider::define(EXPAND(remove_pfs_storage), m_fast_pool.pool());
+    provider::define(EXPAND(query_transfer), m_fast_pool.pool());
+    provider::define(EXPAND(query_transfers), m_fast_pool.pool());
+    provider::define(EXPAND(update_adhoc_storage_async), m_fast_pool.pool());
+    provider::define(EXPAND(deploy_adhoc_storage_async), m_fast_pool.pool());
+    provider::define(EXPAND(terminate_adhoc_storage_async),
+                     m_fast_pool.pool());
+
+    // RPCs that wait for scord-ctl, Cargo, Redis, or a transfer to complete
+    provider::define(EXPAND(register_job), m_slow_pool.pool());
+    provider::define(EXPAND(update_adhoc_storage), m_slow_pool.pool());
+    provider::define(EXPAND(deploy_adhoc_storage), m_slow_pool.pool());
+    provider::define(EXPAND(terminate_adhoc_storage), m_slow_pool.pool());
+    provider::define(EXPAND(transfer_datasets), m_slow_pool.pool());
+    provider::define(EXPAND(transfer_datasets_bulk), m_slow_pool.pool());
+    provider::define(EXPAND(wait_transfer), m_slow_pool.pool());
+    provider::define(EXPAND(wait_operation), m_slow_pool.pool());
 
 #undef EXPAND
+
+    m_metrics.add_gauge("jobs", "Registered jobs.",
+                        [this]() { return m_job_manager.size(); });
+    m_metrics.add_gauge("adhoc_storages", "Registered adhoc storage instances.",
+                        [this]() { return m_adhoc_manager.size(); });
+    m_metrics.add_gauge("pfs_storages", "Registered PFS storage instances.",
+                        [this]() { return m_pfs_manager.size(); });
+    m_metrics.add_gauge("transfers", "Transfers being tracked.",
+                        [this]() { return m_transfer_manager.size(); });
+    m_metrics.add_gauge("operations", "Background adhoc storage operations.",
+                        [this]() { return m_operation_manager.size(); });
+    m_metrics.add_gauge("scheduler_tick_seconds",
+                        "Duration of the last scheduler tick.",
+                        [this]() { return m_scheduler_tick.value(); });
+    m_metrics.add_gauge("cargo_calls_in_flight",
+                        "Outstanding calls to Cargo data stagers.",
+                        [this]() { return m_cargo_calls.value(); });
+    m_metrics.add_gauge("log_messages_queued",
+                        "Log messages waiting to be written.", []() {
+                            const auto lg = logger::get_default_logger();
+                            return lg ? lg->queued_messages() : 0;
+                        });
+    m_metrics.add_gauge("log_messages_dropped",
+                        "Log messages dropped because the log queue was "
+                        "full.",
+                        []() {
+                            const auto lg = logger::get_default_logger();
+                            return lg ? lg->dropped_messages() : 0;
+                        });
+
     m_network_engine.push_prefinalize_callback([this]() {
+        // background operations capture `this` and may still need the
+        // engine to talk to scord-ctl: wait for them before finalizing
+        m_slow_pool.join_spawned();
         m_scheduler_ult->join();
         m_scheduler_ult = thallium::managed<thallium::thread>{};
         m_scheduler_ess->join();
@@ -114,6 +176,87 @@ rpc_server::rpc_server(std::string name, std::string address, bool daemonize,
 
 #define RPC_NAME() ("ADM_"s + __FUNCTION__)
 
+void
+rpc_server::print_configuration() const {
+
+    server::print_configuration();
+
+    LOGGER_INFO("  - RPC handler pools:");
+
+    for(const auto& pool : {std::cref(m_fast_pool), std::cref(m_slow_pool)}) {
+        LOGGER_INFO("    * {}: {} execution stream(s)", pool.get().name(),
+                    pool.get().size());
+    }
+}
+
+void
+rpc_server::set_metrics_file(std::filesystem::path path,
+                             std::chrono::milliseconds interval) {
+    std::lock_guard lock(m_metrics_file_mutex);
+    m_metrics_file = std::move(path);
+    m_metrics_interval = interval;
+    m_metrics_last_write = {};
+}
+
+network::rate_limiter&
+rpc_server::rate_limits() noexcept {
+    return m_rate_limiter;
+}
+
+network::access_log::writer&
+rpc_server::access_log() noexcept {
+    return m_access_log;
+}
+
+bool
+rpc_server::admit(const network::request& req,
+                  network::metrics::rpc_metrics& metrics) {
+
+    const auto address = network::get_address(req);
+    const auto wait = m_rate_limiter.admit(metrics.name, address);
+
+    if(!wait) {
+        return true;
+    }
+
+    const auto retry_after =
+            std::chrono::ceil<std::chrono::milliseconds>(*wait);
+
+    metrics.rejected.fetch_add(1, std::memory_order_relaxed);
+
+    LOGGER_DEBUG("rpc {} from {} rejected: rate limit exceeded, retry after "
+                 "{}ms",
+                 metrics.name, address, retry_after.count());
+
+    req.respond(network::rejected_response{0, error_code::busy, retry_after});
+
+    if(m_access_log.enabled()) {
+        m_access_log.write(network::rpc_info::create(metrics.name, address),
+                           error_code::busy);
+    }
+
+    return false;
+}
+
+void
+rpc_server::write_metrics_file() {
+
+    std::lock_guard lock(m_metrics_file_mutex);
+
+    if(!m_metrics_file) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+
+    if(now - m_metrics_last_write < m_metrics_interval) {
+        return;
+    }
+
+    m_metrics.write_textfile(*m_metrics_file);
+    m_metrics_last_write = now;
+}
+
 void
 rpc_server::init_redis() {
 
@@ -135,14 +278,59 @@ rpc_server::ping(const network::request& req) {
 
     const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
 
-    LOGGER_INFO("rpc {:>} body: {{}}", rpc);
+    LOGGER_DEBUG("rpc {:>} body: {{}}", rpc);
 
     const auto resp = generic_response{rpc.id(), scord::error_code::success};
 
-    LOGGER_INFO("rpc {:<} body: {{retval: {}}}", rpc,
-                scord::error_code::success);
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}}}", rpc,
+                 scord::error_code::success);
+
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::get_metrics(const network::request& req) {
+
+    using network::get_address;
+    using network::rpc_info;
+    using response_type = network::response_with_value<std::string>;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+
+    LOGGER_DEBUG("rpc {:>} body: {{}}", rpc);
+
+    const auto resp = response_type{rpc.id(), scord::error_code::success,
+                                    m_metrics.to_prometheus()};
+
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}, metrics: {} bytes}}", rpc,
+                 resp.error_code(), resp.value().size());
+
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::set_log_level(const network::request& req,
+                          const std::string& subsystem,
+                          const std::string& level) {
+
+    using network::generic_response;
+    using network::get_address;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+
+    LOGGER_INFO("rpc {:>} body: {{subsystem: {:?}, level: {:?}}}", rpc,
+                subsystem, level);
+
+    const auto ec = logger::set_default_logger_level(subsystem, level)
+                            ? error_code::success
+                            : error_code::bad_args;
+
+    const auto resp = generic_response{rpc.id(), ec};
+
+    LOGGER_EVAL(ec, INFO, ERROR, "rpc {:<} body: {{retval: {}}}", rpc, ec);
 
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
 void
@@ -154,7 +342,7 @@ rpc_server::query(const network::request& req, slurm_job_id job_id) {
 
     const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
 
-    LOGGER_INFO("rpc {:>} body: {{slurm_job_id: {}}}", rpc, job_id);
+    LOGGER_DEBUG("rpc {:>} body: {{slurm_job_id: {}}}", rpc, job_id);
 
     const auto rv =
             m_job_manager.find_by_slurm_id(job_id)
@@ -181,31 +369,59 @@ rpc_server::query(const network::request& req, slurm_job_id job_id) {
             rv ? response_type{rpc.id(), error_code::success, rv.value()}
                : response_type{rpc.id(), rv.error()};
 
-    LOGGER_EVAL(resp.error_code(), INFO, ERROR,
+    LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
                 "rpc {:<} body: {{retval: {}, job_info: {}}}", rpc,
                 resp.error_code(), resp.value_or_none());
 
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
 void
 rpc_server::register_job(const network::request& req,
                          const scord::job::resources& job_resources,
                          const scord::job::requirements& job_requirements,
-                         scord::slurm_job_id slurm_id) {
+                         scord::slurm_job_id slurm_id,
+                         const std::string& request_id,
+                         const network::trace_context& trace) {
 
     using network::get_address;
     using network::response_with_id;
     using network::rpc_info;
 
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{job_resources: {}, job_requirements: {}, "
+                 "slurm_id: {}, request_id: {:?}}}",
+                 rpc, job_resources, job_requirements, slurm_id, request_id);
+
+    const auto [resp, replayed] =
+            m_request_cache.get_or_compute(request_id, [&]() {
+                const auto rv = register_job_helper(rpc, job_resources,
+                                                    job_requirements, slurm_id);
+                return rv ? response_with_id{rpc.id(), error_code::success,
+                                             rv.value()}
+                          : response_with_id{rpc.id(), rv.error()};
+            });
+
+    if(replayed) {
+        LOGGER_INFO("rpc id: {} replaying response to request {:?}", rpc.id(),
+                    request_id);
+    }
 
-    LOGGER_INFO("rpc {:>} body: {{job_resources: {}, job_requirements: {}, "
-                "slurm_id: {}}}",
-                rpc, job_resources, job_requirements, slurm_id);
+    LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
+                "rpc {:<} body: {{retval: {}, job_id: {}}}", rpc,
+                resp.error_code(), resp.value_or_none());
 
-    scord::error_code ec;
-    std::optional<scord::job_id> job_id;
+    respond(req, rpc, resp);
+}
+
+tl::expected<scord::job_id, error_code>
+rpc_server::register_job_helper(
+        const network::rpc_info& rpc,
+        const scord::job::resources& job_resources,
+        const scord::job::requirements& job_requirements,
+        scord::slurm_job_id slurm_id) {
 
     std::shared_ptr<internal::adhoc_storage_metadata> adhoc_metadata_ptr;
 
@@ -221,66 +437,56 @@ rpc_server::register_job(const network::request& req,
             LOGGER_ERROR(
                     "rpc id: {} error_msg: \"Error finding adhoc_storage: {}\"",
                     rpc.id(), am_result.error());
-            ec = am_result.error();
-        }
-
-        if(!ec) {
-            goto respond;
+            return tl::make_unexpected(am_result.error());
         }
     }
 
-    if(const auto jm_result = m_job_manager.create(
-               slurm_id, job_resources, job_requirements, adhoc_metadata_ptr);
-       jm_result.has_value()) {
-
-        const auto& job_metadata_ptr = jm_result.value();
-
-        // if the job requires an adhoc storage instance, inform the appropriate
-        // adhoc_storage instance (if registered)
-        if(adhoc_metadata_ptr) {
-            adhoc_metadata_ptr->add_client_info(job_metadata_ptr);
-        }
-
-        job_id = job_metadata_ptr->job().id();
-
-        if(m_redis and job_id) {
-            const auto adhoc_id = job_requirements.adhoc_storage()->id();
-            auto ec = m_adhoc_manager.find(adhoc_id);
-            const auto timestamp =
-                    std::chrono::system_clock::now().time_since_epoch().count();
-            auto name = ec->get()->adhoc_storage().name();
-            std::string type =
-                    fmt::format("{}", ec->get()->adhoc_storage().type());
-
-            std::unordered_map<std::string, std::string> m = {
-                    {"timestamp", std::to_string(timestamp)},
-                    {"job_id", std::to_string(job_id.value())},
-                    {"AdhocID", std::to_string(adhoc_id)},
-                    {"AdhocUUID", ec->get()->uuid()},
-                    {"AdhocName", name},
-                    {"Type", type},     // Lustre // Gekko
-                    {"Deployed", "No"}, // No // Yes
-                    {"StartTime", ""},
-                    {"EndTime", ""}, // Or Running
-                    {"Policies", ""} //
-
-            };
-
-            m_redis.value().hmset(std::to_string(slurm_id), m.begin(), m.end());
-        }
+    const auto jm_result = m_job_manager.create(
+            slurm_id, job_resources, job_requirements, adhoc_metadata_ptr);
 
-    } else {
+    if(!jm_result) {
         LOGGER_ERROR("rpc id: {} error_msg: \"Error creating job: {}\"",
                      rpc.id(), jm_result.error());
-        ec = jm_result.error();
+        return tl::make_unexpected(jm_result.error());
+    }
+
+    const auto& job_metadata_ptr = jm_result.value();
+
+    // if the job requires an adhoc storage instance, inform the appropriate
+    // adhoc_storage instance (if registered)
+    if(adhoc_metadata_ptr) {
+        adhoc_metadata_ptr->add_client_info(job_metadata_ptr);
     }
 
-respond:
-    const auto resp = response_with_id{rpc.id(), ec, job_id};
+    const auto job_id = job_metadata_ptr->job().id();
+
+    if(m_redis) {
+        const auto adhoc_id = job_requirements.adhoc_storage()->id();
+        auto ec = m_adhoc_manager.find(adhoc_id);
+        const auto timestamp =
+                std::chrono::system_clock::now().time_since_epoch().count();
+        auto name = ec->get()->adhoc_storage().name();
+        std::string type =
+                fmt::format("{}", ec->get()->adhoc_storage().type());
 
-    LOGGER_INFO("rpc {:<} body: {{retval: {}, job_id: {}}}", rpc, ec, job_id);
+        std::unordered_map<std::string, std::string> m = {
+                {"timestamp", std::to_string(timestamp)},
+                {"job_id", std::to_string(job_id)},
+                {"AdhocID", std::to_string(adhoc_id)},
+                {"AdhocUUID", ec->get()->uuid()},
+                {"AdhocName", name},
+                {"Type", type},     // Lustre // Gekko
+                {"Deployed", "No"}, // No // Yes
+                {"StartTime", ""},
+                {"EndTime", ""}, // Or Running
+                {"Policies", ""} //
+
+        };
+
+        m_redis.value().hmset(std::to_string(slurm_id), m.begin(), m.end());
+    }
 
-    req.respond(resp);
+    return job_id;
 }
 
 void
@@ -293,8 +499,8 @@ rpc_server::update_job(const network::request& req, scord::job_id job_id,
 
     const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
 
-    LOGGER_INFO("rpc {:>} body: {{job_id: {}, new_resources: {}}}", rpc, job_id,
-                new_resources);
+    LOGGER_DEBUG("rpc {:>} body: {{job_id: {}, new_resources: {}}}", rpc,
+                 job_id, new_resources);
 
     const auto ec = m_job_manager.update(job_id, new_resources);
 
@@ -305,9 +511,9 @@ rpc_server::update_job(const network::request& req, scord::job_id job_id,
 
     const auto resp = generic_response{rpc.id(), ec};
 
-    LOGGER_INFO("rpc {:<} body: {{retval: {}}}", rpc, ec);
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}}}", rpc, ec);
 
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
 void
@@ -319,7 +525,7 @@ rpc_server::remove_job(const network::request& req, scord::job_id job_id) {
 
     const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
 
-    LOGGER_INFO("rpc {:>} body: {{job_id: {}}}", rpc, job_id);
+    LOGGER_DEBUG("rpc {:>} body: {{job_id: {}}}", rpc, job_id);
 
     scord::error_code ec;
     const auto jm_result = m_job_manager.remove(job_id);
@@ -342,9 +548,9 @@ rpc_server::remove_job(const network::request& req, scord::job_id job_id) {
 
     const auto resp = generic_response{rpc.id(), ec};
 
-    LOGGER_INFO("rpc {:<} body: {{retval: {}}}", rpc, ec);
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}}}", rpc, ec);
 
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
 void
@@ -360,9 +566,9 @@ rpc_server::register_adhoc_storage(
 
     const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
 
-    LOGGER_INFO("rpc {:>} body: {{name: {:?}, type: {}, adhoc_ctx: {}, "
-                "adhoc_resources: {}}}",
-                rpc, name, type, ctx, resources);
+    LOGGER_DEBUG("rpc {:>} body: {{name: {:?}, type: {}, adhoc_ctx: {}, "
+                 "adhoc_resources: {}}}",
+                 rpc, name, type, ctx, resources);
 
     scord::error_code ec;
     std::optional<std::uint64_t> adhoc_id;
@@ -381,157 +587,21 @@ rpc_server::register_adhoc_storage(
 
     const auto resp = response_with_id{rpc.id(), ec, adhoc_id};
 
-    LOGGER_INFO("rpc {:<} body: {{retval: {}, adhoc_id: {}}}", rpc, ec,
-                adhoc_id);
-
-    req.respond(resp);
-}
-
-void
-rpc_server::update_adhoc_storage(
-        const network::request& req, std::uint64_t adhoc_id,
-        const scord::adhoc_storage::resources& new_resources) {
-
-    using network::generic_response;
-    using network::get_address;
-    using network::rpc_info;
-
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
-
-    LOGGER_INFO("rpc {:>} body: {{adhoc_id: {}, new_resources: {}}}", rpc,
-                adhoc_id, new_resources);
-
-
-    const auto pre_ec = m_adhoc_manager.find(adhoc_id);
-
-    if(!pre_ec) {
-        LOGGER_ERROR(
-                "rpc id: {} error_msg: \"Error updating adhoc_storage: {}\"",
-                rpc.id(), scord::error_code::no_such_entity);
-    }
-
-    const auto old_resources_size = pre_ec.value()
-                                            .get()
-                                            ->adhoc_storage()
-                                            .get_resources()
-                                            .nodes()
-                                            .size();
-
-    const auto ec = m_adhoc_manager.update(adhoc_id, new_resources);
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}, adhoc_id: {}}}", rpc, ec,
+                 adhoc_id);
 
-    if(!ec) {
-        LOGGER_ERROR(
-                "rpc id: {} error_msg: \"Error updating adhoc_storage: {}\"",
-                rpc.id(), ec);
-    }
-
-    bool expand = new_resources.nodes().size() > old_resources_size;
-
-    /**
-     * @brief Helper lambda to contact the adhoc controller and prompt it to
-     * update an adhoc storage instance
-     * @param adhoc_storage The relevant `adhoc_storage` object with
-     * information about the instance to deploy.
-     * @return
-     */
-    const auto update_helper = [&](const auto& adhoc_metadata_ptr)
-            -> tl::expected<error_code, error_code> {
-        assert(adhoc_metadata_ptr);
-        const auto adhoc_storage = adhoc_metadata_ptr->adhoc_storage();
-        const auto endp = lookup(adhoc_storage.context().controller_address());
-
-        if(!endp) {
-            LOGGER_ERROR("endpoint lookup failed");
-            return tl::make_unexpected(scord::error_code::snafu);
-        }
-
-        // const auto child_rpc =
-        //       rpc.add_child(adhoc_storage.context().controller_address());
-
-        auto name = "ADM_expand_adhoc_storage";
-        if(!expand) {
-            name = "ADM_shrink_adhoc_storage";
-        }
-
-        const auto child_rpc = rpc_info::create(
-                name, adhoc_storage.context().controller_address());
-
-        LOGGER_INFO("rpc {:<} body: {{uuid: {:?}, type: {}, resources: {}}}",
-                    child_rpc, adhoc_metadata_ptr->uuid(), adhoc_storage.type(),
-                    adhoc_storage.get_resources());
-
-        if(const auto call_rv = endp->call(
-                   child_rpc.name(), adhoc_metadata_ptr->uuid(),
-                   adhoc_storage.type(), adhoc_storage.get_resources());
-           call_rv.has_value()) {
-
-            const network::generic_response resp{call_rv.value()};
-
-            LOGGER_EVAL(resp.error_code(), INFO, ERROR,
-                        "rpc {:>} body: {{retval: {}}} [op_id: {}]", child_rpc,
-                        resp.error_code(), resp.op_id());
-
-            return resp.error_code();
-        }
-
-        LOGGER_ERROR("rpc call failed");
-        return tl::make_unexpected(error_code::snafu);
-    };
-
-    const auto rv =
-            m_adhoc_manager.find(adhoc_id)
-                    .or_else([](auto&&) {
-                        LOGGER_ERROR("adhoc storage instance not found");
-                    })
-                    .and_then(update_helper);
-
-    const auto resp = generic_response(rpc.id(), rv.value());
-
-    LOGGER_INFO("rpc {:<} body: {{retval: {}}}", rpc, rv.value());
-
-    req.respond(resp);
-}
-
-void
-rpc_server::remove_adhoc_storage(const network::request& req,
-                                 std::uint64_t adhoc_id) {
-
-    using network::generic_response;
-    using network::get_address;
-    using network::rpc_info;
-
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
-
-    LOGGER_INFO("rpc {:>} body: {{adhoc_id: {}}}", rpc, adhoc_id);
-
-    scord::error_code ec = m_adhoc_manager.remove(adhoc_id);
-
-    if(!ec) {
-        LOGGER_ERROR("rpc id: {} error_msg: \"Error removing job: {}\"",
-                     rpc.id(), adhoc_id);
-    }
-
-    const auto resp = generic_response{rpc.id(), ec};
-
-    LOGGER_INFO("rpc {:<} body: {{retval: {}}}", rpc, ec);
-
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
-void
-rpc_server::deploy_adhoc_storage(const network::request& req,
-                                 std::uint64_t adhoc_id) {
+tl::expected<std::filesystem::path, error_code>
+rpc_server::deploy_adhoc_storage_helper(const network::rpc_info& rpc,
+                                        std::uint64_t adhoc_id) {
 
-    using network::get_address;
     using network::response_with_value;
     using network::rpc_info;
 
     using response_type = response_with_value<std::filesystem::path>;
 
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
-
-    LOGGER_INFO("rpc {:>} body: {{adhoc_id: {}}}", rpc, adhoc_id);
-
     /**
      * @brief Helper lambda to contact the adhoc controller and prompt it to
      * deploy an adhoc storage instance
@@ -551,21 +621,24 @@ rpc_server::deploy_adhoc_storage(const network::request& req,
         }
 
         const auto child_rpc =
-                rpc.add_child(adhoc_storage.context().controller_address());
+                rpc.add_child("ADM_deploy_adhoc_storage"s,
+                              adhoc_storage.context().controller_address());
+        const network::tracing::span span{child_rpc};
 
-        LOGGER_INFO("rpc {:<} body: {{uuid: {:?}, type: {}, resources: {}}}",
-                    child_rpc, adhoc_metadata_ptr->uuid(), adhoc_storage.type(),
-                    adhoc_storage.get_resources());
+        LOGGER_DEBUG("rpc {:<} body: {{uuid: {:?}, type: {}, resources: {}}}",
+                     child_rpc, adhoc_metadata_ptr->uuid(),
+                     adhoc_storage.type(), adhoc_storage.get_resources());
 
         if(const auto call_rv = endp->call(
-                   rpc.name(), adhoc_metadata_ptr->uuid(), adhoc_storage.type(),
-                   adhoc_storage.get_resources());
+                   child_rpc.name(), adhoc_metadata_ptr->uuid(),
+                   adhoc_storage.type(), adhoc_storage.get_resources(),
+                   child_rpc.trace());
            call_rv.has_value()) {
 
             const response_type resp{call_rv.value()};
 
             LOGGER_EVAL(
-                    resp.error_code(), INFO, ERROR,
+                    resp.error_code(), DEBUG, ERROR,
                     "rpc {:>} body: {{retval: {}, adhoc_dir: {}}} [op_id: {}]",
                     child_rpc, resp.error_code(), resp.value_or({}),
                     resp.op_id());
@@ -577,25 +650,20 @@ rpc_server::deploy_adhoc_storage(const network::request& req,
         }
 
         LOGGER_ERROR("rpc call failed");
+        invalidate(adhoc_storage.context().controller_address());
         return tl::make_unexpected(error_code::snafu);
     };
 
     const auto rv =
             m_adhoc_manager.find(adhoc_id)
-                    .or_else([](auto&&) {
-                        LOGGER_ERROR("adhoc storage instance not found");
+                    .or_else([&](auto&&) {
+                        LOGGER_ERROR("rpc id: {} error_msg: \"adhoc storage "
+                                     "instance not found\"",
+                                     rpc.id());
                     })
                     .and_then(deploy_helper);
 
-    const response_type resp{rpc.id(),
-                             rv.has_value() ? error_code::success : rv.error(),
-                             rv.value_or(std::filesystem::path{})};
-
-    LOGGER_EVAL(resp.error_code(), INFO, ERROR,
-                "rpc {:<} body: {{retval: {}, adhoc_dir: {}}}", rpc,
-                resp.error_code(), resp.value());
-
-    if(m_redis and resp.error_code() == error_code::success) {
+    if(m_redis && rv.has_value()) {
         const auto job_id = m_adhoc_manager.find(adhoc_id)
                                     .value()
                                     .get()
@@ -614,23 +682,19 @@ rpc_server::deploy_adhoc_storage(const network::request& req,
 
         m_redis.value().hmset(std::to_string(job_id), m.begin(), m.end());
     }
-    req.respond(resp);
+
+    return rv;
 }
 
-void
-rpc_server::terminate_adhoc_storage(const network::request& req,
-                                    std::uint64_t adhoc_id) {
+error_code
+rpc_server::terminate_adhoc_storage_helper(const network::rpc_info& rpc,
+                                           std::uint64_t adhoc_id) {
 
     using network::generic_response;
-    using network::get_address;
     using network::rpc_info;
 
     using response_type = generic_response;
 
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
-
-    LOGGER_INFO("rpc {:>} body: {{adhoc_id: {}}}", rpc, adhoc_id);
-
     /**
      * @brief Helper lambda to contact the adhoc controller and prompt it to
      * terminate an adhoc storage instance
@@ -650,19 +714,21 @@ rpc_server::terminate_adhoc_storage(const network::request& req,
         }
 
         const auto child_rpc =
-                rpc.add_child(adhoc_storage.context().controller_address());
+                rpc.add_child("ADM_terminate_adhoc_storage"s,
+                              adhoc_storage.context().controller_address());
+        const network::tracing::span span{child_rpc};
 
-        LOGGER_INFO("rpc {:<} body: {{uuid: {:?}, type: {}}}", child_rpc,
-                    adhoc_metadata_ptr->uuid(), adhoc_storage.type());
+        LOGGER_DEBUG("rpc {:<} body: {{uuid: {:?}, type: {}}}", child_rpc,
+                     adhoc_metadata_ptr->uuid(), adhoc_storage.type());
 
         if(const auto call_rv =
-                   endp->call(rpc.name(), adhoc_metadata_ptr->uuid(),
-                              adhoc_storage.type());
+                   endp->call(child_rpc.name(), adhoc_metadata_ptr->uuid(),
+                              adhoc_storage.type(), child_rpc.trace());
            call_rv.has_value()) {
 
             const response_type resp{call_rv.value()};
 
-            LOGGER_EVAL(resp.error_code(), INFO, ERROR,
+            LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
                         "rpc {:>} body: {{retval: {}}} [op_id: {}]", child_rpc,
                         resp.error_code(), resp.op_id());
 
@@ -670,23 +736,22 @@ rpc_server::terminate_adhoc_storage(const network::request& req,
         }
 
         LOGGER_ERROR("rpc call failed");
+        invalidate(adhoc_storage.context().controller_address());
         return error_code::snafu;
     };
 
-    const error_code ec =
+    const auto rv =
             m_adhoc_manager.find(adhoc_id)
-                    .or_else([](auto&&) {
-                        LOGGER_ERROR("adhoc storage instance not found");
+                    .or_else([&](auto&&) {
+                        LOGGER_ERROR("rpc id: {} error_msg: \"adhoc storage "
+                                     "instance not found\"",
+                                     rpc.id());
                     })
-                    .transform(terminate_helper)
-                    .value();
-
-    const auto resp = response_type{rpc.id(), ec};
-    LOGGER_INFO("rpc {:<} body: {{retval: {}}}", rpc,
-                scord::error_code::success);
+                    .transform(terminate_helper);
 
+    const error_code ec = rv.has_value() ? rv.value() : rv.error();
 
-    if(m_redis and resp.error_code() == error_code::success) {
+    if(m_redis && ec == error_code::success) {
         const auto job_id = m_adhoc_manager.find(adhoc_id)
                                     .value()
                                     .get()
@@ -699,36 +764,360 @@ rpc_server::terminate_adhoc_storage(const network::request& req,
                 std::chrono::system_clock::now().time_since_epoch().count();
 
         std::unordered_map<std::string, std::string> m = {
-                {"Deployed", "Yes"},
-                {"EndTime", std::to_string(timestamp)}};
+                {"Deployed", "Yes"}, {"EndTime", std::to_string(timestamp)}};
         m_redis.value().hmset(std::to_string(job_id), m.begin(), m.end());
     }
 
-    req.respond(resp);
+    return ec;
 }
 
-void
-rpc_server::register_pfs_storage(const network::request& req,
-                                 const std::string& name,
-                                 enum scord::pfs_storage::type type,
-                                 const scord::pfs_storage::ctx& ctx) {
+error_code
+rpc_server::update_adhoc_storage_helper(
+        const network::rpc_info& rpc, std::uint64_t adhoc_id,
+        const scord::adhoc_storage::resources& new_resources) {
 
-    using network::get_address;
-    using network::response_with_id;
+    using network::generic_response;
     using network::rpc_info;
 
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
-
-    LOGGER_INFO("rpc {:>} body: {{name: {:?}, type: {}, pfs_ctx: {}}}", rpc,
-                name, type, ctx);
+    const auto pre_ec = m_adhoc_manager.find(adhoc_id);
 
-    scord::error_code ec;
-    std::optional<std::uint64_t> pfs_id = 0;
+    if(!pre_ec) {
+        LOGGER_ERROR(
+                "rpc id: {} error_msg: \"Error updating adhoc_storage: {}\"",
+                rpc.id(), scord::error_code::no_such_entity);
+        return scord::error_code::no_such_entity;
+    }
 
-    if(const auto pm_result = m_pfs_manager.create(type, name, ctx);
-       pm_result.has_value()) {
-        const auto& adhoc_metadata_ptr = pm_result.value();
-        pfs_id = adhoc_metadata_ptr->pfs_storage().id();
+    const auto old_resources_size = pre_ec.value()
+                                            .get()
+                                            ->adhoc_storage()
+                                            .get_resources()
+                                            .nodes()
+                                            .size();
+
+    if(const auto ec = m_adhoc_manager.update(adhoc_id, new_resources); !ec) {
+        LOGGER_ERROR(
+                "rpc id: {} error_msg: \"Error updating adhoc_storage: {}\"",
+                rpc.id(), ec);
+        return ec;
+    }
+
+    bool expand = new_resources.nodes().size() > old_resources_size;
+
+    /**
+     * @brief Helper lambda to contact the adhoc controller and prompt it to
+     * update an adhoc storage instance
+     * @param adhoc_storage The relevant `adhoc_storage` object with
+     * information about the instance to deploy.
+     * @return
+     */
+    const auto update_helper = [&](const auto& adhoc_metadata_ptr)
+            -> tl::expected<error_code, error_code> {
+        assert(adhoc_metadata_ptr);
+        const auto adhoc_storage = adhoc_metadata_ptr->adhoc_storage();
+        const auto endp = lookup(adhoc_storage.context().controller_address());
+
+        if(!endp) {
+            LOGGER_ERROR("endpoint lookup failed");
+            return tl::make_unexpected(scord::error_code::snafu);
+        }
+
+        auto name = "ADM_expand_adhoc_storage";
+        if(!expand) {
+            name = "ADM_shrink_adhoc_storage";
+        }
+
+        const auto child_rpc = rpc.add_child(
+                name, adhoc_storage.context().controller_address());
+        const network::tracing::span span{child_rpc};
+
+        LOGGER_DEBUG("rpc {:<} body: {{uuid: {:?}, type: {}, resources: {}}}",
+                     child_rpc, adhoc_metadata_ptr->uuid(),
+                     adhoc_storage.type(), adhoc_storage.get_resources());
+
+        if(const auto call_rv = endp->call(
+                   child_rpc.name(), adhoc_metadata_ptr->uuid(),
+                   adhoc_storage.type(), adhoc_storage.get_resources(),
+                   child_rpc.trace());
+           call_rv.has_value()) {
+
+            const network::generic_response resp{call_rv.value()};
+
+            LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
+                        "rpc {:>} body: {{retval: {}}} [op_id: {}]", child_rpc,
+                        resp.error_code(), resp.op_id());
+
+            return resp.error_code();
+        }
+
+        LOGGER_ERROR("rpc call failed");
+        invalidate(adhoc_storage.context().controller_address());
+        return tl::make_unexpected(error_code::snafu);
+    };
+
+    const auto rv = update_helper(pre_ec.value());
+    return rv.has_value() ? rv.value() : rv.error();
+}
+
+void
+rpc_server::update_adhoc_storage(
+        const network::request& req, std::uint64_t adhoc_id,
+        const scord::adhoc_storage::resources& new_resources,
+        const network::trace_context& trace) {
+
+    using network::generic_response;
+    using network::get_address;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{adhoc_id: {}, new_resources: {}}}", rpc,
+                 adhoc_id, new_resources);
+
+    const auto ec = update_adhoc_storage_helper(rpc, adhoc_id, new_resources);
+
+    const auto resp = generic_response(rpc.id(), ec);
+
+    LOGGER_EVAL(ec, DEBUG, ERROR, "rpc {:<} body: {{retval: {}}}", rpc, ec);
+
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::remove_adhoc_storage(const network::request& req,
+                                 std::uint64_t adhoc_id) {
+
+    using network::generic_response;
+    using network::get_address;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+
+    LOGGER_DEBUG("rpc {:>} body: {{adhoc_id: {}}}", rpc, adhoc_id);
+
+    scord::error_code ec = m_adhoc_manager.remove(adhoc_id);
+
+    if(!ec) {
+        LOGGER_ERROR("rpc id: {} error_msg: \"Error removing job: {}\"",
+                     rpc.id(), adhoc_id);
+    }
+
+    const auto resp = generic_response{rpc.id(), ec};
+
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}}}", rpc, ec);
+
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::deploy_adhoc_storage(const network::request& req,
+                                 std::uint64_t adhoc_id,
+                                 const network::trace_context& trace) {
+
+    using network::get_address;
+    using network::response_with_value;
+    using network::rpc_info;
+
+    using response_type = response_with_value<std::filesystem::path>;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{adhoc_id: {}}}", rpc, adhoc_id);
+
+    const auto rv = deploy_adhoc_storage_helper(rpc, adhoc_id);
+
+    const response_type resp{rpc.id(),
+                             rv.has_value() ? error_code::success : rv.error(),
+                             rv.value_or(std::filesystem::path{})};
+
+    LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
+                "rpc {:<} body: {{retval: {}, adhoc_dir: {}}}", rpc,
+                resp.error_code(), resp.value());
+
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::terminate_adhoc_storage(const network::request& req,
+                                    std::uint64_t adhoc_id,
+                                    const network::trace_context& trace) {
+
+    using network::generic_response;
+    using network::get_address;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{adhoc_id: {}}}", rpc, adhoc_id);
+
+    const auto ec = terminate_adhoc_storage_helper(rpc, adhoc_id);
+
+    const auto resp = generic_response{rpc.id(), ec};
+
+    LOGGER_EVAL(ec, DEBUG, ERROR, "rpc {:<} body: {{retval: {}}}", rpc, ec);
+
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::run_operation(
+        const network::request& req, const network::rpc_info& rpc,
+        std::uint64_t adhoc_id,
+        std::function<void(internal::operation_metadata&)> operation) {
+
+    using response_type = network::response_with_id;
+
+    const auto rv = m_adhoc_manager.find(adhoc_id).and_then([&](auto&&) {
+        return m_operation_manager.create(rpc.name(), adhoc_id);
+    });
+
+    if(!rv) {
+        const auto resp = response_type{rpc.id(), rv.error()};
+        LOGGER_ERROR("rpc {:<} body: {{retval: {}}}", rpc, rv.error());
+        respond(req, rpc, resp);
+        return;
+    }
+
+    // The operation runs in a background ULT on the slow pool, so that the
+    // client gets its operation id back immediately. The ULT is joined when
+    // the server shuts down (see the engine's prefinalize callback)
+    m_slow_pool.spawn([op = rv.value(), operation = std::move(operation)]() {
+        op->start();
+        operation(*op);
+    });
+
+    const auto resp =
+            response_type{rpc.id(), error_code::success, rv.value()->id()};
+
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}, operation: {}}}", rpc,
+                 resp.error_code(), rv.value()->id());
+
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::deploy_adhoc_storage_async(const network::request& req,
+                                       std::uint64_t adhoc_id,
+                                       const network::trace_context& trace) {
+
+    using network::get_address;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{adhoc_id: {}}}", rpc, adhoc_id);
+
+    run_operation(req, rpc, adhoc_id, [this, rpc, adhoc_id](auto& op) {
+        const auto rv = deploy_adhoc_storage_helper(rpc, adhoc_id);
+        op.complete(rv.has_value() ? error_code::success : rv.error(),
+                    rv.value_or(std::filesystem::path{}).string());
+    });
+}
+
+void
+rpc_server::terminate_adhoc_storage_async(const network::request& req,
+                                          std::uint64_t adhoc_id,
+                                          const network::trace_context& trace) {
+
+    using network::get_address;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{adhoc_id: {}}}", rpc, adhoc_id);
+
+    run_operation(req, rpc, adhoc_id, [this, rpc, adhoc_id](auto& op) {
+        op.complete(terminate_adhoc_storage_helper(rpc, adhoc_id));
+    });
+}
+
+void
+rpc_server::update_adhoc_storage_async(
+        const network::request& req, std::uint64_t adhoc_id,
+        const scord::adhoc_storage::resources& new_resources,
+        const network::trace_context& trace) {
+
+    using network::get_address;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{adhoc_id: {}, new_resources: {}}}", rpc,
+                 adhoc_id, new_resources);
+
+    run_operation(req, rpc, adhoc_id,
+                  [this, rpc, adhoc_id, new_resources](auto& op) {
+                      op.complete(update_adhoc_storage_helper(rpc, adhoc_id,
+                                                              new_resources));
+                  });
+}
+
+void
+rpc_server::wait_operation(const network::request& req,
+                           scord::operation_id op_id, std::uint64_t timeout_ms,
+                           const network::trace_context& trace) {
+
+    using network::get_address;
+    using network::response_with_value;
+    using network::rpc_info;
+    using response_type = response_with_value<scord::operation_info>;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{op_id: {}, timeout_ms: {}}}", rpc, op_id,
+                 timeout_ms);
+
+    const auto timeout = std::chrono::milliseconds{std::min<std::uint64_t>(
+            timeout_ms, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                max_operation_wait_timeout)
+                                .count())};
+
+    // A zero timeout returns the current progress immediately, which allows
+    // clients to poll operations cheaply
+    const auto rv = m_operation_manager.find(op_id).transform(
+            [&](auto&& operation_metadata_ptr) {
+                return operation_metadata_ptr->wait(timeout);
+            });
+
+    const auto resp =
+            rv ? response_type{rpc.id(), error_code::success, rv.value()}
+               : response_type{rpc.id(), rv.error()};
+
+    LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
+                "rpc {:<} body: {{retval: {}, op_info: {}}}", rpc,
+                resp.error_code(), resp.value_or_none());
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::register_pfs_storage(const network::request& req,
+                                 const std::string& name,
+                                 enum scord::pfs_storage::type type,
+                                 const scord::pfs_storage::ctx& ctx) {
+
+    using network::get_address;
+    using network::response_with_id;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+
+    LOGGER_DEBUG("rpc {:>} body: {{name: {:?}, type: {}, pfs_ctx: {}}}", rpc,
+                 name, type, ctx);
+
+    scord::error_code ec;
+    std::optional<std::uint64_t> pfs_id = 0;
+
+    if(const auto pm_result = m_pfs_manager.create(type, name, ctx);
+       pm_result.has_value()) {
+        const auto& adhoc_metadata_ptr = pm_result.value();
+        pfs_id = adhoc_metadata_ptr->pfs_storage().id();
     } else {
         LOGGER_ERROR("rpc id: {} error_msg: \"Error creating pfs_storage: {}\"",
                      rpc.id(), pm_result.error());
@@ -737,9 +1126,9 @@ rpc_server::register_pfs_storage(const network::request& req,
 
     const auto resp = response_with_id{rpc.id(), ec, pfs_id};
 
-    LOGGER_INFO("rpc {:<} body: {{retval: {}, pfs_id: {}}}", rpc, ec, pfs_id);
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}, pfs_id: {}}}", rpc, ec, pfs_id);
 
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
 void
@@ -753,8 +1142,8 @@ rpc_server::update_pfs_storage(const network::request& req,
 
     const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
 
-    LOGGER_INFO("rpc {:>} body: {{pfs_id: {}, new_ctx: {}}}", rpc, pfs_id,
-                new_ctx);
+    LOGGER_DEBUG("rpc {:>} body: {{pfs_id: {}, new_ctx: {}}}", rpc, pfs_id,
+                 new_ctx);
 
     const auto ec = m_pfs_manager.update(pfs_id, new_ctx);
 
@@ -765,9 +1154,9 @@ rpc_server::update_pfs_storage(const network::request& req,
 
     const auto resp = generic_response{rpc.id(), ec};
 
-    LOGGER_INFO("rpc {:<} body: {{retval: {}}}", rpc, ec);
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}}}", rpc, ec);
 
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
 void
@@ -780,7 +1169,7 @@ rpc_server::remove_pfs_storage(const network::request& req,
 
     const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
 
-    LOGGER_INFO("rpc {:>} body: {{pfs_id: {}}}", rpc, pfs_id);
+    LOGGER_DEBUG("rpc {:>} body: {{pfs_id: {}}}", rpc, pfs_id);
 
     scord::error_code ec = m_pfs_manager.remove(pfs_id);
 
@@ -791,37 +1180,24 @@ rpc_server::remove_pfs_storage(const network::request& req,
 
     const auto resp = generic_response{rpc.id(), ec};
 
-    LOGGER_INFO("rpc {:<} body: {{retval: {}}}", rpc, ec);
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}}}", rpc, ec);
 
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
-void
-rpc_server::transfer_datasets(const network::request& req, scord::job_id job_id,
-                              const std::vector<scord::dataset>& sources,
-                              const std::vector<scord::dataset>& targets,
-                              const std::vector<scord::qos::limit>& limits,
-                              enum scord::transfer::mapping mapping) {
-
-    using network::get_address;
-    using network::response_with_id;
-    using network::rpc_info;
-
-    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
-
-    LOGGER_INFO("rpc {:>} body: {{job_id: {}, sources: {}, targets: {}, "
-                "limits: {}, mapping: {}}}",
-                rpc, job_id, sources, targets, limits, mapping);
+tl::expected<scord::transfer_id, error_code>
+rpc_server::transfer_datasets_helper(
+        const network::rpc_info& rpc, scord::job_id job_id,
+        const std::vector<scord::dataset>& sources,
+        const std::vector<scord::dataset>& targets,
+        const std::vector<scord::qos::limit>& limits) {
 
     const auto jm_result = m_job_manager.find(job_id);
 
     if(!jm_result) {
         LOGGER_ERROR("rpc id: {} error_msg: \"Error finding job: {}\"",
                      rpc.id(), job_id);
-        const auto resp = response_with_id{rpc.id(), jm_result.error()};
-        LOGGER_ERROR("rpc {:<} body: {{retval: {}}}", rpc, resp.error_code());
-        req.respond(resp);
-        return;
+        return tl::make_unexpected(jm_result.error());
     }
 
     const auto& job_metadata_ptr = jm_result.value();
@@ -829,10 +1205,7 @@ rpc_server::transfer_datasets(const network::request& req, scord::job_id job_id,
     if(!job_metadata_ptr->adhoc_storage_metadata()) {
         LOGGER_ERROR("rpc id: {} error_msg: \"Job has no adhoc storage\"",
                      rpc.id(), job_id);
-        const auto resp = response_with_id{rpc.id(), error_code::no_resources};
-        LOGGER_ERROR("rpc {:<} body: {{retval: {}}}", rpc, resp.error_code());
-        req.respond(resp);
-        return;
+        return tl::make_unexpected(error_code::no_resources);
     }
 
     const auto data_stager_address =
@@ -845,6 +1218,8 @@ rpc_server::transfer_datasets(const network::request& req, scord::job_id job_id,
 
     std::vector<cargo::dataset> inputs;
     std::vector<cargo::dataset> outputs;
+    inputs.reserve(sources.size());
+    outputs.reserve(targets.size());
 
     // TODO: check type of storage tier to enable parallel transfers
     std::transform(sources.cbegin(), sources.cend(), std::back_inserter(inputs),
@@ -853,33 +1228,144 @@ rpc_server::transfer_datasets(const network::request& req, scord::job_id job_id,
     std::transform(targets.cbegin(), targets.cend(),
                    std::back_inserter(outputs),
                    [](const auto& tgt) { return ::dataset_process(tgt.id()); });
-    
-    const auto cargo_tx = cargo::transfer_datasets(srv, inputs, outputs);
+
+    const auto cargo_tx = [&]() {
+        const auto child_rpc =
+                rpc.add_child("cargo::transfer_datasets"s, data_stager_address);
+        const network::tracing::span span{child_rpc};
+        const network::metrics::scoped_increment cargo_call{m_cargo_calls};
+        return cargo::transfer_datasets(srv, inputs, outputs);
+    }();
 
     // Register the transfer into the `tranfer_manager`.
     // We embed the generated `cargo::transfer` object into
     // scord's `transfer_metadata` so that we can later query the Cargo
     // service for the transfer's status.
-    const auto rv =
-            m_transfer_manager.create(cargo_tx, limits)
-                    .or_else([&](auto&& ec) {
-                        LOGGER_ERROR("rpc id: {} error_msg: \"Error creating "
-                                     "transfer: {}\"",
-                                     rpc.id(), ec);
-                    })
-                    .and_then([&](auto&& transfer_metadata_ptr)
-                                      -> tl::expected<transfer_id, error_code> {
-                        return transfer_metadata_ptr->id();
-                    });
+    return m_transfer_manager.create(job_id, cargo_tx, limits)
+            .or_else([&](auto&& ec) {
+                LOGGER_ERROR("rpc id: {} error_msg: \"Error creating "
+                             "transfer: {}\"",
+                             rpc.id(), ec);
+            })
+            .and_then([&](auto&& transfer_metadata_ptr)
+                              -> tl::expected<transfer_id, error_code> {
+                return transfer_metadata_ptr->id();
+            });
+}
 
-    const auto resp =
-            rv ? response_with_id{rpc.id(), error_code::success, rv.value()}
-               : response_with_id{rpc.id(), rv.error()};
+void
+rpc_server::transfer_datasets(const network::request& req, scord::job_id job_id,
+                              const std::vector<scord::dataset>& sources,
+                              const std::vector<scord::dataset>& targets,
+                              const std::vector<scord::qos::limit>& limits,
+                              enum scord::transfer::mapping mapping,
+                              const std::string& request_id,
+                              const network::trace_context& trace) {
+
+    using network::get_address;
+    using network::response_with_id;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{job_id: {}, sources: {}, targets: {}, "
+                 "limits: {}, mapping: {}, request_id: {:?}}}",
+                 rpc, job_id, sources, targets, limits, mapping, request_id);
+
+    const auto [resp, replayed] =
+            m_request_cache.get_or_compute(request_id, [&]() {
+                const auto rv = transfer_datasets_helper(rpc, job_id, sources,
+                                                         targets, limits);
+                return rv ? response_with_id{rpc.id(), error_code::success,
+                                             rv.value()}
+                          : response_with_id{rpc.id(), rv.error()};
+            });
+
+    if(replayed) {
+        LOGGER_INFO("rpc id: {} replaying response to request {:?}", rpc.id(),
+                    request_id);
+    }
+
+    LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
+                "rpc {:<} body: {{retval: {}, tx_id: {}}}", rpc,
+                resp.error_code(), resp.value_or_none());
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::transfer_datasets_bulk(const network::request& req,
+                                   scord::job_id job_id,
+                                   thallium::bulk& manifest,
+                                   std::uint64_t num_sources,
+                                   const std::vector<scord::qos::limit>& limits,
+                                   enum scord::transfer::mapping mapping,
+                                   const std::string& request_id,
+                                   const network::trace_context& trace) {
+
+    using network::get_address;
+    using network::response_with_id;
+    using network::rpc_info;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req), trace);
+    const network::tracing::span span{rpc};
+
+    LOGGER_DEBUG("rpc {:>} body: {{job_id: {}, manifest: {} bytes, "
+                 "num_sources: {}, limits: {}, mapping: {}, request_id: {:?}}}",
+                 rpc, job_id, manifest.size(), num_sources, limits, mapping,
+                 request_id);
+
+    // Pull the manifest with a single bulk transfer and split it back into
+    // the source and target datasets. Replayed requests are answered
+    // without pulling the manifest again.
+    const auto pull_and_transfer =
+            [&]() -> tl::expected<scord::transfer_id, error_code> {
+        const auto buffer =
+                network::bulk::pull(m_network_engine, req, manifest);
+
+        if(!buffer) {
+            return tl::make_unexpected(error_code::other);
+        }
+
+        auto ids = network::bulk::unpack(*buffer);
+
+        if(num_sources > ids.size()) {
+            LOGGER_ERROR("rpc id: {} error_msg: \"Malformed manifest\"",
+                         rpc.id());
+            return tl::make_unexpected(error_code::bad_args);
+        }
+
+        std::vector<scord::dataset> sources;
+        std::vector<scord::dataset> targets;
+        sources.reserve(num_sources);
+        targets.reserve(ids.size() - num_sources);
 
-    LOGGER_EVAL(resp.error_code(), INFO, ERROR,
+        for(std::size_t i = 0; i < ids.size(); ++i) {
+            (i < num_sources ? sources : targets)
+                    .emplace_back(std::move(ids[i]));
+        }
+
+        return transfer_datasets_helper(rpc, job_id, sources, targets,
+                                        limits);
+    };
+
+    const auto [resp, replayed] =
+            m_request_cache.get_or_compute(request_id, [&]() {
+                const auto rv = pull_and_transfer();
+                return rv ? response_with_id{rpc.id(), error_code::success,
+                                             rv.value()}
+                          : response_with_id{rpc.id(), rv.error()};
+            });
+
+    if(replayed) {
+        LOGGER_INFO("rpc id: {} replaying response to request {:?}", rpc.id(),
+                    request_id);
+    }
+
+    LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
                 "rpc {:<} body: {{retval: {}, tx_id: {}}}", rpc,
                 resp.error_code(), resp.value_or_none());
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
 
@@ -892,8 +1378,8 @@ rpc_server::query_transfer(const network::request& req, scord::job_id job_id, sc
     using response_with_status = response_with_value<scord::transfer_state>;
     const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
 
-    LOGGER_INFO("rpc {:>} body: {{job_id: {}, tx_id{}}}",
-                rpc, job_id, tx_id);
+    LOGGER_DEBUG("rpc {:>} body: {{job_id: {}, tx_id{}}}",
+                 rpc, job_id, tx_id);
 
     const auto jm_result = m_job_manager.find(job_id);
 
@@ -902,86 +1388,196 @@ rpc_server::query_transfer(const network::request& req, scord::job_id job_id, sc
                      rpc.id(), job_id);
         const auto resp = response_with_status{rpc.id(), jm_result.error()};
         LOGGER_ERROR("rpc {:<} body: {{retval: {}}}", rpc, resp.error_code());
-        req.respond(resp);
+        respond(req, rpc, resp);
         return;
     }
 
-    const auto& job_metadata_ptr = jm_result.value();
+    // This handler runs in the fast pool, so it must not block on the data
+    // stager: the state is answered from the information cached by the
+    // scheduler instead of querying Cargo.
+    const auto rv =
+            m_transfer_manager.find(tx_id)
+                    .or_else([&](auto&& ec) {
+                        LOGGER_ERROR("rpc id: {} error_msg: \"Error finding "
+                                     "transfer: {}\"",
+                                     rpc.id(), ec);
+                    })
+                    .and_then([&](auto&& transfer_metadata_ptr)
+                                      -> tl::expected<scord::transfer_state,
+                                                      error_code> {
+                        if(transfer_metadata_ptr->job_id() != job_id) {
+                            return tl::make_unexpected(
+                                    error_code::no_such_entity);
+                        }
+                        return scord::transfer_state{
+                                transfer_metadata_ptr->state()};
+                    });
 
-    if(!job_metadata_ptr->adhoc_storage_metadata()) {
-        LOGGER_ERROR("rpc id: {} error_msg: \"Job has no adhoc storage\"",
+    const auto resp =
+            rv ? response_with_status{rpc.id(), error_code::success, rv.value()}
+               : response_with_status{rpc.id(), rv.error()};
+
+    LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
+                "rpc {:<} body: {{retval: {}, status: {}}}", rpc,
+                resp.error_code(), resp.value_or_none());
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::query_transfers(const network::request& req, scord::job_id job_id,
+                            const std::vector<scord::transfer_id>& tx_ids) {
+
+    using network::get_address;
+    using network::response_with_value;
+    using network::rpc_info;
+    using response_type =
+            response_with_value<std::vector<scord::transfer_info>>;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+
+    LOGGER_DEBUG("rpc {:>} body: {{job_id: {}, tx_ids: {}}}", rpc, job_id,
+                 tx_ids);
+
+    if(const auto jm_result = m_job_manager.find(job_id); !jm_result) {
+        LOGGER_ERROR("rpc id: {} error_msg: \"Error finding job: {}\"",
                      rpc.id(), job_id);
-        const auto resp = response_with_status{rpc.id(), error_code::no_resources};
+        const auto resp = response_type{rpc.id(), jm_result.error()};
         LOGGER_ERROR("rpc {:<} body: {{retval: {}}}", rpc, resp.error_code());
-        req.respond(resp);
+        respond(req, rpc, resp);
         return;
     }
 
-    const auto data_stager_address =
-            job_metadata_ptr->adhoc_storage_metadata()->data_stager_address();
+    // Transfer states are answered from the information cached by the
+    // scheduler, which avoids contacting the data stager once per transfer.
+    // An empty list of IDs means "all the transfers of the job".
+    std::vector<scord::transfer_info> infos;
 
-    // Transform the `scord::dataset`s into `cargo::dataset`s and contact the
-    // Cargo service associated with the job's adhoc storage instance to
-    // execute the transfers.
-    cargo::server srv{data_stager_address};
+    const auto make_info = [](const auto& transfer_metadata_ptr) {
+        return scord::transfer_info{
+                transfer_metadata_ptr->id(),
+                scord::transfer_state{transfer_metadata_ptr->state()},
+                transfer_metadata_ptr->measured_bandwidth()};
+    };
 
-    // Register the transfer into the `tranfer_manager`.
-    // We embed the generated `cargo::transfer` object into
-    // scord's `transfer_metadata` so that we can later query the Cargo
-    // service for the transfer's status.
+    if(tx_ids.empty()) {
+        for(const auto& ptr : m_transfer_manager.find_by_job(job_id)) {
+            infos.emplace_back(make_info(ptr));
+        }
+    } else {
+        const auto ptrs = m_transfer_manager.find(tx_ids);
+        infos.reserve(ptrs.size());
+
+        for(std::size_t i = 0; i < ptrs.size(); ++i) {
+            if(!ptrs[i] || ptrs[i]->job_id() != job_id) {
+                infos.emplace_back(tx_ids[i], error_code::no_such_entity);
+                continue;
+            }
+            infos.emplace_back(make_info(ptrs[i]));
+        }
+    }
+
+    const auto resp =
+            response_type{rpc.id(), error_code::success, std::move(infos)};
+
+    LOGGER_DEBUG("rpc {:<} body: {{retval: {}, tx_infos: {}}}", rpc,
+                 resp.error_code(), resp.value());
+    respond(req, rpc, resp);
+}
+
+void
+rpc_server::wait_transfer(const network::request& req, scord::job_id job_id,
+                          scord::transfer_id tx_id, std::uint64_t timeout_ms) {
+
+    using network::get_address;
+    using network::response_with_value;
+    using network::rpc_info;
+    using response_type = response_with_value<scord::transfer_state>;
+
+    const auto rpc = rpc_info::create(RPC_NAME(), get_address(req));
+
+    LOGGER_DEBUG("rpc {:>} body: {{job_id: {}, tx_id: {}, timeout_ms: {}}}",
+                 rpc, job_id, tx_id, timeout_ms);
+
+    const auto timeout = std::chrono::milliseconds{std::min<std::uint64_t>(
+            timeout_ms, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                max_transfer_wait_timeout)
+                                .count())};
+
+    // The handler ULT is parked until the scheduler reports that the
+    // transfer has reached a terminal state or the timeout expires. If the
+    // latter happens, the current (non-terminal) state is returned. Ended
+    // transfers are kept for `transfer_manager::retention`, so that waits
+    // arriving (or chained) after the transfer ended still see its outcome.
     const auto rv =
             m_transfer_manager.find(tx_id)
-                    .or_else([&](auto&& ec) {
-                        LOGGER_ERROR("rpc id: {} error_msg: \"Error finding "
-                                     "transfer: {}\"",
-                                     rpc.id(), ec);
-                    })
                     .and_then([&](auto&& transfer_metadata_ptr)
-                                      -> tl::expected<scord::transfer_state, error_code> {
-                        return scord::transfer_state(static_cast<scord::transfer_state::type>(transfer_metadata_ptr->transfer().status().state()));
+                                      -> tl::expected<scord::transfer_state,
+                                                      error_code> {
+                        if(transfer_metadata_ptr->job_id() != job_id) {
+                            return tl::make_unexpected(
+                                    error_code::no_such_entity);
+                        }
+                        return scord::transfer_state{
+                                transfer_metadata_ptr->wait(timeout)};
                     });
 
     const auto resp =
-            rv ? response_with_status{rpc.id(), error_code::success, rv.value()}
-               : response_with_status{rpc.id(), rv.error()};
-              
+            rv ? response_type{rpc.id(), error_code::success, rv.value()}
+               : response_type{rpc.id(), rv.error()};
 
-    LOGGER_EVAL(resp.error_code(), INFO, ERROR,
+    LOGGER_EVAL(resp.error_code(), DEBUG, ERROR,
                 "rpc {:<} body: {{retval: {}, status: {}}}", rpc,
                 resp.error_code(), resp.value_or_none());
-    req.respond(resp);
+    respond(req, rpc, resp);
 }
 
 /* Scheduling is done each 0.5 s*/
 void
 rpc_server::scheduler_update() {
+    constexpr auto logger_subsystem = logger::subsystem::scheduler;
+
     std::vector<std::pair<std::string, int>> return_set;
     const auto threshold = 0.1f;
     while(!m_shutting_down) {
         sleep(1);
         //thallium::thread::self().sleep(m_network_engine, 500);
+        const auto tick_start = std::chrono::steady_clock::now();
         m_transfer_manager.lock();
         const auto transfer = m_transfer_manager.transfer();
         std::vector<scord::transfer_id> v_ids;
         for(const auto& tr_unit : transfer) {
             const auto tr_info = tr_unit.second.get();
 
+            // Finished, failed and cancelled transfers are only kept so that
+            // clients can collect their outcome
+            if(tr_info->is_terminal(tr_info->state())) {
+                continue;
+            }
+
             // Contact for transfer status
-            const auto status = tr_info->transfer().status();
+            const auto status = [&]() {
+                const network::metrics::scoped_increment cargo_call{
+                        m_cargo_calls};
+                return tr_info->transfer().status();
+            }();
 
             switch(status.state()) {
                 case cargo::transfer_state::completed:
+                    tr_info->set_state(scord::transfer_state::type::finished);
                     v_ids.push_back(tr_unit.first);
                     continue;
                     break;
                 case cargo::transfer_state::failed:
+                    tr_info->set_state(scord::transfer_state::type::failed);
                     v_ids.push_back(tr_unit.first);
                     continue;
                     break;
                 case cargo::transfer_state::pending:
+                    tr_info->set_state(scord::transfer_state::type::queued);
                     continue;
                     break;
                 case cargo::transfer_state::running:
+                    tr_info->set_state(scord::transfer_state::type::running);
                     break;
             }
 
@@ -998,6 +1594,7 @@ rpc_server::scheduler_update() {
                 continue;
             }
             LOGGER_INFO("QoS Measured BW : {} vs QOS : {} ", bw, qos);
+            const network::metrics::scoped_increment cargo_call{m_cargo_calls};
             if(bw + bw * threshold > qos) {
                 // Send decrease / slow signal to cargo
                 tr_info->transfer().bw_control(+1);
@@ -1008,10 +1605,18 @@ rpc_server::scheduler_update() {
         }
         m_transfer_manager.unlock();
 
-        // Remove all failed/done transfers
-        for(const auto id : v_ids) {
-            m_transfer_manager.remove(id);
-        }
+        // Forget failed/done transfers whose outcome nobody collected
+        const auto purged = m_transfer_manager.purge();
+
+        const std::chrono::duration<double> tick =
+                std::chrono::steady_clock::now() - tick_start;
+        m_scheduler_tick.set(tick.count());
+
+        LOGGER_DEBUG("scheduler tick: {} transfer(s), {} finished, {} "
+                     "purged, took {}s",
+                     transfer.size(), v_ids.size(), purged, tick.count());
+
+        write_metrics_file();
     }
 }
 
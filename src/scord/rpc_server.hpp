@@ -25,14 +25,27 @@
 #ifndef SCORD_RPC_SERVER_HPP
 #define SCORD_RPC_SERVER_HPP
 
+#include <chrono>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #include <filesystem>
 #include <net/server.hpp>
+#include <net/access_log.hpp>
+#include <net/handler_pool.hpp>
+#include <net/request.hpp>
+#include <net/metrics.hpp>
+#include <net/rate_limiter.hpp>
+#include <net/utilities.hpp>
 #include "job_manager.hpp"
 #include "adhoc_storage_manager.hpp"
 #include "pfs_storage_manager.hpp"
 #include "transfer_manager.hpp"
+#include "operation_manager.hpp"
+#include "request_cache.hpp"
 #include <sw/redis++/redis++.h>
 
 namespace cargo {
@@ -42,19 +55,111 @@ class transfer;
 
 namespace scord {
 
+/**
+ * Number of execution streams serving each class of RPC handlers. Fast
+ * handlers only touch in-memory state, whereas slow handlers may block on
+ * remote services (e.g. scord-ctl or Cargo) for arbitrarily long periods.
+ */
+struct rpc_pool_settings {
+    std::size_t fast_xstreams;
+    std::size_t slow_xstreams;
+};
+
 class rpc_server : public network::server,
                    public network::provider<rpc_server> {
 
 public:
     rpc_server(std::string name, std::string address, bool daemonize,
-               std::filesystem::path rundir, std::string redis_address);
+               std::filesystem::path rundir, std::string redis_address,
+               const rpc_pool_settings& pool_settings,
+               bool shared_memory = true);
     void
     init_redis();
 
+    void
+    print_configuration() const final;
+
+    /**
+     * Periodically write the daemon's metrics into `path`, in the
+     * Prometheus text exposition format.
+     */
+    void
+    set_metrics_file(std::filesystem::path path,
+                     std::chrono::milliseconds interval);
+
+    /**
+     * The limits applied to incoming requests, per RPC and per client.
+     */
+    network::rate_limiter&
+    rate_limits() noexcept;
+
+    /**
+     * The log where every request served is recorded, if it is open.
+     */
+    network::access_log::writer&
+    access_log() noexcept;
+
 private:
+    static constexpr auto logger_subsystem = logger::subsystem::rpc;
+
+    /**
+     * Wrap `handler` so that each request it serves updates the metrics
+     * of RPC `name`. Requests over the configured rate limits are rejected
+     * before their arguments are deserialized, so that shedding load is as
+     * cheap as possible.
+     */
+    template <typename... Args>
+    std::function<void(const network::request&)>
+    instrument(const std::string& name,
+               void (rpc_server::*handler)(const network::request&, Args...)) {
+
+        auto& metrics = m_metrics.add_rpc(name);
+
+        return [this, &metrics, handler](const network::request& req) {
+            if(m_rate_limiter.active() && !admit(req, metrics)) {
+                return;
+            }
+
+            const network::metrics::rpc_timer timer{metrics};
+
+            if constexpr(sizeof...(Args) == 0) {
+                (this->*handler)(req);
+            } else {
+                std::tuple<std::decay_t<Args>...> args =
+                        req.get_input().as<std::decay_t<Args>...>();
+                std::apply([&](auto&... a) { (this->*handler)(req, a...); },
+                           args);
+            }
+        };
+    }
+
+    // Check `req` against the rate limits and, if it is over them, reject
+    // it with `error_code::busy` and a retry-after hint
+    bool
+    admit(const network::request& req, network::metrics::rpc_metrics& metrics);
+
+    // Send `resp` to the client and record the request in the access log
+    template <typename Response>
+    void
+    respond(const network::request& req, const network::rpc_info& rpc,
+            const Response& resp) {
+        req.respond(resp);
+        m_access_log.write(rpc, resp.error_code());
+    }
+
+    void
+    write_metrics_file();
+
     void
     ping(const network::request& req);
 
+    void
+    get_metrics(const network::request& req);
+
+    void
+    set_log_level(const network::request& req, const std::string& subsystem,
+                  const std::string& level);
+
     void
     query(const network::request& req, scord::job_id job_id);
 
@@ -62,7 +167,14 @@ private:
     register_job(const network::request& req,
                  const scord::job::resources& job_resources,
                  const scord::job::requirements& job_requirements,
-                 scord::slurm_job_id slurm_id);
+                 scord::slurm_job_id slurm_id, const std::string& request_id,
+                 const network::trace_context& trace);
+
+    tl::expected<scord::job_id, error_code>
+    register_job_helper(const network::rpc_info& rpc,
+                        const scord::job::resources& job_resources,
+                        const scord::job::requirements& job_requirements,
+                        scord::slurm_job_id slurm_id);
 
     void
     update_job(const network::request& req, scord::job_id job_id,
@@ -78,18 +190,69 @@ private:
                            const scord::adhoc_storage::resources& resources);
     void
     update_adhoc_storage(const network::request& req, std::uint64_t adhoc_id,
-                         const scord::adhoc_storage::resources& new_resources);
+                         const scord::adhoc_storage::resources& new_resources,
+                         const network::trace_context& trace);
 
     void
     remove_adhoc_storage(const network::request& req, std::uint64_t adhoc_id);
 
     void
     deploy_adhoc_storage(const network::request& adhoc_metadata_ptr,
-                         std::uint64_t adhoc_id);
+                         std::uint64_t adhoc_id,
+                         const network::trace_context& trace);
 
     void
     terminate_adhoc_storage(const network::request& adhoc_metadata_ptr,
-                            std::uint64_t adhoc_id);
+                            std::uint64_t adhoc_id,
+                            const network::trace_context& trace);
+
+    void
+    update_adhoc_storage_async(
+            const network::request& req, std::uint64_t adhoc_id,
+            const scord::adhoc_storage::resources& new_resources,
+            const network::trace_context& trace);
+
+    void
+    deploy_adhoc_storage_async(const network::request& req,
+                               std::uint64_t adhoc_id,
+                               const network::trace_context& trace);
+
+    void
+    terminate_adhoc_storage_async(const network::request& req,
+                                  std::uint64_t adhoc_id,
+                                  const network::trace_context& trace);
+
+    void
+    wait_operation(const network::request& req, scord::operation_id op_id,
+                   std::uint64_t timeout_ms,
+                   const network::trace_context& trace);
+
+    // Contact the adhoc controller to actually carry out an operation on an
+    // adhoc storage instance. These are shared by the synchronous and
+    // asynchronous versions of each RPC.
+    error_code
+    update_adhoc_storage_helper(
+            const network::rpc_info& rpc, std::uint64_t adhoc_id,
+            const scord::adhoc_storage::resources& new_resources);
+
+    tl::expected<std::filesystem::path, error_code>
+    deploy_adhoc_storage_helper(const network::rpc_info& rpc,
+                                std::uint64_t adhoc_id);
+
+    error_code
+    terminate_adhoc_storage_helper(const network::rpc_info& rpc,
+                                   std::uint64_t adhoc_id);
+
+    /**
+     * @brief Register a new operation on `adhoc_id`, respond to `req` with
+     * its id, and run `operation` in the background. Operations still
+     * running when the server shuts down are waited for before the network
+     * engine is finalized.
+     */
+    void
+    run_operation(const network::request& req, const network::rpc_info& rpc,
+                  std::uint64_t adhoc_id,
+                  std::function<void(internal::operation_metadata&)> operation);
 
     void
     register_pfs_storage(const network::request& req, const std::string& name,
@@ -108,17 +271,77 @@ private:
                       const std::vector<scord::dataset>& sources,
                       const std::vector<scord::dataset>& targets,
                       const std::vector<scord::qos::limit>& limits,
-                      enum scord::transfer::mapping mapping);
+                      enum scord::transfer::mapping mapping,
+                      const std::string& request_id,
+                      const network::trace_context& trace);
+
+    /**
+     * @brief Same as `transfer_datasets`, but the source and target datasets
+     * are packed into a manifest that is pulled from the client through
+     * `manifest`, rather than sent in the RPC itself. The first
+     * `num_sources` entries in the manifest are the sources, and the rest
+     * are the targets.
+     */
+    void
+    transfer_datasets_bulk(const network::request& req, scord::job_id job_id,
+                           thallium::bulk& manifest, std::uint64_t num_sources,
+                           const std::vector<scord::qos::limit>& limits,
+                           enum scord::transfer::mapping mapping,
+                           const std::string& request_id,
+                           const network::trace_context& trace);
+
+    tl::expected<scord::transfer_id, error_code>
+    transfer_datasets_helper(const network::rpc_info& rpc,
+                             scord::job_id job_id,
+                             const std::vector<scord::dataset>& sources,
+                             const std::vector<scord::dataset>& targets,
+                             const std::vector<scord::qos::limit>& limits);
     
     void
     query_transfer(const network::request& req, scord::job_id job_id,
                    scord::transfer_id transfer_id);
 
+    void
+    query_transfers(const network::request& req, scord::job_id job_id,
+                    const std::vector<scord::transfer_id>& transfer_ids);
+
+    void
+    wait_transfer(const network::request& req, scord::job_id job_id,
+                  scord::transfer_id transfer_id, std::uint64_t timeout_ms);
+
     job_manager m_job_manager;
     adhoc_storage_manager m_adhoc_manager;
     pfs_storage_manager m_pfs_manager;
     transfer_manager<cargo::transfer> m_transfer_manager;
-    
+    operation_manager m_operation_manager;
+
+    // Responses to requests carrying a client-supplied request id, so that
+    // retried requests are not executed twice
+    request_cache<network::response_with_id> m_request_cache;
+
+    // Admission control for incoming requests
+    network::rate_limiter m_rate_limiter;
+
+    // Fixed-size binary record of every request served
+    network::access_log::writer m_access_log;
+
+    // Per-RPC metrics and daemon gauges, exported by `get_metrics`
+    network::metrics::registry m_metrics{"scord"};
+    // Duration of the last scheduler tick and outstanding calls to Cargo
+    network::metrics::gauge m_scheduler_tick;
+    network::metrics::gauge m_cargo_calls;
+
+    // Where (and how often) the scheduler writes the metrics, if at all
+    std::mutex m_metrics_file_mutex;
+    std::optional<std::filesystem::path> m_metrics_file;
+    std::chrono::milliseconds m_metrics_interval{};
+    std::chrono::steady_clock::time_point m_metrics_last_write;
+
+    // Handler pools for RPCs that complete quickly and for those that may
+    // block waiting on other services, respectively
+    network::handler_pool m_fast_pool;
+    network::handler_pool m_slow_pool;
+
     // Dedicated execution stream for the Scheduler listener ULT
     thallium::managed<thallium::xstream> m_scheduler_ess;
     // ULT for the MPI listener
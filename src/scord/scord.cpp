@@ -28,9 +28,13 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <utility>
+#include <vector>
 #include <CLI/CLI.hpp>
 
 #include <version.hpp>
+#include <net/rate_limiter.hpp>
+#include <net/tracing.hpp>
 #include "rpc_server.hpp"
 #include "defaults.hpp"
 
@@ -106,6 +110,37 @@ public:
     }
 };
 
+// Rate limits are provided as 'RATE[/BURST]', where RATE is the number of
+// requests per second and BURST defaults to RATE
+std::optional<network::rate_limit>
+parse_rate_limit(const std::string& text) {
+
+    try {
+        const auto pos = text.find('/');
+        std::size_t end = 0;
+
+        const auto rate = std::stod(text.substr(0, pos), &end);
+
+        if(end != std::min(pos, text.size()) || !(rate > 0)) {
+            return std::nullopt;
+        }
+
+        if(pos == std::string::npos) {
+            return network::rate_limit{rate, std::max(rate, 1.0)};
+        }
+
+        const auto burst = std::stod(text.substr(pos + 1), &end);
+
+        if(end != text.size() - pos - 1 || burst < 1) {
+            return std::nullopt;
+        }
+
+        return network::rate_limit{rate, burst};
+    } catch(const std::exception&) {
+        return std::nullopt;
+    }
+}
+
 int
 main(int argc, char* argv[]) {
 
@@ -116,6 +151,29 @@ main(int argc, char* argv[]) {
         std::optional<fs::path> rundir;
         std::optional<std::string> address;
         std::optional<std::string> redis_address;
+        std::size_t fast_rpc_xstreams =
+                scord::config::defaults::fast_rpc_xstreams;
+        std::size_t slow_rpc_xstreams =
+                scord::config::defaults::slow_rpc_xstreams;
+        std::uint64_t rpc_timeout =
+                scord::config::defaults::rpc_timeout.count();
+        std::uint64_t controller_rpc_timeout =
+                scord::config::defaults::controller_rpc_timeout.count();
+        std::vector<std::string> rpc_timeouts;
+        bool shared_memory = scord::config::defaults::shared_memory;
+        std::optional<fs::path> trace_file;
+        std::vector<std::string> rate_limits;
+        std::optional<std::string> client_rate_limit;
+        std::optional<fs::path> metrics_file;
+        std::uint64_t metrics_interval =
+                scord::config::defaults::metrics_interval.count();
+        std::size_t log_queue_size = logger::async_settings{}.queue_size;
+        std::size_t log_worker_threads =
+                logger::async_settings{}.worker_threads;
+        std::string log_overflow_policy = "overrun_oldest";
+        std::optional<fs::path> access_log;
+        std::size_t access_log_records =
+                scord::config::defaults::access_log_records;
     } cli_args;
 
     const auto progname = fs::path{argv[0]}.filename().string();
@@ -169,10 +227,43 @@ main(int argc, char* argv[]) {
                 cli_args.log_type = logger::logger_type::file;
                 cli_args.output_file = fs::path{val};
             });
+    global_settings->add_option("--log_queue_size", cli_args.log_queue_size)
+            ->check(CLI::PositiveNumber);
+    global_settings->add_option("--log_worker_threads",
+                                cli_args.log_worker_threads)
+            ->check(CLI::Range(1, 1000));
+    global_settings->add_option("--log_overflow_policy",
+                                cli_args.log_overflow_policy)
+            ->check(CLI::IsMember(
+                    {"block", "overrun_oldest", "discard_new"}));
     global_settings->add_option("--rundir", cli_args.rundir);
     global_settings->add_option("--address", cli_args.address);
 
     global_settings->add_option("--redisaddress", cli_args.redis_address);
+    global_settings->add_option("--fast_rpc_xstreams",
+                                cli_args.fast_rpc_xstreams)
+            ->check(CLI::PositiveNumber);
+    global_settings->add_option("--slow_rpc_xstreams",
+                                cli_args.slow_rpc_xstreams)
+            ->check(CLI::PositiveNumber);
+    global_settings->add_option("--rpc_timeout", cli_args.rpc_timeout)
+            ->check(CLI::PositiveNumber);
+    global_settings->add_option("--controller_rpc_timeout",
+                                cli_args.controller_rpc_timeout)
+            ->check(CLI::PositiveNumber);
+    global_settings->add_option("--rpc_timeouts", cli_args.rpc_timeouts);
+    global_settings->add_option("--shared_memory", cli_args.shared_memory);
+    global_settings->add_option("--trace_file", cli_args.trace_file);
+    global_settings->add_option("--rate_limits", cli_args.rate_limits);
+    global_settings->add_option("--client_rate_limit",
+                                cli_args.client_rate_limit);
+    global_settings->add_option("--metrics_file", cli_args.metrics_file);
+    global_settings->add_option("--metrics_interval", cli_args.metrics_interval)
+            ->check(CLI::PositiveNumber);
+    global_settings->add_option("--access_log", cli_args.access_log);
+    global_settings->add_option("--access_log_records",
+                                cli_args.access_log_records)
+            ->check(CLI::PositiveNumber);
 
     CLI11_PARSE(app, argc, argv);
 
@@ -185,12 +276,140 @@ main(int argc, char* argv[]) {
         return EXIT_FAILURE;
     }
 
+    // per-RPC deadlines are provided as 'NAME=MILLISECONDS' entries
+    std::vector<std::pair<std::string, std::chrono::milliseconds>>
+            rpc_timeouts;
+
+    for(const auto& entry : cli_args.rpc_timeouts) {
+
+        const auto pos = entry.find('=');
+
+        try {
+            if(pos == std::string::npos || pos == 0) {
+                throw std::invalid_argument{entry};
+            }
+
+            std::size_t end = 0;
+            const auto value = std::stoull(entry.substr(pos + 1), &end);
+
+            if(end != entry.size() - pos - 1 || value == 0) {
+                throw std::invalid_argument{entry};
+            }
+
+            rpc_timeouts.emplace_back(entry.substr(0, pos),
+                                      std::chrono::milliseconds{value});
+        } catch(const std::exception&) {
+            fmt::print(stderr,
+                       "{}: error: invalid entry '{}' in 'rpc_timeouts', "
+                       "expected NAME=MILLISECONDS\n",
+                       progname, entry);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // per-RPC rate limits are provided as 'NAME=RATE[/BURST]' entries
+    std::vector<std::pair<std::string, network::rate_limit>> rate_limits;
+
+    for(const auto& entry : cli_args.rate_limits) {
+
+        const auto pos = entry.find('=');
+        const auto limit = pos == std::string::npos || pos == 0
+                                   ? std::nullopt
+                                   : parse_rate_limit(entry.substr(pos + 1));
+
+        if(!limit) {
+            fmt::print(stderr,
+                       "{}: error: invalid entry '{}' in 'rate_limits', "
+                       "expected NAME=RATE[/BURST]\n",
+                       progname, entry);
+            return EXIT_FAILURE;
+        }
+
+        rate_limits.emplace_back(entry.substr(0, pos), *limit);
+    }
+
+    std::optional<network::rate_limit> client_rate_limit;
+
+    if(cli_args.client_rate_limit) {
+        client_rate_limit = parse_rate_limit(*cli_args.client_rate_limit);
+
+        if(!client_rate_limit) {
+            fmt::print(stderr,
+                       "{}: error: invalid value '{}' for "
+                       "'client_rate_limit', expected RATE[/BURST]\n",
+                       progname, *cli_args.client_rate_limit);
+            return EXIT_FAILURE;
+        }
+    }
+
     try {
-        scord::rpc_server srv(progname, *cli_args.address, !cli_args.foreground,
-                              cli_args.rundir.value_or(fs::current_path()), *cli_args.redis_address);
-        srv.configure_logger(cli_args.log_type, cli_args.output_file);
+        scord::rpc_server srv(
+                progname, *cli_args.address, !cli_args.foreground,
+                cli_args.rundir.value_or(fs::current_path()),
+                *cli_args.redis_address,
+                scord::rpc_pool_settings{cli_args.fast_rpc_xstreams,
+                                         cli_args.slow_rpc_xstreams},
+                cli_args.shared_memory);
+        srv.configure_logger(
+                cli_args.log_type, cli_args.output_file,
+                logger::async_settings{
+                        cli_args.log_queue_size, cli_args.log_worker_threads,
+                        *logger::overflow_policy_from_string(
+                                cli_args.log_overflow_policy)});
+
+        auto& policies = srv.policies();
+        auto default_policy = policies.get_default();
+        default_policy.timeout =
+                std::chrono::milliseconds{cli_args.rpc_timeout};
+        policies.set_default(default_policy);
+
+        // requests to adhoc storage controllers block until the
+        // corresponding deployment scripts complete
+        for(const auto& rpc_name :
+            {"ADM_deploy_adhoc_storage", "ADM_expand_adhoc_storage",
+             "ADM_shrink_adhoc_storage", "ADM_terminate_adhoc_storage"}) {
+            policies.set_timeout(rpc_name,
+                                 std::chrono::milliseconds{
+                                         cli_args.controller_rpc_timeout});
+        }
+
+        for(const auto& [rpc_name, timeout] : rpc_timeouts) {
+            policies.set_timeout(rpc_name, timeout);
+        }
+
+        for(const auto& [rpc_name, limit] : rate_limits) {
+            srv.rate_limits().set_rpc_limit(rpc_name, limit);
+        }
+
+        if(client_rate_limit) {
+            srv.rate_limits().set_client_limit(*client_rate_limit);
+        }
+
+        if(cli_args.metrics_file) {
+            srv.set_metrics_file(
+                    *cli_args.metrics_file,
+                    std::chrono::milliseconds{cli_args.metrics_interval});
+        }
+
+        if(cli_args.access_log &&
+           !srv.access_log().open(*cli_args.access_log,
+                                  cli_args.access_log_records)) {
+            fmt::print(stderr, "{}: error: unable to open access log '{}'\n",
+                       progname, cli_args.access_log->string());
+            return EXIT_FAILURE;
+        }
+
+        if(cli_args.trace_file &&
+           !network::tracing::enable(*cli_args.trace_file)) {
+            fmt::print(stderr, "{}: error: unable to open trace file '{}'\n",
+                       progname, cli_args.trace_file->string());
+            return EXIT_FAILURE;
+        }
+
         srv.init_redis();
-        return srv.run();
+        const auto rv = srv.run();
+        network::tracing::disable();
+        return rv;
     } catch(const std::exception& ex) {
         fmt::print(stderr,
                    "{}: error: an unhandled exception reached the top "
@@ -27,8 +27,10 @@
 
 #include <scord/types.hpp>
 #include <atomic>
+#include <chrono>
 #include <utility>
 #include <unordered_map>
+#include <vector>
 #include <tl/expected.hpp>
 #include <logger/logger.hpp>
 #include <abt_cxx/shared_mutex.hpp>
@@ -39,10 +41,15 @@ namespace scord {
 template <typename TransferHandle>
 struct transfer_manager {
 
+    // How long the outcome of a finished, failed or cancelled transfer is
+    // kept around so that clients can collect it
+    static constexpr std::chrono::minutes retention{10};
+
     tl::expected<
             std::shared_ptr<scord::internal::transfer_metadata<TransferHandle>>,
             scord::error_code>
-    create(TransferHandle tx, std::vector<scord::qos::limit> limits) {
+    create(scord::job_id job_id, TransferHandle tx,
+           std::vector<scord::qos::limit> limits) {
 
         static std::atomic_uint64_t current_id;
         scord::transfer_id id = current_id++;
@@ -53,7 +60,8 @@ struct transfer_manager {
             const auto& [it_transfer, inserted] = m_transfer.emplace(
                     id, std::make_shared<
                                 internal::transfer_metadata<TransferHandle>>(
-                                id, std::move(tx), std::move(limits)));
+                                id, job_id, std::move(tx),
+                                std::move(limits)));
 
             if(!inserted) {
                 LOGGER_ERROR("{}: Emplace failed", __FUNCTION__);
@@ -98,6 +106,48 @@ struct transfer_manager {
         return tl::make_unexpected(scord::error_code::no_such_entity);
     }
 
+    /**
+     * Find several transfers at once. The returned vector is parallel to
+     * `ids`, and contains `nullptr` for transfers that could not be found.
+     */
+    std::vector<
+            std::shared_ptr<scord::internal::transfer_metadata<TransferHandle>>>
+    find(const std::vector<scord::transfer_id>& ids) {
+
+        std::vector<std::shared_ptr<
+                scord::internal::transfer_metadata<TransferHandle>>>
+                rv;
+        rv.reserve(ids.size());
+
+        abt::shared_lock lock(m_transfer_mutex);
+
+        for(const auto id : ids) {
+            const auto it = m_transfer.find(id);
+            rv.emplace_back(it != m_transfer.end() ? it->second : nullptr);
+        }
+
+        return rv;
+    }
+
+    std::vector<
+            std::shared_ptr<scord::internal::transfer_metadata<TransferHandle>>>
+    find_by_job(scord::job_id job_id) {
+
+        std::vector<std::shared_ptr<
+                scord::internal::transfer_metadata<TransferHandle>>>
+                rv;
+
+        abt::shared_lock lock(m_transfer_mutex);
+
+        for(const auto& [id, transfer_metadata_ptr] : m_transfer) {
+            if(transfer_metadata_ptr->job_id() == job_id) {
+                rv.emplace_back(transfer_metadata_ptr);
+            }
+        }
+
+        return rv;
+    }
+
     tl::expected<
             std::shared_ptr<scord::internal::transfer_metadata<TransferHandle>>,
             scord::error_code>
@@ -116,6 +166,20 @@ struct transfer_manager {
         return tl::make_unexpected(scord::error_code::no_such_entity);
     }
 
+    /**
+     * Forget the transfers whose outcome has been kept for longer than
+     * `retention`.
+     *
+     * @return The number of transfers forgotten.
+     */
+    std::size_t
+    purge() {
+        abt::unique_lock lock(m_transfer_mutex);
+        return std::erase_if(m_transfer, [](const auto& kv) {
+            return kv.second->expired(retention);
+        });
+    }
+
     std::unordered_map<
             scord::transfer_id,
             std::shared_ptr<scord::internal::transfer_metadata<TransferHandle>>>
@@ -133,6 +197,12 @@ struct transfer_manager {
         m_transfer_mutex.unlock();
     }
 
+    std::size_t
+    size() const {
+        abt::shared_lock lock(m_transfer_mutex);
+        return m_transfer.size();
+    }
+
 private:
     mutable abt::shared_mutex m_transfer_mutex;
     std::unordered_map<
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright 2021-2022, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <scord/scord.h>
+#include <net/request.hpp>
+#include <net/serialization.hpp>
+#include <thallium.hpp>
+#include <string>
+
+using namespace std::literals;
+
+SCENARIO("Requests rejected by a busy server fail with ADM_EBUSY",
+         "[lib][ADM_EBUSY]") {
+
+    GIVEN("A server that rejects every request because it is overloaded") {
+
+        thallium::engine engine{SCORD_TEST_PROTOCOL, THALLIUM_SERVER_MODE,
+                                true, 1};
+
+        const std::function<void(const thallium::request&)> reject =
+                [](const thallium::request& req) {
+                    req.respond(network::rejected_response{
+                            0, scord::error_code::busy, 0ms});
+                };
+
+        engine.define("ADM_register_job", reject);
+
+        const auto address = static_cast<std::string>(engine.self());
+        ADM_server_t server =
+                ADM_server_create(SCORD_TEST_PROTOCOL, address.c_str());
+        REQUIRE(server != nullptr);
+
+        WHEN("A client registers a job synchronously") {
+
+            ADM_node_t node = ADM_node_create("node0", ADM_NODE_REGULAR);
+            ADM_job_resources_t resources = ADM_job_resources_create(&node, 1);
+            ADM_job_requirements_t requirements = ADM_job_requirements_create(
+                    nullptr, 0, nullptr, 0, nullptr, 0, nullptr);
+            REQUIRE(resources != nullptr);
+            REQUIRE(requirements != nullptr);
+
+            ADM_job_t job = nullptr;
+            const auto rv = ADM_register_job(server, resources, requirements,
+                                             42, &job);
+
+            THEN("The call returns ADM_EBUSY instead of a job") {
+                REQUIRE(rv == ADM_EBUSY);
+                REQUIRE(job == nullptr);
+            }
+
+            ADM_job_requirements_destroy(requirements);
+            ADM_job_resources_destroy(resources);
+            ADM_node_destroy(node);
+        }
+
+        ADM_server_destroy(server);
+        engine.finalize();
+    }
+}
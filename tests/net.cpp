@@ -0,0 +1,327 @@
+/******************************************************************************
+ * Copyright 2021-2022, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <net/call_policy.hpp>
+#include <net/circuit_breaker.hpp>
+#include <net/endpoint_cache.hpp>
+#include <net/metrics.hpp>
+#include <net/procedure_cache.hpp>
+#include <net/rate_limiter.hpp>
+#include <thallium.hpp>
+#include <set>
+#include <thread>
+
+using namespace std::literals;
+
+SCENARIO("Token buckets admit bursts and refill over time",
+         "[net][rate_limiter]") {
+
+    GIVEN("A rate limiter without limits") {
+        network::rate_limiter limiter;
+
+        THEN("It is inactive and admits every request") {
+            REQUIRE_FALSE(limiter.active());
+            for(int i = 0; i < 100; ++i) {
+                REQUIRE_FALSE(limiter.admit("ADM_ping", "client").has_value());
+            }
+        }
+    }
+
+    GIVEN("A limit of 10 requests per second with bursts of 2 for an RPC") {
+        network::rate_limiter limiter;
+        limiter.set_rpc_limit("ADM_ping", {10.0, 2.0});
+
+        REQUIRE(limiter.active());
+
+        WHEN("A burst of requests arrives") {
+            REQUIRE_FALSE(limiter.admit("ADM_ping", "client").has_value());
+            REQUIRE_FALSE(limiter.admit("ADM_ping", "client").has_value());
+            const auto wait = limiter.admit("ADM_ping", "client");
+
+            THEN("Requests beyond the burst are told when to retry") {
+                REQUIRE(wait.has_value());
+                REQUIRE(*wait > 0ms);
+                REQUIRE(*wait <= 100ms);
+            }
+
+            THEN("Other RPCs are not limited") {
+                REQUIRE_FALSE(limiter.admit("ADM_query", "client").has_value());
+            }
+
+            THEN("The bucket refills at the configured rate") {
+                std::this_thread::sleep_for(110ms);
+                REQUIRE_FALSE(limiter.admit("ADM_ping", "client").has_value());
+                REQUIRE(limiter.admit("ADM_ping", "client").has_value());
+            }
+        }
+    }
+
+    GIVEN("A per-client limit of 1 request per second") {
+        network::rate_limiter limiter;
+        limiter.set_client_limit({1.0, 1.0});
+
+        THEN("Each client has its own bucket") {
+            REQUIRE_FALSE(limiter.admit("ADM_ping", "client1").has_value());
+            REQUIRE(limiter.admit("ADM_ping", "client1").has_value());
+            REQUIRE(limiter.admit("ADM_query", "client1").has_value());
+            REQUIRE_FALSE(limiter.admit("ADM_ping", "client2").has_value());
+        }
+    }
+}
+
+SCENARIO("Circuit breakers open after repeated failures",
+         "[net][circuit_breaker]") {
+
+    GIVEN("A breaker that opens after 2 failures for 50ms") {
+        network::circuit_breaker breaker{2, 50ms};
+        const std::string address = "ofi+tcp://node001:52000";
+
+        THEN("Unknown addresses are allowed") {
+            REQUIRE(breaker.allow(address));
+        }
+
+        WHEN("Calls fail fewer times than the threshold") {
+            breaker.record_failure(address);
+
+            THEN("The circuit stays closed") {
+                REQUIRE(breaker.allow(address));
+                REQUIRE(breaker.allow(address));
+            }
+        }
+
+        WHEN("Calls fail as many times as the threshold") {
+            breaker.record_failure(address);
+            breaker.record_failure(address);
+
+            THEN("The circuit opens only for that address") {
+                REQUIRE_FALSE(breaker.allow(address));
+                REQUIRE(breaker.allow("ofi+tcp://node002:52000"));
+            }
+
+            AND_WHEN("The cooldown expires") {
+                std::this_thread::sleep_for(60ms);
+
+                THEN("A single trial call is let through") {
+                    REQUIRE(breaker.allow(address));
+                    REQUIRE_FALSE(breaker.allow(address));
+                }
+
+                THEN("A successful trial closes the circuit") {
+                    REQUIRE(breaker.allow(address));
+                    breaker.record_success(address);
+                    REQUIRE(breaker.allow(address));
+                    REQUIRE(breaker.allow(address));
+                }
+
+                THEN("A failed trial opens it for another cooldown") {
+                    REQUIRE(breaker.allow(address));
+                    breaker.record_failure(address);
+                    REQUIRE_FALSE(breaker.allow(address));
+                    std::this_thread::sleep_for(60ms);
+                    REQUIRE(breaker.allow(address));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Retry backoffs are jittered within exponential bounds",
+         "[net][call_policy]") {
+
+    GIVEN("A policy with a 100ms base and a 1s maximum") {
+        network::call_policy policy;
+        policy.backoff_base = 100ms;
+        policy.backoff_max = 1000ms;
+
+        THEN("Each delay is within [0, min(max, base * 2^(attempt-1))]") {
+            for(std::uint32_t attempt = 1; attempt <= 64; ++attempt) {
+                const auto factor = 1u << std::min(attempt - 1, 16u);
+                const auto ceiling = std::min(policy.backoff_max,
+                                              policy.backoff_base * factor);
+
+                for(int i = 0; i < 100; ++i) {
+                    const auto delay = policy.backoff(attempt);
+                    REQUIRE(delay >= 0ms);
+                    REQUIRE(delay <= ceiling);
+                }
+            }
+        }
+
+        THEN("Delays are randomized") {
+            std::set<std::chrono::milliseconds::rep> delays;
+            for(int i = 0; i < 100; ++i) {
+                delays.insert(policy.backoff(4).count());
+            }
+            REQUIRE(delays.size() > 1);
+        }
+    }
+
+    GIVEN("A policy without backoff") {
+        network::call_policy policy;
+        policy.backoff_base = 0ms;
+
+        THEN("Retries are not delayed") {
+            REQUIRE(policy.backoff(1) == 0ms);
+            REQUIRE(policy.backoff(10) == 0ms);
+        }
+    }
+}
+
+SCENARIO("Latency histograms bound the error of recorded values",
+         "[net][metrics]") {
+
+    using network::metrics::histogram;
+
+    GIVEN("Any value") {
+        THEN("It falls in a bucket whose bounds contain it") {
+            for(std::uint64_t v = 0; v < (1u << 14); ++v) {
+                const auto i = histogram::bucket_index(v);
+                REQUIRE(i < histogram::num_buckets);
+                REQUIRE(v < histogram::bucket_upper_bound(i));
+                if(i > 0) {
+                    REQUIRE(v >= histogram::bucket_upper_bound(i - 1));
+                }
+            }
+        }
+
+        THEN("Buckets are at most 1/sub_buckets of their values wide") {
+            for(std::size_t i = 1; i < histogram::num_buckets; ++i) {
+                const auto lower = histogram::bucket_upper_bound(i - 1);
+                const auto upper = histogram::bucket_upper_bound(i);
+                REQUIRE(upper > lower);
+                REQUIRE(upper - lower <=
+                        std::max<std::uint64_t>(
+                                1, lower / histogram::sub_buckets));
+            }
+        }
+
+        THEN("Values that are too large go into the last bucket") {
+            REQUIRE(histogram::bucket_index(std::uint64_t{1}
+                                            << histogram::max_exponent) ==
+                    histogram::num_buckets - 1);
+            REQUIRE(histogram::bucket_index(~std::uint64_t{0}) ==
+                    histogram::num_buckets - 1);
+        }
+    }
+
+    GIVEN("An empty histogram") {
+        histogram h;
+
+        THEN("Its quantiles are zero") {
+            REQUIRE(h.count() == 0);
+            REQUIRE(h.quantile(0.5) == 0);
+        }
+    }
+
+    GIVEN("A histogram with the values 1 to 1000") {
+        histogram h;
+
+        for(std::uint64_t v = 1; v <= 1000; ++v) {
+            h.record(v);
+        }
+
+        THEN("Counts and sums are exact") {
+            REQUIRE(h.count() == 1000);
+            REQUIRE(h.sum() == 500'500);
+            REQUIRE(h.count_below(512) == 511);
+            REQUIRE(h.count_below(1024) == 1000);
+        }
+
+        THEN("Quantiles are within the error of their bucket") {
+            constexpr auto max_error = 1.0 / histogram::sub_buckets;
+            for(const auto& [q, expected] :
+                {std::pair{0.5, 500.0}, {0.9, 900.0}, {0.99, 990.0}}) {
+                const auto value = static_cast<double>(h.quantile(q));
+                REQUIRE(value >= expected);
+                REQUIRE(value <= expected * (1.0 + max_error));
+            }
+            REQUIRE(h.quantile(0.0) == 1);
+            REQUIRE(h.quantile(1.0) >= 1000);
+        }
+    }
+}
+
+SCENARIO("Endpoints are cached", "[net][cache]") {
+
+    GIVEN("A network engine") {
+
+        thallium::engine engine{SCORD_TEST_PROTOCOL, THALLIUM_SERVER_MODE};
+
+        WHEN("An endpoint is cached") {
+            const auto self = engine.self();
+            const auto address = static_cast<std::string>(self);
+
+            network::endpoint_cache cache;
+            cache.insert(address, self);
+
+            THEN("It is found until it is invalidated") {
+                const auto endp = cache.find(address);
+                REQUIRE(endp.has_value());
+                REQUIRE(static_cast<std::string>(*endp) == address);
+                REQUIRE_FALSE(cache.find("ofi+tcp://unknown").has_value());
+
+                cache.invalidate(address);
+                REQUIRE_FALSE(cache.find(address).has_value());
+            }
+        }
+
+        WHEN("An endpoint is cached with a short TTL") {
+            const auto self = engine.self();
+            const auto address = static_cast<std::string>(self);
+
+            network::endpoint_cache cache{10ms};
+            cache.insert(address, self);
+            std::this_thread::sleep_for(20ms);
+
+            THEN("It expires") {
+                REQUIRE_FALSE(cache.find(address).has_value());
+            }
+        }
+
+        engine.finalize();
+    }
+}
+
+SCENARIO("Procedures are defined once per engine", "[net][cache]") {
+
+    GIVEN("A network engine") {
+
+        thallium::engine engine{SCORD_TEST_PROTOCOL, THALLIUM_SERVER_MODE};
+
+        WHEN("A procedure is requested twice") {
+            network::procedure_cache cache{engine};
+            const auto& first = cache.get("ADM_ping");
+            const auto& second = cache.get("ADM_ping");
+            const auto& other = cache.get("ADM_query");
+
+            THEN("It is only defined once") {
+                REQUIRE(&first == &second);
+                REQUIRE(&first != &other);
+            }
+        }
+
+        engine.finalize();
+    }
+}
@@ -0,0 +1,130 @@
+/******************************************************************************
+ * Copyright 2021-2022, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <scord/types.hpp>
+#include <thallium.hpp>
+#include <request_cache.hpp>
+
+namespace {
+
+struct response {
+
+    scord::error_code
+    error_code() const {
+        return m_error_code;
+    }
+
+    int m_value = 0;
+    scord::error_code m_error_code = scord::error_code::success;
+};
+
+} // namespace
+
+SCENARIO("Replayed requests are answered from the request cache",
+         "[scord][request_cache]") {
+
+    GIVEN("A request cache with room for 2 responses") {
+
+        // the cache relies on Argobots synchronization primitives
+        thallium::engine engine{SCORD_TEST_PROTOCOL, THALLIUM_CLIENT_MODE};
+
+        {
+            scord::request_cache<response> cache{2};
+            int calls = 0;
+
+            const auto compute = [&](scord::error_code ec =
+                                             scord::error_code::success) {
+                return [&calls, ec]() {
+                    return response{++calls, ec};
+                };
+            };
+
+            WHEN("A request is replayed") {
+                const auto [first, first_replayed] =
+                        cache.get_or_compute("req-1", compute());
+                const auto [second, second_replayed] =
+                        cache.get_or_compute("req-1", compute());
+
+                THEN("The original response is returned") {
+                    REQUIRE_FALSE(first_replayed);
+                    REQUIRE(second_replayed);
+                    REQUIRE(second.m_value == first.m_value);
+                    REQUIRE(calls == 1);
+                }
+            }
+
+            WHEN("Requests have no id") {
+                cache.get_or_compute("", compute());
+                const auto [resp, replayed] =
+                        cache.get_or_compute("", compute());
+
+                THEN("They are never deduplicated") {
+                    REQUIRE_FALSE(replayed);
+                    REQUIRE(calls == 2);
+                }
+            }
+
+            WHEN("A request fails") {
+                cache.get_or_compute("req-1",
+                                     compute(scord::error_code::other));
+                const auto [resp, replayed] =
+                        cache.get_or_compute("req-1", compute());
+
+                THEN("Its retry is executed again") {
+                    REQUIRE_FALSE(replayed);
+                    REQUIRE(resp.m_value == 2);
+                }
+            }
+
+            WHEN("More responses than the capacity are stored") {
+                cache.get_or_compute("req-1", compute());
+                cache.get_or_compute("req-2", compute());
+                cache.get_or_compute("req-3", compute());
+
+                THEN("The oldest response is evicted") {
+                    REQUIRE(cache.get_or_compute("req-3", compute()).second);
+                    REQUIRE(cache.get_or_compute("req-2", compute()).second);
+                    REQUIRE_FALSE(
+                            cache.get_or_compute("req-1", compute()).second);
+                    REQUIRE(calls == 4);
+                }
+            }
+
+            WHEN("Computing a response throws") {
+                REQUIRE_THROWS(cache.get_or_compute(
+                        "req-1", []() -> response { throw 42; }));
+
+                THEN("The request can be retried") {
+                    const auto [resp, replayed] =
+                            cache.get_or_compute("req-1", compute());
+                    REQUIRE_FALSE(replayed);
+                    REQUIRE(calls == 1);
+                }
+            }
+        }
+
+        engine.finalize();
+    }
+}
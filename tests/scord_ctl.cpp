@@ -0,0 +1,267 @@
+/******************************************************************************
+ * Copyright 2021-2022, Barcelona Supercomputing Center (BSC), Spain
+ *
+ * This software was partially supported by the EuroHPC-funded project ADMIRE
+ *   (Project ID: 956748, https://www.admire-eurohpc.eu).
+ *
+ * This file is part of scord.
+ *
+ * scord is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * scord is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with scord.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <command.hpp>
+#include <fanout.hpp>
+
+SCENARIO("Peer addresses are derived from the listen address",
+         "[scord-ctl][peer_address]") {
+
+    using scord_ctl::peer_address;
+
+    GIVEN("A listen address with a protocol, a host and a port") {
+        THEN("The host is replaced by the peer's hostname") {
+            REQUIRE(peer_address("ofi+tcp://0.0.0.0:52000", "node002") ==
+                    "ofi+tcp://node002:52000");
+            REQUIRE(peer_address("ofi+tcp://10.0.0.1:52000", "node002") ==
+                    "ofi+tcp://node002:52000");
+        }
+    }
+
+    GIVEN("A listen address without a port") {
+        THEN("The peer address has no port either") {
+            REQUIRE(peer_address("ofi+tcp://10.0.0.1", "node002") ==
+                    "ofi+tcp://node002");
+        }
+    }
+
+    GIVEN("A listen address with just a protocol") {
+        THEN("The peer address is made of the protocol and the hostname") {
+            REQUIRE(peer_address("ofi+tcp", "node002") == "ofi+tcp://node002");
+        }
+    }
+
+    GIVEN("An address resolved by Mercury") {
+        THEN("The provider stack is dropped from the protocol") {
+            REQUIRE(peer_address("ofi+tcp;ofi_rxm://10.0.0.1:52000",
+                                 "node002") == "ofi+tcp://node002:52000");
+        }
+
+        THEN("Only the last part of a composite address is used") {
+            REQUIRE(peer_address("na+sm://12345-0#ofi+tcp;ofi_rxm://"
+                                 "10.0.0.1:52000",
+                                 "node002") == "ofi+tcp://node002:52000");
+        }
+    }
+}
+
+SCENARIO("Nodes are split into subtrees for fan-out",
+         "[scord-ctl][split_subtrees]") {
+
+    using scord_ctl::split_subtrees;
+
+    GIVEN("An empty range or a zero degree") {
+        THEN("There are no subtrees") {
+            REQUIRE(split_subtrees(3, 3, 8).empty());
+            REQUIRE(split_subtrees(0, 10, 0).empty());
+        }
+    }
+
+    GIVEN("Fewer nodes than the degree") {
+        THEN("Each node is its own subtree") {
+            using range = std::pair<std::uint32_t, std::uint32_t>;
+            const auto subtrees = split_subtrees(1, 4, 8);
+            REQUIRE(subtrees.size() == 3);
+            REQUIRE(subtrees[0] == range{1, 2});
+            REQUIRE(subtrees[1] == range{2, 3});
+            REQUIRE(subtrees[2] == range{3, 4});
+        }
+    }
+
+    GIVEN("More nodes than the degree") {
+        THEN("Every node belongs to exactly one subtree of similar size") {
+            const std::uint32_t first = 1;
+            const std::uint32_t last = 4096;
+            const auto subtrees = split_subtrees(first, last, 8);
+
+            REQUIRE(subtrees.size() == 8);
+            REQUIRE(subtrees.front().first == first);
+            REQUIRE(subtrees.back().second == last);
+
+            for(std::size_t i = 0; i < subtrees.size(); ++i) {
+                const auto [begin, end] = subtrees[i];
+                REQUIRE(end - begin >= (last - first) / 8);
+                REQUIRE(end - begin <= (last - first) / 8 + 1);
+                if(i > 0) {
+                    REQUIRE(subtrees[i - 1].second == begin);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Keywords in expanded values are not expanded again",
+         "[scord-ctl][command]") {
+
+    using scord_ctl::command;
+
+    const std::vector<std::string> nodes{"node001"};
+
+    GIVEN("A template that leaves {ADHOC_DIRECTORY} for later") {
+        const command cmd{"start --id {ADHOC_ID} --dir {ADHOC_DIRECTORY}"};
+
+        WHEN("The adhoc id contains the spelling of a keyword") {
+            const auto partial = cmd.eval("{ADHOC_DIRECTORY}", nodes);
+
+            THEN("Only the keyword of the template is expanded later") {
+                REQUIRE(partial.cmdline() ==
+                        "start --id {ADHOC_DIRECTORY} --dir "
+                        "{ADHOC_DIRECTORY}");
+
+                const auto full = partial.eval("unused", "/tmp/adhoc", nodes);
+                REQUIRE(full.cmdline() ==
+                        "start --id {ADHOC_DIRECTORY} --dir /tmp/adhoc");
+            }
+        }
+    }
+
+    GIVEN("A fully expanded template") {
+        const command cmd{"start {ADHOC_ID}"};
+        const auto expanded = cmd.eval("{ADHOC_NODES}", "/tmp/adhoc", nodes);
+
+        THEN("Evaluating it again leaves it unchanged") {
+            REQUIRE(expanded.cmdline() == "start {ADHOC_NODES}");
+            REQUIRE(expanded.eval("other", "/tmp/other", nodes).cmdline() ==
+                    "start {ADHOC_NODES}");
+        }
+    }
+}
+
+SCENARIO("Command templates are expanded", "[scord-ctl][command]") {
+
+    using scord_ctl::command;
+
+    const std::vector<std::string> nodes{"node001", "node002", "node003"};
+
+    GIVEN("A template using every keyword") {
+        const command cmd{"start {ADHOC_ID} {ADHOC_DIRECTORY} {ADHOC_NODES}"};
+
+        THEN("All of them are replaced") {
+            REQUIRE(cmd.eval("42", "/tmp/adhoc", nodes).cmdline() ==
+                    "start 42 /tmp/adhoc \"node001,node002,node003\"");
+        }
+
+        THEN("Keywords without a value are left unexpanded") {
+            REQUIRE(cmd.eval("42", nodes).cmdline() ==
+                    "start 42 {ADHOC_DIRECTORY} \"node001,node002,node003\"");
+        }
+
+        THEN("The template itself is not modified") {
+            REQUIRE(cmd.cmdline() ==
+                    "start {ADHOC_ID} {ADHOC_DIRECTORY} {ADHOC_NODES}");
+        }
+    }
+
+    GIVEN("A template with adjacent and repeated keywords") {
+        const command cmd{"{ADHOC_ID}{ADHOC_ID}/{ADHOC_DIRECTORY}"};
+
+        THEN("Each occurrence is replaced") {
+            REQUIRE(cmd.eval("x", "dir", nodes).cmdline() == "xx/dir");
+        }
+    }
+
+    GIVEN("A template with unknown or incomplete keywords") {
+        const command cmd{"echo {ADHOC} {ADHOC_ID {UNKNOWN} {ADHOC_ID}"};
+
+        THEN("Only known keywords are replaced") {
+            REQUIRE(cmd.eval("42", "dir", nodes).cmdline() ==
+                    "echo {ADHOC} {ADHOC_ID {UNKNOWN} 42");
+        }
+    }
+
+    GIVEN("An evaluated template") {
+        const command cmd{"run --id {ADHOC_ID}  --x"};
+
+        THEN("Its command line is split on spaces") {
+            REQUIRE(cmd.eval("42", "dir", nodes).as_vector() ==
+                    std::vector<std::string>{"run", "--id", "42", "", "--x"});
+        }
+    }
+}
+SCENARIO("Node lists are compressed into hostlist expressions",
+         "[scord-ctl][command]") {
+
+    using scord_ctl::command;
+
+    const command cmd{"{ADHOC_NODES_RANGED}"};
+
+    const auto ranged = [&](const std::vector<std::string>& nodes) {
+        return cmd.eval("id", "dir", nodes).cmdline();
+    };
+
+    GIVEN("A template using the node file and ranged node list keywords") {
+        const command tmpl{"start -H {ADHOC_NODES_FILE} {ADHOC_NODES_RANGED}"};
+        const std::vector<std::string> nodes{"node001", "node002", "node003"};
+
+        THEN("Both are replaced") {
+            REQUIRE(tmpl.eval("42", "dir", nodes, "/tmp/adhoc/hosts")
+                            .cmdline() ==
+                    "start -H /tmp/adhoc/hosts node[001-003]");
+        }
+
+        THEN("The node file is left unexpanded if none is given") {
+            REQUIRE(tmpl.eval("42", "dir", nodes).cmdline() ==
+                    "start -H {ADHOC_NODES_FILE} node[001-003]");
+        }
+    }
+
+    GIVEN("Consecutive and non-consecutive node ids") {
+        THEN("Consecutive ids are collapsed into ranges") {
+            REQUIRE(ranged({"node001", "node002", "node003", "node010"}) ==
+                    "node[001-003,010]");
+        }
+
+        THEN("Ids are sorted and deduplicated") {
+            REQUIRE(ranged({"node003", "node001", "node002", "node001"}) ==
+                    "node[001-003]");
+        }
+    }
+
+    GIVEN("A single node") {
+        THEN("No brackets are used") {
+            REQUIRE(ranged({"node007"}) == "node007");
+        }
+    }
+
+    GIVEN("Nodes with different prefixes or suffix widths") {
+        THEN("They are grouped separately in order of first appearance") {
+            REQUIRE(ranged({"gpu01", "node001", "gpu02", "node1"}) ==
+                    "gpu[01-02],node001,node1");
+        }
+    }
+
+    GIVEN("Nodes without a numeric suffix") {
+        THEN("They are kept as they are") {
+            REQUIRE(ranged({"login", "node01", "login"}) == "login,node01");
+        }
+    }
+
+    GIVEN("Nodes with suffixes too long for a number") {
+        THEN("They are kept as they are") {
+            REQUIRE(ranged({"n1234567890123456789"}) ==
+                    "n1234567890123456789");
+        }
+    }
+}
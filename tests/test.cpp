@@ -50,15 +50,26 @@ SCENARIO("Error messages can be printed", "[lib][ADM_strerror]") {
             REQUIRE(std::string{ADM_strerror(ADM_ETIMEOUT)} ==
                     "Timeout");
         }
+
         WHEN("The error number is ADM_EOTHER") {
             REQUIRE(std::string{ADM_strerror(ADM_EOTHER)} ==
                     "Undetermined error");
         }
 
-        WHEN("The error number is larger than ADM_EOTHER and "
+        WHEN("The error number is ADM_EBUSY") {
+            REQUIRE(std::string{ADM_strerror(ADM_EBUSY)} ==
+                    "Server busy, try again later");
+        }
+
+        WHEN("The values of existing error numbers are checked") {
+            REQUIRE(ADM_ETIMEOUT == 12);
+            REQUIRE(ADM_EOTHER == 13);
+        }
+
+        WHEN("The error number is larger than the last error number and "
              "lower than ADM_ERR_MAX") {
 
-            for(int i = ADM_EOTHER; i < ADM_ERR_MAX; ++i) {
+            for(int i = ADM_EBUSY + 1; i < ADM_ERR_MAX; ++i) {
                 const auto e = static_cast<ADM_return_t>(i);
                 REQUIRE(std::string{ADM_strerror(e)} == "Undetermined error");
             }